@@ -186,6 +186,13 @@ void setup() {
   ConfigManager.checkSettingsForErrors();
   ConfigManager.loadAll();
 
+  const auto ramReport = ConfigManager.getSettingsRamReport();
+  Serial.printf("[INFO] Settings RAM: %u settings (%u flash descriptors), %u object + %u heap bytes\n",
+                static_cast<unsigned>(ramReport.settings),
+                static_cast<unsigned>(ramReport.flashDescriptors),
+                static_cast<unsigned>(ramReport.objectBytes),
+                static_cast<unsigned>(ramReport.heapBytes));
+
   setupNetworkDefaults();
   setupGUI();
 
@@ -15,10 +15,16 @@
 #include <exception>
 #include <stdexcept>
 #include <algorithm>
+#include <cerrno>
+#include <climits>
 #include <cstdlib>
 #include <cstdint>
+#include <cstring>
+#include <strings.h>
 #include <set>
 #include <map>
+#include <atomic>
+#include <mutex>
 #include <utility>
 
 #include "ConfigManagerConfig.h"
@@ -34,8 +40,13 @@
 #include "wifi/WiFiManager.h"
 #endif
 #include "web/WebServer.h"
+#include "web/ConfigJsonStream.h"
+#include "web/RuntimeCommandQueue.h"
+#include "storage/SettingsBlob.h"
 #include "ota/OTAManager.h"
 #include "runtime/RuntimeManager.h"
+#include "runtime/LoopProfiler.h"
+#include "runtime/SpscMailbox.h"
 
 #if CM_EMBED_WEBUI
 #include "html_content.h" // Generated: provides WEB_HTML_GZ and accessors
@@ -49,6 +60,9 @@ public:
   size_t getWebHTMLGzLen() {
     return 0;
   }
+  const char* getWebHTMLGzHash() {
+    return "";
+  }
 };
 #endif
 
@@ -57,6 +71,8 @@ public:
 static constexpr uint32_t CM_WS_PUSH_INTERVAL_DEFAULT_MS = 5000;
 static constexpr uint32_t CM_WS_PUSH_INTERVAL_MIN_MS = 550;
 static constexpr uint32_t CM_WS_PUSH_INTERVAL_MAX_MS = 60000;
+static constexpr uint32_t CM_WS_KEYFRAME_INTERVAL_DEFAULT_MS = 30000;
+static constexpr uint32_t CM_WS_STATS_WINDOW_MS = 10000;
 
 #if CM_ENABLE_THEMING && CM_ENABLE_STYLE_RULES
 inline constexpr char CM_DEFAULT_RUNTIME_STYLE_CSS[] PROGMEM = R"CSS(
@@ -89,6 +105,9 @@ struct ConfigOptions {
   const char* card = nullptr;       // Optional card key within the category
   const char* cardPretty = nullptr; // Optional pretty name for the card
   int cardOrder = 100;              // Optional sort order for the card
+
+  // Last, so positional and designated initializers written before it keep working.
+  const char* storageKey = nullptr; // Optional CM_STORAGE_KEY(key): precomputed at compile time, skips runtime hashing
 };
 
 // Server abstraction
@@ -206,8 +225,10 @@ inline String generateKeyFromNameAndCategory(const char* name, const char* categ
   return result;
 }
 
-inline uint64_t fnv1aHash64(const char* data, size_t len) {
-  uint64_t hash = 1469598103934665603ull;
+static constexpr uint64_t CM_FNV1A_64_OFFSET = 1469598103934665603ull;
+
+// Pass a previous result as seed to hash several fragments as one stream.
+inline constexpr uint64_t fnv1aHash64(const char* data, size_t len, uint64_t hash = CM_FNV1A_64_OFFSET) {
   for (size_t i = 0; i < len; ++i) {
     hash ^= static_cast<uint64_t>(static_cast<unsigned char>(data[i]));
     hash *= 1099511628211ull;
@@ -215,15 +236,136 @@ inline uint64_t fnv1aHash64(const char* data, size_t len) {
   return hash;
 }
 
+static constexpr size_t CM_PREFS_MAX_KEY_LEN = 15;       // NVS key limit (without terminator)
+static constexpr size_t CM_STORAGE_KEY_HEX_DIGITS = 12;  // Low 48 bits of the FNV-1a hash
+static constexpr size_t CM_STORAGE_KEY_BUFFER_SIZE = 16;
+static_assert(CM_STORAGE_KEY_HEX_DIGITS <= CM_PREFS_MAX_KEY_LEN, "Hashed storage keys must fit the NVS key limit");
+static_assert(CM_STORAGE_KEY_HEX_DIGITS < CM_STORAGE_KEY_BUFFER_SIZE, "Storage key buffer too small");
+
+// Writes the hashed storage key (upper-case hex, NUL-terminated) for a hash value.
+inline constexpr void writeStorageKey(uint64_t hashValue, char* out) {
+  constexpr char digits[] = "0123456789ABCDEF";
+  for (size_t i = 0; i < CM_STORAGE_KEY_HEX_DIGITS; ++i) {
+    out[CM_STORAGE_KEY_HEX_DIGITS - 1 - i] = digits[(hashValue >> (4 * i)) & 0xF];
+  }
+  out[CM_STORAGE_KEY_HEX_DIGITS] = '\0';
+}
+
+// Writes the hashed storage key for a key hint into a caller-provided buffer (no heap use).
+inline void formatStorageKey(const char* data, size_t len, char (&out)[CM_STORAGE_KEY_BUFFER_SIZE]) {
+  writeStorageKey(fnv1aHash64(data, len), out);
+}
+
 inline String hashStringForStorage(const String& value) {
-  const size_t len = value.length();
-  const uint64_t hashValue = fnv1aHash64(value.c_str(), len);
-  char buffer[16];
-  // Keep result under 15 characters (HEX) to satisfy Preferences key limits
-  snprintf(buffer, sizeof(buffer), "%012llX", static_cast<unsigned long long>(hashValue & 0xFFFFFFFFFFFFull));
+  char buffer[CM_STORAGE_KEY_BUFFER_SIZE];
+  formatStorageKey(value.c_str(), value.length(), buffer);
   return String(buffer);
 }
 
+namespace cm {
+
+// Storage key derived at compile time from a literal key hint (see CM_STORAGE_KEY).
+struct StorageKeyLiteral {
+  char value[CM_STORAGE_KEY_BUFFER_SIZE] = {};
+};
+
+// The 48 bits of the hint's FNV-1a hash that end up in the storage key.
+constexpr uint64_t storageKeyBits(const char* hint) {
+  return fnv1aHash64(hint, const_strlen(hint)) & ((1ull << (4 * CM_STORAGE_KEY_HEX_DIGITS)) - 1);
+}
+
+constexpr StorageKeyLiteral makeStorageKey(const char* hint) {
+  StorageKeyLiteral key{};
+  writeStorageKey(storageKeyBits(hint), key.value);
+  return key;
+}
+
+// True when no two hints derive the same storage key (duplicate hints or hash collisions).
+template <size_t N>
+constexpr bool storageKeysUnique(const char* const (&hints)[N]) {
+  for (size_t i = 0; i < N; ++i) {
+    const uint64_t bits = storageKeyBits(hints[i]);
+    for (size_t j = i + 1; j < N; ++j) {
+      if (bits == storageKeyBits(hints[j])) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+} // namespace cm
+
+// Compile-time storage key for a literal key hint. The key lives in flash as a
+// const char[] and is identical to what BaseSetting derives at runtime, e.g.
+//   ConfigOptions<int>{.key = "port", ..., .storageKey = CM_STORAGE_KEY("port")}
+#define CM_STORAGE_KEY(hint)                                                            \
+  ([]() -> const char* {                                                                \
+    static constexpr ::cm::StorageKeyLiteral cmStorageKey = ::cm::makeStorageKey(hint); \
+    return cmStorageKey.value;                                                          \
+  }())
+
+// Opt-in build-time duplicate check for a project's literal key hints:
+//   CM_STORAGE_KEY_REGISTRY(appKeys, "wifiSsid", "wifiPass", "mqttHost");
+// declares `appKeys[]` and fails to compile if two hints map to the same storage key.
+#define CM_STORAGE_KEY_REGISTRY(name, ...)              \
+  inline constexpr const char* name[] = {__VA_ARGS__}; \
+  static_assert(::cm::storageKeysUnique(name), "Duplicate ConfigManager storage key in " #name)
+
+// Immutable metadata of one setting. Settings created from ConfigOptions keep a heap
+// copy; settings created from a ConfigDescriptor<T> point at a constexpr table in flash
+// instead of copying it to the heap. The storage key is derived
+// from the key hint at compile time when the descriptor is constexpr.
+struct SettingDescriptor {
+  const char* key = nullptr;            // Key hint (required for descriptor tables)
+  const char* name = nullptr;           // Display name (falls back to key)
+  const char* category = nullptr;       // Falls back to "Default"
+  const char* categoryPretty = nullptr; // Falls back to category
+  const char* card = nullptr;
+  const char* cardPretty = nullptr;
+  int sortOrder = 100;
+  int cardOrder = 100;
+  bool showInWeb = true;
+  bool isPassword = false;
+  cm::StorageKeyLiteral storageKey = key ? cm::makeStorageKey(key) : cm::StorageKeyLiteral{};
+};
+
+// Descriptor defaults must be constexpr, so String settings take a literal.
+template <typename T>
+struct DescriptorValue {
+  using type = T;
+};
+template <>
+struct DescriptorValue<String> {
+  using type = const char*;
+};
+
+// Flash-resident definition of a Config<T>:
+//   constexpr ConfigDescriptor<int> kPortDesc{{.key = "port", .name = "Port", .category = "MQTT"}, 1883};
+//   Config<int> port{kPortDesc};
+// The descriptor must outlive the setting (namespace-scope constexpr).
+template <typename T>
+struct ConfigDescriptor : SettingDescriptor {
+  typename DescriptorValue<T>::type defaultValue{};
+};
+
+// Metadata of a setting built from ConfigOptions<T>, stored in the Config<T>. String
+// defaults keep their text here and defaultValue points into it.
+template <typename T>
+struct OwnedConfigDescriptor : ConfigDescriptor<T> {
+};
+template <>
+struct OwnedConfigDescriptor<String> : ConfigDescriptor<String> {
+  String defaultText;
+};
+
+// Approximate RAM owned by one setting (see BaseSetting::getRamUsage()).
+struct SettingRamUsage {
+  size_t objectBytes = 0; // sizeof the setting object
+  size_t heapBytes = 0;   // Heap-owned metadata and string payloads
+  bool flashDescriptor = false;
+};
+
 struct ConfigRequestContext {
   enum class Origin {
     None,
@@ -305,28 +447,93 @@ inline const char* toString(ValidationSeverity severity) {
 // BaseSetting class (updated for new ConfigOptions structure)
 class BaseSetting {
 protected:
-  bool showInWeb;
-  bool isPassword;
+  // Where `descriptor` lives: a constexpr table, a heap copy owned by this BaseSetting,
+  // or inside the Config<T> subclass.
+  enum class DescriptorOwner : uint8_t {
+    Table,
+    Base,
+    Derived
+  };
+
+  const SettingDescriptor* descriptor = nullptr;
+  DescriptorOwner descriptorOwner = DescriptorOwner::Table;
   bool modified = false;
   bool persistSetting = true;
-  String storageKey;
-  const char* storageKeyPtr = nullptr;
-  const char* category;
-  const char* displayName;
-  const char* categoryPrettyName = nullptr;
-  const char* cardName = nullptr;
-  const char* cardPrettyName = nullptr;
-  int cardOrder = 100;
-  SettingType type;
-  int sortOrder = 100;
-  bool hasKeyLengthError = false;
-  String keyLengthErrorMsg;
-  inline static std::set<String> registeredStorageKeys;
+  bool persistPending = false; // Write-behind dirty bit: queued for the next NVS commit
+  uint32_t generation = 0;     // Settings epoch of the last change (see bumpGeneration())
+  bool callbackHeld = false;    // Transaction in progress: record changes, call back on release
+  bool callbackPending = false;
+
+  const char* errorMessage = nullptr; // Static text; details are logged when the error is detected
+  inline static std::set<uint64_t> registeredStorageKeys; // Hashes of the storage keys, not the keys themselves
+  inline static std::atomic<uint32_t> settingsEpoch{0};
 
-  static constexpr size_t MAX_PREFS_KEY_LEN = 15;
+  static constexpr size_t MAX_PREFS_KEY_LEN = CM_PREFS_MAX_KEY_LEN;
 
   mutable std::function<void(const char*)> logger;
 
+  // Invokes the change callback with the current value (used by releaseCallback()).
+  virtual void notifyChanged() {
+  }
+
+  // Fills the name/category fallbacks and the storage key of a runtime-built descriptor.
+  static void resolveDescriptor(SettingDescriptor& target, const char* key, const char* name, const char* category, const char* precomputedKey) {
+    // The key hint is not kept: callers may pass a temporary buffer.
+    const char* fallbackName = "Default";
+    target.category = (category && category[0] != '\0') ? category : fallbackName;
+    target.name = (name && name[0] != '\0')
+                    ? name
+                    : ((key && key[0] != '\0') ? key : fallbackName);
+    if (!target.categoryPretty) {
+      target.categoryPretty = target.category;
+    }
+
+    if (precomputedKey && precomputedKey[0] != '\0') {
+      // CM_STORAGE_KEY(): derived at compile time.
+      strncpy(target.storageKey.value, precomputedKey, CM_STORAGE_KEY_BUFFER_SIZE - 1);
+      target.storageKey.value[CM_STORAGE_KEY_BUFFER_SIZE - 1] = '\0';
+    } else if (key && key[0] != '\0') {
+      formatStorageKey(key, strlen(key), target.storageKey.value);
+    } else {
+      const String keyHint = generateKeyFromNameAndCategory(target.name, target.category);
+      formatStorageKey(keyHint.c_str(), keyHint.length(), target.storageKey.value);
+    }
+  }
+
+  // Registers the storage key and flags collisions, length and character errors.
+  void validateStorageKey() {
+    const char* storageKey = getKey();
+    if (storageKey[0] == '\0') {
+      errorMessage = "Descriptor without key hint - not persisted";
+      log("[ERROR] Setting '%s' has no key hint - not persisted", getDisplayName());
+      return;
+    }
+    if (!registerStorageKey(storageKey)) {
+      errorMessage = "Storage key collision - not persisted";
+      log("[WARNING] Storage key collision for '%s' (%s) - not persisted", getDisplayName(), storageKey);
+    }
+    checkKeyLength();
+  }
+
+  // Debug check that CM_STORAGE_KEY() was given the same hint as the key; otherwise the
+  // value would be stored where findSettingByKeyHint() and older firmware never look.
+  void checkPrecomputedKey(const char* key, const char* precomputedKey) {
+#ifndef NDEBUG
+    if (!key || key[0] == '\0' || !precomputedKey || precomputedKey[0] == '\0' || errorMessage) {
+      return;
+    }
+    char expected[CM_STORAGE_KEY_BUFFER_SIZE];
+    formatStorageKey(key, strlen(key), expected);
+    if (strcmp(expected, getKey()) != 0) {
+      errorMessage = "CM_STORAGE_KEY does not match the key hint - not persisted";
+      log("[ERROR] CM_STORAGE_KEY for '%s' does not match key hint '%s' (%s != %s)", getDisplayName(), key, getKey(), expected);
+    }
+#else
+    (void)key;
+    (void)precomputedKey;
+#endif
+  }
+
   void log(const char* format, ...) const {
 #if CM_ENABLE_LOGGING
     if (logger) {
@@ -354,17 +561,18 @@ protected:
   }
 
   void checkKeyLength() {
-    if (hasKeyLengthError)
+    if (errorMessage)
       return;
 
     const char* actualKey = getKey();
     size_t keyLen = strlen(actualKey);
 
     if (keyLen > MAX_PREFS_KEY_LEN) {
-      hasKeyLengthError = true;
-      keyLengthErrorMsg = String("Generated key too long: ") + actualKey +
-                          " (" + String(keyLen) + " > " + String(MAX_PREFS_KEY_LEN) + ") - value will not be stored!";
-      log("[ERROR] %s", keyLengthErrorMsg.c_str());
+      errorMessage = "Generated key too long - value will not be stored!";
+      log("[ERROR] Generated key too long: %s (%u > %u) - value will not be stored!",
+          actualKey,
+          static_cast<unsigned>(keyLen),
+          static_cast<unsigned>(MAX_PREFS_KEY_LEN));
       return;
     }
 
@@ -372,24 +580,23 @@ protected:
     for (size_t i = 0; i < keyLen; i++) {
       char c = actualKey[i];
       if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
-        hasKeyLengthError = true;
-        keyLengthErrorMsg = String("Key contains invalid characters: ") + actualKey;
-        log("[ERROR] %s", keyLengthErrorMsg.c_str());
+        errorMessage = "Key contains invalid characters";
+        log("[ERROR] Key contains invalid characters: %s", actualKey);
         return;
       }
     }
   }
 
-  static bool registerStorageKey(const String& key) {
-    return registeredStorageKeys.insert(key).second;
+  static bool registerStorageKey(const char* key) {
+    return registeredStorageKeys.insert(fnv1aHash64(key, strlen(key))).second;
   }
 
 public:
   bool hasError() const {
-    return hasKeyLengthError;
+    return errorMessage != nullptr;
   }
   const char* getError() const {
-    return keyLengthErrorMsg.c_str();
+    return errorMessage ? errorMessage : "";
   }
 
   void setLogger(std::function<void(const char*)> logFunc) {
@@ -403,112 +610,422 @@ public:
     persistSetting = persist;
   }
 
-  // New constructor for ConfigOptions-based initialization
-  BaseSetting(const char* key, const char* name, const char* category, SettingType type, bool showInWeb = true, bool isPassword = false, int sortOrder = 100, const char* categoryPretty = nullptr, const char* card = nullptr, const char* cardPretty = nullptr, int cardOrder = 100)
-      : displayName(nullptr), category(nullptr), categoryPrettyName(categoryPretty),
-        cardName(card), cardPrettyName(cardPretty), cardOrder(cardOrder), type(type),
-        showInWeb(showInWeb), isPassword(isPassword), sortOrder(sortOrder) {
-    const char* fallbackName = "Default";
-    const char* resolvedCategory = (category && category[0] != '\0') ? category : fallbackName;
-    const char* resolvedName = (name && name[0] != '\0')
-                                 ? name
-                                 : ((key && key[0] != '\0') ? key : fallbackName);
+  // Builds and owns a descriptor from individual fields (custom BaseSetting subclasses).
+  BaseSetting(const char* key, const char* name, const char* category, SettingType type, bool showInWeb = true, bool isPassword = false, int sortOrder = 100, const char* categoryPretty = nullptr, const char* card = nullptr, const char* cardPretty = nullptr, int cardOrder = 100, const char* precomputedKey = nullptr) {
+    (void)type;
+    SettingDescriptor* owned = new SettingDescriptor{};
+    owned->showInWeb = showInWeb;
+    owned->isPassword = isPassword;
+    owned->sortOrder = sortOrder;
+    owned->categoryPretty = categoryPretty;
+    owned->card = card;
+    owned->cardPretty = cardPretty;
+    owned->cardOrder = cardOrder;
+    resolveDescriptor(*owned, key, name, category, precomputedKey);
+    descriptor = owned;
+    descriptorOwner = DescriptorOwner::Base;
+    validateStorageKey();
+    checkPrecomputedKey(key, precomputedKey);
+  }
 
-    displayName = resolvedName;
-    this->category = resolvedCategory;
-    if (!categoryPrettyName) {
-      categoryPrettyName = resolvedCategory;
-    }
+  // Uses an existing descriptor (flash table).
+  BaseSetting(const SettingDescriptor& source, DescriptorOwner owner)
+      : descriptor(&source), descriptorOwner(owner) {
+    validateStorageKey();
+  }
 
-    String keyHint;
-    if (key && key[0] != '\0') {
-      keyHint = key;
-    } else {
-      keyHint = generateKeyFromNameAndCategory(resolvedName, resolvedCategory);
-    }
+  // For a subclass that stores the descriptor itself: it fills it, sets `descriptor`
+  // and calls validateStorageKey() from its constructor body.
+  explicit BaseSetting(DescriptorOwner owner)
+      : descriptorOwner(owner) {
+  }
 
-    storageKey = hashStringForStorage(keyHint);
-    storageKeyPtr = storageKey.c_str();
-    if (!registerStorageKey(storageKey)) {
-      hasKeyLengthError = true;
-      keyLengthErrorMsg = String("Storage key collision for '") + displayName + "' (" + storageKey + ") - not persisted";
-      log("[WARNING] %s", keyLengthErrorMsg.c_str());
+  BaseSetting(const BaseSetting&) = delete;
+  BaseSetting& operator=(const BaseSetting&) = delete;
+
+  virtual ~BaseSetting() {
+    if (descriptorOwner == DescriptorOwner::Base) {
+      delete descriptor;
     }
-    checkKeyLength();
   }
-
-  virtual ~BaseSetting() = default;
   virtual SettingType getType() const = 0;
   virtual void load(Preferences& prefs) = 0;
   virtual void save(Preferences& prefs) = 0;
   virtual void setDefault() = 0;
   virtual void toJSON(JsonObject& obj) const = 0;
   virtual bool fromJSON(const JsonVariant& value) = 0;
+
+  // Parses a textual value (web forms, bulk endpoints, Config<T>::save()) and assigns it.
+  // Config<T> parses by its declared type without heap allocation; this default keeps the
+  // legacy behaviour for custom subclasses and guesses the JSON type from the text.
+  virtual bool fromString(const char* value, size_t len) {
+    if (!value) {
+      return false;
+    }
+    String text;
+    text.concat(value, len);
+    JsonDocument doc;
+    char* endPtr = nullptr;
+    const long longVal = strtol(text.c_str(), &endPtr, 10);
+    if (text == "true" || text == "false") {
+      doc.set(text == "true");
+    } else if (len > 0 && *endPtr == '\0') {
+      doc.set(static_cast<int>(longVal));
+    } else if (const float floatVal = strtof(text.c_str(), &endPtr); len > 0 && *endPtr == '\0') {
+      doc.set(floatVal);
+    } else {
+      doc.set(text);
+    }
+    return fromJSON(doc.as<JsonVariant>());
+  }
+
+  // Checks that fromString() would accept `value` without changing the setting.
+  // Used by transactions to validate every staged value before applying any.
+  virtual bool acceptsString(const char* value, size_t len) const {
+    (void)len;
+    return value != nullptr;
+  }
+
+  // Writes the compact `"key":{...}` member emitted by toJSON() to a stream.
+  // The default goes through a temporary document; Config<T> writes directly.
+  virtual void writeJSON(Print& out) const {
+    JsonDocument doc;
+    JsonObject root = doc.to<JsonObject>();
+    toJSON(root);
+    bool first = true;
+    for (JsonPair kv : root) {
+      if (!first) {
+        out.write(',');
+      }
+      cm::web::writeJsonString(out, kv.key().c_str());
+      out.write(':');
+      serializeJson(kv.value(), out);
+      first = false;
+    }
+  }
   virtual bool isVisible() const {
-    return showInWeb;
+    return descriptor->showInWeb;
+  }
+  // True when visibility is computed from other settings (showIf), so a change
+  // elsewhere can flip it without bumping this setting's generation.
+  virtual bool hasDynamicVisibility() const {
+    return false;
   }
 
+  // Runtime-built descriptors are resolved on construction; table entries may leave
+  // name/category empty and get the same fallbacks here.
   const char* getDisplayName() const {
-    return displayName;
+    const char* name = descriptor->name;
+    if (name && name[0] != '\0') {
+      return name;
+    }
+    return (descriptor->key && descriptor->key[0] != '\0') ? descriptor->key : "Default";
   }
   const char* getKey() const {
-    return storageKeyPtr;
+    return descriptor->storageKey.value;
   }
   const char* getCategory() const {
-    return category;
+    const char* category = descriptor->category;
+    return (category && category[0] != '\0') ? category : "Default";
   }
   const char* getCategoryPretty() const {
-    return categoryPrettyName ? categoryPrettyName : category;
+    return descriptor->categoryPretty ? descriptor->categoryPretty : getCategory();
   }
   const char* getCard() const {
-    return cardName;
+    return descriptor->card;
   }
   const char* getCardPretty() const {
-    return cardPrettyName ? cardPrettyName : cardName;
+    return descriptor->cardPretty ? descriptor->cardPretty : descriptor->card;
   }
   int getCardOrder() const {
-    return cardOrder;
+    return descriptor->cardOrder;
   }
   const char* getName() const {
-    return storageKeyPtr;
+    return getKey();
   }
   int getSortOrder() const {
-    return sortOrder;
+    return descriptor->sortOrder;
   }
   bool isSecret() const {
-    return isPassword;
+    return descriptor->isPassword;
   }
   bool shouldShowInWeb() const {
-    return showInWeb;
+    return descriptor->showInWeb;
+  }
+  bool usesDescriptorTable() const {
+    return descriptorOwner == DescriptorOwner::Table;
+  }
+
+  // Approximate RAM held by this setting: the object itself plus heap-owned metadata
+  // and string payloads. std::function targets are not included.
+  virtual SettingRamUsage getRamUsage() const {
+    SettingRamUsage usage;
+    usage.objectBytes = sizeof(BaseSetting);
+    usage.heapBytes = descriptorOwner == DescriptorOwner::Base ? sizeof(SettingDescriptor) : 0;
+    usage.flashDescriptor = usesDescriptorTable();
+    return usage;
+  }
+
+  // Heap bytes behind a String; Arduino-ESP32 keeps up to 11 characters inline.
+  static size_t stringHeapBytes(const String& text) {
+    static constexpr size_t INLINE_CAPACITY = 11;
+    return text.length() > INLINE_CAPACITY ? text.length() + 1 : 0;
   }
   bool needsSave() const {
     return modified;
   }
+
+  // Binary snapshot support (SettingsStorageMode::Blob). Settings that do not
+  // support it keep using their own Preferences key in every storage mode.
+  virtual bool supportsBinary() const {
+    return false;
+  }
+  virtual void encodeBinary(cm::storage::BlobWriter& out) const {
+    (void)out;
+  }
+  virtual bool decodeBinary(cm::storage::BlobReader& in) {
+    (void)in;
+    return false;
+  }
+  uint32_t getKeyHash() const {
+    const char* storageKey = getKey();
+    const uint64_t hash = fnv1aHash64(storageKey, strlen(storageKey));
+    return static_cast<uint32_t>(hash ^ (hash >> 32));
+  }
+  void markPersisted() {
+    modified = false;
+  }
+
+  // Change detection. Every value change (set/fromJSON/fromString/load) stamps the
+  // setting with the next global settings epoch, so "changed since X" is one compare.
+  uint32_t getGeneration() const {
+    return generation;
+  }
+  void bumpGeneration() {
+    generation = settingsEpoch.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+  static uint32_t currentSettingsEpoch() {
+    return settingsEpoch.load(std::memory_order_relaxed);
+  }
+
+  // Write-behind bookkeeping used by ConfigManagerClass::flush().
+  // markPersistPending() returns false if the setting was already queued.
+  bool markPersistPending() {
+    const bool wasPending = persistPending;
+    persistPending = true;
+    return !wasPending;
+  }
+  bool isPersistPending() const {
+    return persistPending;
+  }
+  void clearPersistPending() {
+    persistPending = false;
+  }
+
+  // Transactions hold the change callback while staged values are applied and
+  // release it afterwards, so callbacks observe the complete new configuration.
+  void holdCallback() {
+    callbackHeld = true;
+  }
+  void releaseCallback() {
+    callbackHeld = false;
+    if (callbackPending) {
+      callbackPending = false;
+      notifyChanged();
+    }
+  }
+};
+
+// Open-addressing index over (category, storage key) pairs.
+// Entry must provide getCategory() and getKey() returning stable C strings.
+// Slots only grow on insert(), so find() never allocates.
+template <typename Entry>
+class SettingLookupIndex {
+public:
+  static uint32_t hashPair(const char* category, size_t categoryLen, const char* key, size_t keyLen) {
+    static const char separator = '\x1F';
+    uint64_t hash = fnv1aHash64(category, categoryLen);
+    hash = fnv1aHash64(&separator, 1, hash);
+    hash = fnv1aHash64(key, keyLen, hash);
+    return static_cast<uint32_t>(hash ^ (hash >> 32));
+  }
+
+  // Returns false if an entry with the same (category, key) is already indexed.
+  bool insert(Entry* entry) {
+    if (!entry || !entry->getCategory() || !entry->getKey()) {
+      return false;
+    }
+    const char* category = entry->getCategory();
+    const char* key = entry->getKey();
+    const size_t categoryLen = strlen(category);
+    const size_t keyLen = strlen(key);
+    if (find(category, categoryLen, key, keyLen)) {
+      return false;
+    }
+    // Keep the load factor at or below 3/4 so probe chains stay short.
+    if ((count + 1) * 4 > slots.size() * 3) {
+      rehash(slots.empty() ? MIN_CAPACITY : slots.size() * 2);
+    }
+    place(hashPair(category, categoryLen, key, keyLen), entry);
+    ++count;
+    return true;
+  }
+
+  Entry* find(const char* category, size_t categoryLen, const char* key, size_t keyLen) const {
+    if (count == 0 || !category || !key) {
+      return nullptr;
+    }
+    const uint32_t hash = hashPair(category, categoryLen, key, keyLen);
+    const size_t mask = slots.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+      const Slot& slot = slots[i];
+      if (!slot.entry) {
+        return nullptr;
+      }
+      if (slot.hash == hash && matches(slot.entry->getCategory(), category, categoryLen) && matches(slot.entry->getKey(), key, keyLen)) {
+        return slot.entry;
+      }
+    }
+  }
+
+  Entry* find(const char* category, const char* key) const {
+    if (!category || !key) {
+      return nullptr;
+    }
+    return find(category, strlen(category), key, strlen(key));
+  }
+
+  void clear() {
+    slots.clear();
+    count = 0;
+  }
+
+  size_t size() const {
+    return count;
+  }
+
+  size_t capacity() const {
+    return slots.size();
+  }
+
+private:
+  struct Slot {
+    uint32_t hash = 0;
+    Entry* entry = nullptr;
+  };
+
+  static constexpr size_t MIN_CAPACITY = 16;
+
+  std::vector<Slot> slots;
+  size_t count = 0;
+
+  static bool matches(const char* stored, const char* probe, size_t probeLen) {
+    return stored && strncmp(stored, probe, probeLen) == 0 && stored[probeLen] == '\0';
+  }
+
+  void place(uint32_t hash, Entry* entry) {
+    const size_t mask = slots.size() - 1;
+    size_t i = hash & mask;
+    while (slots[i].entry) {
+      i = (i + 1) & mask;
+    }
+    slots[i].hash = hash;
+    slots[i].entry = entry;
+  }
+
+  void rehash(size_t newCapacity) {
+    std::vector<Slot> previous(newCapacity);
+    previous.swap(slots);
+    for (const Slot& slot : previous) {
+      if (slot.entry) {
+        place(slot.hash, slot.entry);
+      }
+    }
+  }
 };
 
 // Config<T> template class (updated for new ConfigOptions structure)
 template <typename T>
 class Config : public BaseSetting {
 private:
+  using OwnedDescriptor = OwnedConfigDescriptor<T>;
+
   T value;
-  T defaultValue;
   std::function<void(T)> callback = nullptr;
+  // Metadata of a setting built from ConfigOptions<T>, kept in the object so the
+  // default path needs no heap allocation. Unused for descriptor-table settings.
+  OwnedDescriptor ownedDescriptor;
+
+  void initOwnedDescriptor(const ConfigOptions<T>& opts) {
+    ownedDescriptor.showInWeb = opts.showInWeb;
+    ownedDescriptor.isPassword = opts.isPassword;
+    ownedDescriptor.sortOrder = opts.sortOrder;
+    ownedDescriptor.categoryPretty = opts.categoryPretty;
+    ownedDescriptor.card = opts.card;
+    ownedDescriptor.cardPretty = opts.cardPretty;
+    ownedDescriptor.cardOrder = opts.cardOrder;
+    resolveDescriptor(ownedDescriptor, opts.key, opts.name, opts.category, opts.storageKey);
+    if constexpr (std::is_same_v<T, String>) {
+      ownedDescriptor.defaultText = opts.defaultValue;
+      ownedDescriptor.defaultValue = ownedDescriptor.defaultText.c_str();
+    } else {
+      ownedDescriptor.defaultValue = opts.defaultValue;
+    }
+    descriptor = &ownedDescriptor;
+  }
 
 public:
   std::function<bool()> showIfFunc = nullptr;
   bool isVisible() const override {
     return showIfFunc ? showIfFunc() : BaseSetting::isVisible();
   }
+  bool hasDynamicVisibility() const override {
+    return showIfFunc != nullptr;
+  }
 
   // New primary constructor for ConfigOptions
   explicit Config(const ConfigOptions<T>& opts)
-      : BaseSetting(opts.key, opts.name, opts.category, TypeTraits<T>::type, opts.showInWeb, opts.isPassword, opts.sortOrder, opts.categoryPretty, opts.card, opts.cardPretty, opts.cardOrder),
-        value(opts.defaultValue), defaultValue(opts.defaultValue), showIfFunc(opts.showIf) {
+      : BaseSetting(DescriptorOwner::Derived),
+        value(opts.defaultValue), showIfFunc(opts.showIf) {
+    initOwnedDescriptor(opts);
+    validateStorageKey();
+    checkPrecomputedKey(opts.key, opts.storageKey);
     if (opts.callback) {
       callback = opts.callback;
     }
   }
 
+  // Descriptor-table constructor: metadata and default stay in flash.
+  explicit Config(const ConfigDescriptor<T>& desc)
+      : BaseSetting(desc, DescriptorOwner::Table), value(getDefaultValue()) {
+  }
+  // The descriptor is referenced, not copied, so temporaries are rejected.
+  explicit Config(const ConfigDescriptor<T>&&) = delete;
+
+  T getDefaultValue() const {
+    const auto& desc = static_cast<const ConfigDescriptor<T>&>(*descriptor);
+    if constexpr (std::is_same_v<T, String>) {
+      return String(desc.defaultValue ? desc.defaultValue : "");
+    } else {
+      return desc.defaultValue;
+    }
+  }
+
+  SettingRamUsage getRamUsage() const override {
+    SettingRamUsage usage;
+    usage.objectBytes = sizeof(*this);
+    usage.flashDescriptor = usesDescriptorTable();
+    if constexpr (std::is_same_v<T, String>) {
+      if (descriptorOwner == DescriptorOwner::Derived) {
+        usage.heapBytes += stringHeapBytes(ownedDescriptor.defaultText);
+      }
+    }
+    if constexpr (std::is_same_v<T, String>) {
+      usage.heapBytes += stringHeapBytes(value);
+    }
+    return usage;
+  }
+
   const T& get() const {
     return value;
   }
@@ -517,8 +1034,12 @@ public:
     if (value != newValue) {
       value = newValue;
       modified = true;
-      if (callback)
+      bumpGeneration();
+      if (callbackHeld) {
+        callbackPending = true;
+      } else if (callback) {
         callback(newValue);
+      }
     }
   }
 
@@ -544,13 +1065,13 @@ public:
 
     auto readFrom = [&](const char* sourceKey) -> T {
       if constexpr (std::is_same_v<T, String>) {
-        return prefs.getString(sourceKey, defaultValue);
+        return prefs.getString(sourceKey, getDefaultValue());
       } else if constexpr (std::is_same_v<T, bool>) {
-        return prefs.getBool(sourceKey, defaultValue);
+        return prefs.getBool(sourceKey, getDefaultValue());
       } else if constexpr (std::is_same_v<T, int>) {
-        return prefs.getInt(sourceKey, defaultValue);
+        return prefs.getInt(sourceKey, getDefaultValue());
       } else if constexpr (std::is_same_v<T, float>) {
-        return prefs.getFloat(sourceKey, defaultValue);
+        return prefs.getFloat(sourceKey, getDefaultValue());
       }
     };
 
@@ -558,7 +1079,7 @@ public:
       size_t bytesWritten = 0;
       if constexpr (std::is_same_v<T, String>) {
         bytesWritten = prefs.putString(targetKey, value);
-        if (isPassword) {
+        if (isSecret()) {
           log("[PREFS] %s %s.%s = '***' (hidden)", actionLabel, getCategory(), getDisplayName());
         } else {
           log("[PREFS] %s %s.%s = '%s'", actionLabel, getCategory(), getDisplayName(), value.c_str());
@@ -582,7 +1103,8 @@ public:
     };
 
     if (!keyExists) {
-      value = defaultValue;
+      value = getDefaultValue();
+      bumpGeneration();
       const bool writeOk = persistValue(storageKey, "Initialized (default)");
       modified = !writeOk;
       return;
@@ -590,9 +1112,10 @@ public:
 
     value = readFrom(storageKey);
     modified = false;
+    bumpGeneration();
 
     if constexpr (std::is_same_v<T, String>) {
-      if (isPassword) {
+      if (isSecret()) {
         logVerbose("[PREFS] Loaded %s.%s = '***' (hidden)", getCategory(), getDisplayName());
       } else {
         logVerbose("[PREFS] Loaded %s.%s = '%s'", getCategory(), getDisplayName(), value.c_str());
@@ -618,7 +1141,7 @@ public:
     size_t bytesWritten = 0;
     if constexpr (std::is_same_v<T, String>) {
       bytesWritten = prefs.putString(getKey(), value);
-      if (isPassword) {
+      if (isSecret()) {
         logVerbose("[PREFS] Saved %s.%s = '***' (hidden)", getCategory(), getDisplayName());
       } else {
         logVerbose("[PREFS] Saved %s.%s = '%s'", getCategory(), getDisplayName(), value.c_str());
@@ -643,15 +1166,16 @@ public:
   }
 
   void setDefault() override {
-    value = defaultValue;
+    value = getDefaultValue();
     modified = true;
+    bumpGeneration();
   }
 
   void toJSON(JsonObject& obj) const override {
     const char* jsonKey = getKey();
     JsonObject settingObj = obj.createNestedObject(jsonKey);
 
-    if (isPassword) {
+    if (isSecret()) {
       // Passwords are masked in config.json. Use /config/password after auth to reveal.
       settingObj["value"] = "***";
     } else {
@@ -661,8 +1185,8 @@ public:
     // Add metadata for web interface
     settingObj["displayName"] = getDisplayName();
     settingObj["key"] = getKey();
-    settingObj["isPassword"] = isPassword;
-    settingObj["sortOrder"] = sortOrder;
+    settingObj["isPassword"] = isSecret();
+    settingObj["sortOrder"] = getSortOrder();
 
     // Add showIf result if function is defined
     if (showIfFunc != nullptr) {
@@ -670,6 +1194,90 @@ public:
     }
   }
 
+  bool supportsBinary() const override {
+    return true;
+  }
+
+  void encodeBinary(cm::storage::BlobWriter& out) const override {
+    if constexpr (std::is_same_v<T, String>) {
+      const uint16_t len = static_cast<uint16_t>(std::min<size_t>(value.length(), UINT16_MAX));
+      out.u16(len);
+      out.bytes(value.c_str(), len);
+    } else if constexpr (std::is_same_v<T, bool>) {
+      out.u8(value ? 1 : 0);
+    } else if constexpr (std::is_same_v<T, int>) {
+      out.u32(static_cast<uint32_t>(value));
+    } else if constexpr (std::is_same_v<T, float>) {
+      uint32_t bits = 0;
+      memcpy(&bits, &value, sizeof(bits));
+      out.u32(bits);
+    }
+  }
+
+  bool decodeBinary(cm::storage::BlobReader& in) override {
+    if constexpr (std::is_same_v<T, String>) {
+      uint16_t len = 0;
+      if (!in.u16(len)) {
+        return false;
+      }
+      const char* data = in.bytes(len);
+      if (!data) {
+        return false;
+      }
+      value = String();
+      value.concat(data, len);
+    } else if constexpr (std::is_same_v<T, bool>) {
+      uint8_t raw = 0;
+      if (!in.u8(raw)) {
+        return false;
+      }
+      value = raw != 0;
+    } else if constexpr (std::is_same_v<T, int>) {
+      uint32_t raw = 0;
+      if (!in.u32(raw)) {
+        return false;
+      }
+      value = static_cast<int>(raw);
+    } else if constexpr (std::is_same_v<T, float>) {
+      uint32_t raw = 0;
+      if (!in.u32(raw)) {
+        return false;
+      }
+      memcpy(&value, &raw, sizeof(value));
+    }
+    modified = false;
+    bumpGeneration();
+    return true;
+  }
+
+  void writeJSON(Print& out) const override {
+    cm::web::writeJsonString(out, getKey());
+    out.print(":{\"value\":");
+    if (isSecret()) {
+      // Passwords are masked in config.json. Use /config/password after auth to reveal.
+      cm::web::writeJsonString(out, "***");
+    } else if constexpr (std::is_same_v<T, String>) {
+      cm::web::writeJsonString(out, value.c_str(), value.length());
+    } else if constexpr (std::is_same_v<T, bool>) {
+      cm::web::writeJsonBool(out, value);
+    } else {
+      cm::web::writeJsonNumber(out, value);
+    }
+    out.print(",\"displayName\":");
+    cm::web::writeJsonString(out, getDisplayName());
+    out.print(",\"key\":");
+    cm::web::writeJsonString(out, getKey());
+    out.print(",\"isPassword\":");
+    cm::web::writeJsonBool(out, isSecret());
+    out.print(",\"sortOrder\":");
+    cm::web::writeJsonNumber(out, getSortOrder());
+    if (showIfFunc != nullptr) {
+      out.print(",\"showIf\":");
+      cm::web::writeJsonBool(out, showIfFunc());
+    }
+    out.write('}');
+  }
+
   bool fromJSON(const JsonVariant& jsonValue) override {
     if (jsonValue.isNull()) {
       return false;
@@ -699,6 +1307,84 @@ public:
     set(newValue);
     return true;
   }
+
+  bool fromString(const char* text, size_t len) override {
+    if constexpr (std::is_same_v<T, String>) {
+      if (!text) {
+        return false;
+      }
+      String newValue;
+      newValue.concat(text, len);
+      set(newValue);
+      return true;
+    } else {
+      T newValue{};
+      if (!parseString(text, len, newValue)) {
+        return false;
+      }
+      set(newValue);
+      return true;
+    }
+  }
+
+  bool acceptsString(const char* text, size_t len) const override {
+    if constexpr (std::is_same_v<T, String>) {
+      return text != nullptr;
+    } else {
+      T parsed{};
+      return parseString(text, len, parsed);
+    }
+  }
+
+protected:
+  void notifyChanged() override {
+    if (callback) {
+      callback(value);
+    }
+  }
+
+private:
+  // Parses a bool/int/float by the declared type; no heap allocation.
+  static bool parseString(const char* text, size_t len, T& out) {
+    if (!text) {
+      return false;
+    }
+    if constexpr (std::is_same_v<T, bool>) {
+      if (len == 4 && strncmp(text, "true", 4) == 0) {
+        out = true;
+        return true;
+      }
+      if (len == 5 && strncmp(text, "false", 5) == 0) {
+        out = false;
+        return true;
+      }
+      return false;
+    } else {
+      // strtol/strtof need a terminated string; numbers always fit a small stack buffer.
+      char scratch[32];
+      if (len == 0 || len >= sizeof(scratch)) {
+        return false;
+      }
+      memcpy(scratch, text, len);
+      scratch[len] = '\0';
+      char* endPtr = nullptr;
+      errno = 0;
+      if constexpr (std::is_same_v<T, int>) {
+        const long parsed = strtol(scratch, &endPtr, 10);
+        if (endPtr == scratch || *endPtr != '\0' || errno == ERANGE || parsed < INT_MIN || parsed > INT_MAX) {
+          return false;
+        }
+        out = static_cast<int>(parsed);
+      } else {
+        const float parsed = strtof(scratch, &endPtr);
+        if (endPtr == scratch || *endPtr != '\0') {
+          return false;
+        }
+        out = parsed;
+      }
+      return true;
+    }
+  }
 };
 
 // Visibility helper factories
@@ -867,12 +1553,14 @@ public:
                      RuntimeFieldMeta metaValue,
                      std::function<void(JsonObject&)> providerFunc,
                      const String& providerGroupName,
-                     std::function<void(ConfigManagerRuntime&)> onCommitFunc = nullptr)
+                     std::function<void(ConfigManagerRuntime&)> onCommitFunc = nullptr,
+                     std::function<float()> historySourceFunc = nullptr)
         : runtime(&runtime),
           meta(std::move(metaValue)),
           provider(std::move(providerFunc)),
           providerGroup(providerGroupName),
-          onCommit(std::move(onCommitFunc)) {
+          onCommit(std::move(onCommitFunc)),
+          historySource(std::move(historySourceFunc)) {
     }
 
     LiveFieldBuilder(const LiveFieldBuilder&) = delete;
@@ -884,6 +1572,9 @@ public:
           provider(std::move(other.provider)),
           providerGroup(std::move(other.providerGroup)),
           onCommit(std::move(other.onCommit)),
+          historySource(std::move(other.historySource)),
+          historyScale(other.historyScale),
+          recordHistory(other.recordHistory),
           committed(other.committed) {
       other.committed = true;
     }
@@ -974,6 +1665,15 @@ public:
       return *this;
     }
 
+    // Records a numeric value in the runtime history (/runtime_history.json) as int16
+    // multiples of `scale`; 0 derives it from the precision (0.01 for precision 2).
+    // The scale bounds the range: +-32767 * scale.
+    LiveFieldBuilder& history(float scale = 0.0f) {
+      recordHistory = true;
+      historyScale = scale;
+      return *this;
+    }
+
   private:
     void applyCssClass(const char* cssClass, LiveCssTarget target) {
       switch (target) {
@@ -1017,6 +1717,16 @@ public:
       if (committed || !runtime) {
         return;
       }
+      if (recordHistory && historySource && providerGroup.length()) {
+        float scale = historyScale;
+        if (scale <= 0.0f) {
+          scale = 1.0f;
+          for (int i = 0; i < meta.precision; ++i) {
+            scale /= 10.0f;
+          }
+        }
+        meta.hasHistory = runtime->addRuntimeHistory(providerGroup, meta.key, historySource, scale);
+      }
       runtime->addRuntimeMeta(meta);
       if (provider && providerGroup.length()) {
         runtime->addRuntimeProvider(providerGroup, provider, meta.order);
@@ -1032,6 +1742,9 @@ public:
     std::function<void(JsonObject&)> provider;
     String providerGroup;
     std::function<void(ConfigManagerRuntime&)> onCommit;
+    std::function<float()> historySource; // Numeric value fields only
+    float historyScale = 0.0f;
+    bool recordHistory = false;
     bool committed = false;
   };
 
@@ -1251,89 +1964,348 @@ public:
       String resolvedGroup;
       resolveLayout(resolvedPage, resolvedCard, resolvedGroup);
 
-      meta.page = resolvedPage;
-      meta.card = resolvedCard;
-      meta.group = resolvedGroup;
+      meta.page = resolvedPage;
+      meta.card = resolvedCard;
+      meta.group = resolvedGroup;
+
+      return meta;
+    }
+
+    RuntimeFieldMeta createBaseMeta(const String& key) {
+      return createBaseMeta(key.c_str());
+    }
+
+    void resolveLayout(String& resolvedPage, String& resolvedCard, String& resolvedGroup) {
+      const bool hasPage = pageName.length() > 0;
+      resolvedPage = hasPage ? pageName : String();
+      if (cardName.length()) {
+        resolvedCard = cardName;
+      } else if (hasPage) {
+        resolvedCard = resolvedPage;
+      } else {
+        resolvedCard = String();
+      }
+      resolvedGroup = groupName;
+
+      if (hasPage) {
+        manager.addLivePage(resolvedPage.c_str(), pageOrder);
+        manager.addLiveCard(resolvedPage.c_str(), resolvedCard.c_str(), cardOrder);
+        if (resolvedGroup.length()) {
+          manager.addLiveGroup(resolvedPage.c_str(), resolvedCard.c_str(), resolvedGroup.c_str(), groupOrder);
+        }
+      }
+    }
+
+    // Cppcheck rationale: Preserve the existing instance API for source compatibility.
+    // cppcheck-suppress functionStatic
+    String nextDividerKey() {
+      static uint32_t counter = 0;
+      return String("divider_") + String(counter++);
+    }
+
+    // Cppcheck rationale: Preserve the existing instance API for source compatibility.
+    // cppcheck-suppress functionStatic
+    String nextAutoKey() {
+      static uint32_t counter = 0;
+      return String("field_") + String(counter++);
+    }
+
+    template <typename T>
+    LiveFieldBuilder makeValueBuilder(const char* key, std::function<T()> getter) {
+      RuntimeFieldMeta meta = createBaseMeta(key);
+      if (std::is_same<T, bool>::value) {
+        meta.isBool = true;
+      }
+      if (std::is_same<T, String>::value || std::is_same<T, const char*>::value) {
+        meta.isString = true;
+      }
+      if (std::is_integral<T>::value && !std::is_same<T, bool>::value) {
+        meta.precision = 0;
+      }
+      String keyStr = meta.key;
+      auto provider = [keyStr, getter](JsonObject& data) {
+        data[keyStr] = getter();
+      };
+      std::function<float()> historySource;
+      if constexpr (std::is_arithmetic<T>::value && !std::is_same<T, bool>::value) {
+        historySource = [getter]() { return static_cast<float>(getter()); };
+      }
+      return LiveFieldBuilder(manager.getRuntime(), std::move(meta), provider, sourceGroup, nullptr, std::move(historySource));
+    }
+
+    ConfigManagerClass& manager;
+    String sourceGroup;
+    String pageName;
+    String cardName;
+    String groupName;
+    int pageOrder = -1;
+    int cardOrder = -1;
+    int groupOrder = -1;
+  };
+
+  static constexpr const char* DEFAULT_LAYOUT_NAME = "Default";
+  static constexpr int DEFAULT_LAYOUT_ORDER = 100;
+  static constexpr const char* DEFAULT_LIVE_CARD_NAME = "Live Values";
+
+  enum class SettingsStorageMode : uint8_t {
+    PerKey,
+    Blob
+  };
+
+  struct PersistStats {
+    uint32_t requested = 0; // Persist requests (updateSetting / Config<T>::save)
+    uint32_t coalesced = 0; // Requests merged into an already queued write
+    uint32_t written = 0;   // Values actually written to NVS
+    uint32_t sessions = 0;  // NVS namespace open/close cycles
+  };
+
+  // Totals of BaseSetting::getRamUsage() over all registered settings.
+  struct SettingsRamReport {
+    size_t settings = 0;
+    size_t flashDescriptors = 0; // Settings whose metadata lives in a ConfigDescriptor table
+    size_t objectBytes = 0;
+    size_t heapBytes = 0;
+  };
+
+private:
+  Preferences prefs;
+  std::vector<BaseSetting*> settings;
+  SettingsStorageMode storageMode = SettingsStorageMode::PerKey;
+  uint32_t persistQuietMs = CM_PERSIST_QUIET_MS;
+  std::atomic<bool> persistDirty{false};
+  std::atomic<uint32_t> persistLastChangeMs{0};
+  PersistStats persistStats;
+
+  struct ChangeSubscription {
+    String category; // Empty = any category
+    std::function<void()> callback;
+  };
+  std::vector<ChangeSubscription> changeSubscriptions;
+  uint32_t dispatchedSettingsEpoch = 0;
+
+  // Runs onAnyChange() callbacks from the loop, once per category per epoch advance.
+  void dispatchChangeSubscriptions() {
+    const uint32_t epoch = getSettingsEpoch();
+    if (epoch == dispatchedSettingsEpoch) {
+      return;
+    }
+    const uint32_t since = dispatchedSettingsEpoch;
+    dispatchedSettingsEpoch = epoch;
+    for (const ChangeSubscription& subscription : changeSubscriptions) {
+      for (const BaseSetting* s : settings) {
+        // Wrap-safe "generation > since".
+        if (static_cast<int32_t>(s->getGeneration() - since) <= 0) {
+          continue;
+        }
+        if (subscription.category.isEmpty() || subscription.category == s->getCategory()) {
+          subscription.callback();
+          break;
+        }
+      }
+    }
+  }
+
+  void requestPersist(BaseSetting* setting) {
+    ++persistStats.requested;
+    if (!setting->markPersistPending()) {
+      ++persistStats.coalesced;
+    }
+    persistLastChangeMs = millis();
+    persistDirty = true;
+  }
+
+  void saveToPrefs(BaseSetting* setting) {
+    if (!setting->needsSave()) {
+      return;
+    }
+    setting->save(prefs);
+    if (!setting->needsSave()) {
+      ++persistStats.written;
+    }
+  }
+
+  bool usesBlob(const BaseSetting* setting) const {
+    return storageMode == SettingsStorageMode::Blob && setting->shouldPersist() && setting->supportsBinary() && !setting->hasError();
+  }
+
+  // Writes queued (onlyPending) or all modified settings inside an open prefs session.
+  void commitSettings(bool onlyPending) {
+    bool blobDirty = false;
+    for (BaseSetting* s : settings) {
+      if (!s->shouldPersist() || (onlyPending && !s->isPersistPending())) {
+        continue;
+      }
+      // Clear before writing so a change racing in from the web task stays queued.
+      s->clearPersistPending();
+      if (usesBlob(s)) {
+        blobDirty = blobDirty || s->needsSave();
+      } else {
+        saveToPrefs(s);
+      }
+    }
+    if (blobDirty) {
+      writeSettingsBlob();
+    }
+  }
+
+  uint32_t settingsSchemaHash() const {
+    uint64_t hash = CM_FNV1A_64_OFFSET;
+    for (const BaseSetting* s : settings) {
+      if (!usesBlob(s)) {
+        continue;
+      }
+      const uint8_t type = static_cast<uint8_t>(s->getType());
+      hash = fnv1aHash64(s->getKey(), strlen(s->getKey()), hash);
+      hash = fnv1aHash64(reinterpret_cast<const char*>(&type), 1, hash);
+    }
+    return static_cast<uint32_t>(hash ^ (hash >> 32));
+  }
+
+  bool writeSettingsBlob() {
+    std::vector<uint8_t> blob(cm::storage::BLOB_HEADER_SIZE);
+    cm::storage::BlobWriter writer(blob);
+    cm::storage::BlobHeader header;
+    uint32_t dirtyCount = 0;
+    for (BaseSetting* s : settings) {
+      if (!usesBlob(s)) {
+        continue;
+      }
+      writer.u32(s->getKeyHash());
+      writer.u8(static_cast<uint8_t>(s->getType()));
+      s->encodeBinary(writer);
+      ++header.count;
+      if (s->needsSave()) {
+        ++dirtyCount;
+      }
+    }
+    header.schemaHash = settingsSchemaHash();
+    header.payloadLen = static_cast<uint32_t>(blob.size() - cm::storage::BLOB_HEADER_SIZE);
+    header.crc = cm::storage::crc32(blob.data() + cm::storage::BLOB_HEADER_SIZE, header.payloadLen);
+    cm::storage::writeHeader(blob.data(), header);
+
+    if (prefs.putBytes(cm::storage::BLOB_PREFS_KEY, blob.data(), blob.size()) != blob.size()) {
+      CM_CORE_LOG("[E] Settings snapshot write failed (%u bytes)", static_cast<unsigned>(blob.size()));
+      return false;
+    }
+    for (BaseSetting* s : settings) {
+      if (usesBlob(s)) {
+        s->markPersisted();
+      }
+    }
+    persistStats.written += dirtyCount;
+    return true;
+  }
 
-      return meta;
+  static bool skipBlobValue(cm::storage::BlobReader& reader, uint8_t type) {
+    switch (static_cast<SettingType>(type)) {
+      case SettingType::BOOL:
+        return reader.skip(1);
+      case SettingType::INT:
+      case SettingType::FLOAT:
+        return reader.skip(4);
+      case SettingType::STRING:
+      case SettingType::PASSWORD: {
+        uint16_t len = 0;
+        return reader.u16(len) && reader.skip(len);
+      }
     }
+    return false;
+  }
 
-    RuntimeFieldMeta createBaseMeta(const String& key) {
-      return createBaseMeta(key.c_str());
+  // Decodes the snapshot into matching settings and flags them in `loaded`.
+  // Returns true when the stored schema matches the registered settings exactly.
+  bool decodeSettingsBlob(const std::vector<uint8_t>& blob, std::vector<bool>& loaded) {
+    cm::storage::BlobHeader header;
+    const uint8_t* payload = nullptr;
+    if (!cm::storage::readHeader(blob.data(), blob.size(), header, payload)) {
+      CM_CORE_LOG("[W] Settings snapshot invalid (len=%u), falling back to per-key storage", static_cast<unsigned>(blob.size()));
+      return false;
     }
 
-    void resolveLayout(String& resolvedPage, String& resolvedCard, String& resolvedGroup) {
-      const bool hasPage = pageName.length() > 0;
-      resolvedPage = hasPage ? pageName : String();
-      if (cardName.length()) {
-        resolvedCard = cardName;
-      } else if (hasPage) {
-        resolvedCard = resolvedPage;
-      } else {
-        resolvedCard = String();
+    cm::storage::BlobReader reader(payload, header.payloadLen);
+    size_t cursor = 0;
+    for (uint16_t entry = 0; entry < header.count && reader.ok(); ++entry) {
+      uint32_t keyHash = 0;
+      uint8_t type = 0;
+      if (!reader.u32(keyHash) || !reader.u8(type)) {
+        break;
       }
-      resolvedGroup = groupName;
 
-      if (hasPage) {
-        manager.addLivePage(resolvedPage.c_str(), pageOrder);
-        manager.addLiveCard(resolvedPage.c_str(), resolvedCard.c_str(), cardOrder);
-        if (resolvedGroup.length()) {
-          manager.addLiveGroup(resolvedPage.c_str(), resolvedCard.c_str(), resolvedGroup.c_str(), groupOrder);
+      // Fast path: entries follow registration order. Otherwise match by key hash.
+      while (cursor < settings.size() && !usesBlob(settings[cursor])) {
+        ++cursor;
+      }
+      size_t target = settings.size();
+      if (cursor < settings.size() && settings[cursor]->getKeyHash() == keyHash) {
+        target = cursor++;
+      } else {
+        for (size_t i = 0; i < settings.size(); ++i) {
+          if (!loaded[i] && usesBlob(settings[i]) && settings[i]->getKeyHash() == keyHash) {
+            target = i;
+            break;
+          }
         }
       }
-    }
 
-    // Cppcheck rationale: Preserve the existing instance API for source compatibility.
-    // cppcheck-suppress functionStatic
-    String nextDividerKey() {
-      static uint32_t counter = 0;
-      return String("divider_") + String(counter++);
+      if (target < settings.size() && static_cast<uint8_t>(settings[target]->getType()) == type) {
+        if (!settings[target]->decodeBinary(reader)) {
+          break;
+        }
+        loaded[target] = true;
+      } else if (!skipBlobValue(reader, type)) {
+        break;
+      }
     }
+    return reader.ok() && header.schemaHash == settingsSchemaHash();
+  }
 
-    // Cppcheck rationale: Preserve the existing instance API for source compatibility.
-    // cppcheck-suppress functionStatic
-    String nextAutoKey() {
-      static uint32_t counter = 0;
-      return String("field_") + String(counter++);
+  void loadAllFromBlob() {
+    std::vector<bool> loaded(settings.size(), false);
+    bool schemaMatches = false;
+    const size_t blobLen = prefs.getBytesLength(cm::storage::BLOB_PREFS_KEY);
+    if (blobLen > 0) {
+      std::vector<uint8_t> blob(blobLen);
+      if (prefs.getBytes(cm::storage::BLOB_PREFS_KEY, blob.data(), blobLen) == blobLen) {
+        schemaMatches = decodeSettingsBlob(blob, loaded);
+      }
     }
 
-    template <typename T>
-    LiveFieldBuilder makeValueBuilder(const char* key, std::function<T()> getter) {
-      RuntimeFieldMeta meta = createBaseMeta(key);
-      if (std::is_same<T, bool>::value) {
-        meta.isBool = true;
+    bool rewrite = !schemaMatches;
+    for (size_t i = 0; i < settings.size(); ++i) {
+      BaseSetting* s = settings[i];
+      if (!s->shouldPersist() || loaded[i]) {
+        continue;
       }
-      if (std::is_same<T, String>::value || std::is_same<T, const char*>::value) {
-        meta.isString = true;
+      if (!usesBlob(s)) {
+        s->load(prefs);
+        continue;
       }
-      if (std::is_integral<T>::value && !std::is_same<T, bool>::value) {
-        meta.precision = 0;
+      // Not in the snapshot: migrate a per-key value if present, else start from the default.
+      if (prefs.isKey(s->getKey())) {
+        s->load(prefs);
+      } else {
+        s->setDefault();
       }
-      String keyStr = meta.key;
-      auto provider = [keyStr, getter](JsonObject& data) {
-        data[keyStr] = getter();
-      };
-      return LiveFieldBuilder(manager.getRuntime(), std::move(meta), provider, sourceGroup);
+      rewrite = true;
     }
 
-    ConfigManagerClass& manager;
-    String sourceGroup;
-    String pageName;
-    String cardName;
-    String groupName;
-    int pageOrder = -1;
-    int cardOrder = -1;
-    int groupOrder = -1;
-  };
-
-  static constexpr const char* DEFAULT_LAYOUT_NAME = "Default";
-  static constexpr int DEFAULT_LAYOUT_ORDER = 100;
-  static constexpr const char* DEFAULT_LIVE_CARD_NAME = "Live Values";
+    if (rewrite) {
+      CM_CORE_LOG("[I] Rewriting settings snapshot (schema %s)", schemaMatches ? "unchanged" : "changed");
+      writeSettingsBlob();
+    }
+  }
 
-private:
-  Preferences prefs;
-  std::vector<BaseSetting*> settings;
+  void servicePersistence() {
+    if (!persistDirty) {
+      return;
+    }
+    if (static_cast<uint32_t>(millis() - persistLastChangeMs) < persistQuietMs) {
+      return;
+    }
+    flush();
+  }
   std::vector<std::unique_ptr<BaseSetting>> ownedSettings;
+  SettingLookupIndex<BaseSetting> settingIndex;
   String appName;
   String appTitle;
   String appVersion;
@@ -1529,26 +2501,173 @@ private:
     return false;
   }
 
+  // Case-insensitive substring test without temporaries (used by the OTA heuristics).
+  static bool containsNoCase(const char* hay, const char* needle) {
+    if (!hay || !needle) {
+      return false;
+    }
+    const size_t needleLen = strlen(needle);
+    for (; *hay; ++hay) {
+      if (strncasecmp(hay, needle, needleLen) == 0) {
+        return true;
+      }
+    }
+    return needleLen == 0;
+  }
+
+  // Shared implementation of applySetting() / updateSetting() / applySettingValue().
+  // The value is parsed by the setting's typed fromString(); only IO pin validation and
+  // the OTA password side effect need a String copy.
+  bool assignSetting(const String& category, const String& key, const char* value, size_t len, bool persist) {
+    BaseSetting* setting = findSetting(category, key);
+    if (!setting) {
+      CM_CORE_LOG("[ERROR] Setting not found: %s.%s", category.c_str(), key.c_str());
+      return false;
+    }
+
+    if (!ioPinRoles.empty()) {
+      String text;
+      text.concat(value, len);
+      if (shouldBlockIOPinChange(setting, category, key, text, !persist)) {
+        return false;
+      }
+    }
+
+    if (!setting->fromString(value, len)) {
+      CM_CORE_LOG("[W] Rejected value for %s.%s (%s)", category.c_str(), key.c_str(), persist ? "save" : "apply");
+      return false;
+    }
+
+    if (persist) {
+      if (setting->shouldPersist()) {
+        requestPersist(setting);
+        if (persistQuietMs == 0 && !flush()) {
+          CM_CORE_LOG("[ERROR] Failed to open preferences for saving");
+          return false;
+        }
+        CM_CORE_LOG_VERBOSE("[D] Setting %s.%s queued for flash storage (quiet=%lu ms)",
+                            category.c_str(),
+                            key.c_str(),
+                            static_cast<unsigned long>(persistQuietMs));
+      } else {
+        CM_CORE_LOG_VERBOSE("[D] Setting %s.%s is non-persistent; skipping flash save", category.c_str(), key.c_str());
+      }
+    } else {
+      CM_CORE_LOG_VERBOSE("[D] Setting %s.%s applied (memory only)", category.c_str(), key.c_str());
+    }
+
+    applySettingSideEffects(setting, value, len, isOtaPasswordKey(category, key), persist);
+    return true;
+  }
+
+  // Heuristic: treat keys containing both "ota" and "pass" (case-insensitive) as OTA password.
+  // Applies to both HTTP OTA (/ota_update) and ArduinoOTA if initialized.
+  static bool isOtaPasswordKey(const String& category, const String& key) {
+    return containsNoCase(category.c_str(), "system") && containsNoCase(key.c_str(), "ota") && containsNoCase(key.c_str(), "pass");
+  }
+
+  // Side-effects: keep runtime subsystems in sync with specific settings
+  void applySettingSideEffects(const BaseSetting* setting, const char* value, size_t len, bool otaPassword, bool persist) {
+    // Cppcheck rationale: Avoid changing mutable Arduino integration handles without a call-site audit.
+    // cppcheck-suppress constVariablePointer
+    if (BaseSetting* otaEnable = findSettingByKeyHint(setting->getCategory(), "OTAEn"); otaEnable && otaEnable == setting) {
+      if (setting->getType() == SettingType::BOOL) {
+        otaManager.enable(static_cast<const Config<bool>*>(setting)->get());
+      }
+    }
+
+    if (otaPassword) {
+      String password;
+      password.concat(value, len);
+      otaManager.setPassword(password);
+      CM_CORE_LOG("[DEBUG] OTA password (%s) updated via setting '%s.%s' (len=%d)",
+                  persist ? "persisted" : "memory",
+                  setting->getCategory(),
+                  setting->getKey(),
+                  static_cast<int>(len));
+    }
+  }
+
+  // Renders a parsed JSON value as the text fromString() expects and passes it to `fn`.
+  // Strings are passed through as-is; scalars are formatted into a stack buffer, so no
+  // temporary String or JsonDocument is created per setting.
+  template <typename Fn>
+  static bool withValueText(JsonVariantConst value, Fn&& fn) {
+    if (value.is<const char*>()) {
+      const JsonString text = value.as<JsonString>();
+      return fn(text.c_str(), text.size());
+    }
+    if (value.is<bool>()) {
+      const char* text = value.as<bool>() ? "true" : "false";
+      return fn(text, strlen(text));
+    }
+
+    char scratch[24];
+    int len = -1;
+    if (value.is<long>()) {
+      len = snprintf(scratch, sizeof(scratch), "%ld", value.as<long>());
+    } else if (value.is<float>()) {
+      len = snprintf(scratch, sizeof(scratch), "%.9g", static_cast<double>(value.as<float>()));
+    }
+    if (len >= 0 && static_cast<size_t>(len) < sizeof(scratch)) {
+      return fn(static_cast<const char*>(scratch), static_cast<size_t>(len));
+    }
+
+    // Objects, arrays and null keep the legacy behaviour: their JSON text is the value.
+    String text;
+    serializeJson(value, text);
+    return fn(text.c_str(), static_cast<size_t>(text.length()));
+  }
+
+  // Pins of IO pin settings that are staged but not applied yet (see Transaction).
+  using IOPinAssignments = std::vector<std::pair<const BaseSetting*, int>>;
+
+  bool isIOPinSetting(const BaseSetting* setting) const {
+    const char* storageKey = setting ? setting->getKey() : nullptr;
+    return storageKey && storageKey[0] != '\0' && ioPinRoles.find(storageKey) != ioPinRoles.end();
+  }
+
+  // A pin backs at most one IO pin setting. Staged pins replace the live value of their
+  // setting, so a batch is checked against the configuration it produces.
+  void checkIOPinInUse(const BaseSetting* setting, const IOPinAssignments& staged, IOPinValidationResult& result) const {
+    for (const BaseSetting* other : settings) {
+      // IO pin settings come from SettingBuilder<T>, so an INT one is a Config<int>.
+      if (other == setting || other->getType() != SettingType::INT || !isIOPinSetting(other)) {
+        continue;
+      }
+      int pin = static_cast<const Config<int>*>(other)->get();
+      for (const auto& entry : staged) {
+        if (entry.first == other) {
+          pin = entry.second;
+        }
+      }
+      if (pin == result.pin) {
+        result.ok = false;
+        result.severity = ValidationSeverity::Error;
+        result.reason = "Pin already in use";
+        result.detail = String("Pin ") + String(result.pin) + " is already assigned to '" + other->getDisplayName() + "'";
+        return;
+      }
+    }
+  }
+
   // Cppcheck rationale: Preserve the mutable callback and extension contract.
   // cppcheck-suppress constParameterPointer
   bool shouldBlockIOPinChange(BaseSetting* setting,
                               const String& category,
                               const String& key,
                               const String& value,
-                              bool isApply) {
-    if (!setting) {
+                              bool isApply,
+                              const IOPinAssignments& staged = IOPinAssignments()) {
+    if (!isIOPinSetting(setting)) {
       return false;
     }
     const char* storageKey = setting->getKey();
-    if (!storageKey || storageKey[0] == '\0') {
-      return false;
-    }
-    auto it = ioPinRoles.find(storageKey);
-    if (it == ioPinRoles.end()) {
-      return false;
-    }
 
-    const IOPinValidationResult result = validateIOPinSetting(storageKey, value);
+    IOPinValidationResult result = validateIOPinSetting(storageKey, value);
+    if (result.severity != ValidationSeverity::Error) {
+      checkIOPinInUse(setting, staged, result);
+    }
     if (result.ok || result.severity == ValidationSeverity::Ok) {
       return false;
     }
@@ -1645,6 +2764,7 @@ private:
   // Optional user-provided global CSS to inject into the Web UI
   const char* customCss = nullptr;
   size_t customCssLen = 0; // 0 -> treat as null-terminated string
+  uint32_t customCssRevision = 0;
 
   bool guiLoggingEnabled = false;
 
@@ -1706,6 +2826,15 @@ public:
   uint32_t wsInterval = CM_WS_PUSH_INTERVAL_DEFAULT_MS;
 
   unsigned long wsLastPush = 0;
+  std::atomic<bool> wsPushRequested{false};
+  // Delta push: only changed runtime fields, with periodic and on-connect keyframes.
+  bool wsDeltaEnabled = false;
+  uint32_t wsKeyframeInterval = CM_WS_KEYFRAME_INTERVAL_DEFAULT_MS;
+  unsigned long wsLastKeyframe = 0;
+  std::atomic<bool> wsKeyframeRequested{true};
+  unsigned long wsStatsWindowStart = 0;
+  uint32_t wsStatsWindowBytes = 0;
+  uint32_t wsStatsWindowFullBytes = 0;
   std::function<String()> customPayloadBuilder;
   std::vector<std::function<void(AsyncWebSocketClient*)>> wsConnectCallbacks;
   std::vector<std::function<void(AsyncWebSocketClient*)>> wsDisconnectCallbacks;
@@ -1713,14 +2842,43 @@ public:
   struct WsClientInfo {
     uint32_t id;
     unsigned long lastSeen;
+    bool msgpack = false; // Asked for binary MessagePack runtime frames in its hello
+    bool compact = false; // Asked for numeric field IDs instead of keys in its hello
+    // Backpressure: while the client's send queue is at CM_WS_CLIENT_QUEUE_LIMIT its
+    // runtime frames are skipped. Having missed a delta it waits for the next keyframe,
+    // as does a client that has not been sent anything yet.
+    bool stale = true;
+    uint32_t droppedFrames = 0;
+    uint32_t recentFrameBytes[4] = {}; // Sizes of the last frames sent, newest at recentFrameHead
+    uint8_t recentFrameHead = 0;
+
+    void recordFrame(uint32_t bytes) {
+      recentFrameHead = static_cast<uint8_t>((recentFrameHead + 1) % 4);
+      recentFrameBytes[recentFrameHead] = bytes;
+    }
+    // Estimate: the queued messages are the most recent frames.
+    uint32_t queuedBytes(size_t queued) const {
+      uint32_t total = 0;
+      for (size_t i = 0; i < queued && i < 4; ++i) {
+        total += recentFrameBytes[(recentFrameHead + 4 - i) % 4];
+      }
+      return total;
+    }
   };
+  // WebSocket events on the async_tcp task add and remove entries and own lastSeen and
+  // the format flags; the loop owns the frame state (stale, droppedFrames, recent frame
+  // sizes). Both sides hold wsClientsMutex only to copy or update entries, never while
+  // calling into `ws`: closing a client can raise its disconnect event on the caller.
   std::vector<WsClientInfo> wsClients;
+  mutable std::mutex wsClientsMutex;
+  std::vector<WsClientInfo> wsLoopClients; // Loop task copy, reused between pushes
   unsigned long wsLastHeartbeat = 0;
   uint32_t wsHeartbeatInterval = 30000; // ms - ping every 30 seconds instead of 15
   uint32_t wsHeartbeatTimeout = 120000; // ms - 2 minutes timeout instead of 45 seconds
   // Cppcheck rationale: Keep allocation-free, early-exit loops on the embedded target.
   // cppcheck-suppress-begin useStlAlgorithm
   void wsMarkSeen(uint32_t id) {
+    std::lock_guard<std::mutex> lock(wsClientsMutex);
     for (auto& c : wsClients) {
       // Cppcheck rationale: Keep the allocation-free, early-exit loop on the embedded target.
       // cppcheck-suppress useStlAlgorithm
@@ -1729,32 +2887,134 @@ public:
         return;
       }
     }
-    wsClients.push_back({id, millis()});
+    WsClientInfo info;
+    info.id = id;
+    info.lastSeen = millis();
+    wsClients.push_back(info);
+  }
+  void wsSetFormat(uint32_t id, bool msgpack, bool compact) {
+    std::lock_guard<std::mutex> lock(wsClientsMutex);
+    for (auto& c : wsClients) {
+      // Cppcheck rationale: Keep the allocation-free, early-exit loop on the embedded target.
+      // cppcheck-suppress useStlAlgorithm
+      if (c.id == id) {
+        c.msgpack = msgpack;
+        c.compact = compact;
+        return;
+      }
+    }
+  }
+  // Writes the loop's frame state back to the clients that are still registered.
+  void wsStoreFrameState_(const std::vector<WsClientInfo>& updated) {
+    std::lock_guard<std::mutex> lock(wsClientsMutex);
+    for (auto& c : wsClients) {
+      for (const auto& u : updated) {
+        // Cppcheck rationale: Keep the allocation-free, early-exit loop on the embedded target.
+        // cppcheck-suppress useStlAlgorithm
+        if (u.id == c.id) {
+          c.stale = u.stale;
+          c.droppedFrames = u.droppedFrames;
+          memcpy(c.recentFrameBytes, u.recentFrameBytes, sizeof(c.recentFrameBytes));
+          c.recentFrameHead = u.recentFrameHead;
+          break;
+        }
+      }
+    }
   }
   // Cppcheck rationale: End the local embedded-loop exception.
   // cppcheck-suppress-end useStlAlgorithm
+  void wsCopyClients_(std::vector<WsClientInfo>& out) const {
+    std::lock_guard<std::mutex> lock(wsClientsMutex);
+    out = wsClients;
+  }
+  // Client hello: {"type":"hello","format":"msgpack"|"json","compact":true|false}
+  // selects the runtime frame encoding.
+  void wsHandleHello(uint32_t id, const uint8_t* data, size_t len) {
+    JsonDocument hello;
+    if (deserializeJson(hello, data, len) != DeserializationError::Ok || hello["type"] != "hello") {
+      return;
+    }
+    const char* format = hello["format"] | "json";
+    wsSetFormat(id, strcmp(format, "msgpack") == 0, hello["compact"] | false);
+    wsMarkSeen(id);
+  }
+  // Runtime action commands (see RuntimeCommandQueue::parse()); posted to the loop
+  // mailbox and dispatched by dispatchRuntimeActions_().
+  std::atomic<uint32_t> wsCommandsReceived{0};
+  std::atomic<uint32_t> wsCommandsRejected{0};
+  uint32_t wsCommandsCoalesced = 0; // Loop task only
+  uint32_t wsCommandsDispatched = 0;
+  uint32_t wsCommandLastLatencyUs = 0;
+  uint32_t wsCommandMaxLatencyUs = 0;
+
+  static void wsSendCommandAck(AsyncWebSocketClient* client, uint32_t seq, const char* error) {
+    if (!client || client->queueIsFull()) {
+      return;
+    }
+    char ack[72];
+    if (error) {
+      snprintf(ack, sizeof(ack), "{\"type\":\"ack\",\"seq\":%lu,\"ok\":false,\"error\":\"%s\"}", (unsigned long)seq, error);
+    } else {
+      snprintf(ack, sizeof(ack), "{\"type\":\"ack\",\"seq\":%lu,\"ok\":true}", (unsigned long)seq);
+    }
+    client->text(ack);
+  }
+  // Runs on the async_tcp task: only parses and posts to the loop. Invalid commands
+  // and a full mailbox are acknowledged right away with ok:false.
+  void wsHandleCommand(AsyncWebSocketClient* client, const uint8_t* data, size_t len) {
+    wsCommandsReceived.fetch_add(1, std::memory_order_relaxed);
+    wsMarkSeen(client->id());
+    LoopMutation mutation;
+    mutation.kind = LoopMutation::Kind::RuntimeAction;
+    if (!cm::web::RuntimeCommandQueue::parse(data, len, mutation.action)) {
+      wsCommandsRejected.fetch_add(1, std::memory_order_relaxed);
+      wsSendCommandAck(client, mutation.action.seq, "invalid");
+      return;
+    }
+    mutation.action.clientId = client->id();
+    const uint32_t seq = mutation.action.seq;
+    if (!postToLoop(std::move(mutation))) {
+      wsCommandsRejected.fetch_add(1, std::memory_order_relaxed);
+      wsSendCommandAck(client, seq, "busy");
+    }
+  }
   void wsRemove(uint32_t id) {
+    std::lock_guard<std::mutex> lock(wsClientsMutex);
     wsClients.erase(std::remove_if(wsClients.begin(), wsClients.end(), [id](const WsClientInfo& c) { return c.id == id; }), wsClients.end());
   }
   void wsHeartbeatMaintenance() {
     if (!wsEnabled || !ws)
       return;
     const unsigned long now = millis();
+    wsCopyClients_(wsLoopClients);
     if (now - wsLastHeartbeat >= wsHeartbeatInterval) {
       wsLastHeartbeat = now;
-      if (ws->availableForWriteAll()) {
-        ws->textAll("__ping"); // application-level ping
+      // Application-level ping; a client with a full queue is not pinged.
+      for (const auto& c : wsLoopClients) {
+        AsyncWebSocketClient* client = ws->client(c.id);
+        if (client && !client->queueIsFull()) {
+          client->text("__ping");
+        }
       }
     }
     // Drop stale clients
-    for (const auto& c : wsClients) {
-      if (now - c.lastSeen > wsHeartbeatTimeout) {
-        if (auto* cl = ws->client(c.id))
-          cl->close();
+    bool anyGone = false;
+    for (const auto& c : wsLoopClients) {
+      AsyncWebSocketClient* cl = ws->client(c.id);
+      if (!cl) {
+        anyGone = true;
+      } else if (now - c.lastSeen > wsHeartbeatTimeout) {
+        cl->close();
       }
     }
     // cleanup removed
-    wsClients.erase(std::remove_if(wsClients.begin(), wsClients.end(), [this](const WsClientInfo& c) { return ws->client(c.id) == nullptr; }), wsClients.end());
+    if (anyGone) {
+      for (const auto& c : wsLoopClients) {
+        if (!ws->client(c.id)) {
+          wsRemove(c.id);
+        }
+      }
+    }
     ws->cleanupClients();
   }
 #endif
@@ -1766,13 +3026,13 @@ public:
       [this]() { return toJSON(true); },                            // config JSON - include secrets for web interface
       [this]() { return runtimeManager.runtimeValuesToJSON(); },    // runtime JSON
       [this]() { return runtimeManager.runtimeMetaJsonPayload(); }, // runtime meta JSON
-      [this]() { reboot(); },                                       // reboot callback
-      [this]() { for (const auto &entry : settings) entry->setDefault(); saveAll(); },                                                 // reset callback
+      [this]() { rebootRequested.store(true, std::memory_order_release); }, // reboot callback
+      [this]() { resetRequested.store(true, std::memory_order_release); },  // reset callback
       [this](const String& group, const String& key, const String& value) -> bool {
-        return updateSetting(group, key, value); // Save to flash
+        return postSettingToLoop(group, key, value, true); // Save to flash
       },
       [this](const String& group, const String& key, const String& value) -> bool {
-        return applySetting(group, key, value); // Memory only
+        return postSettingToLoop(group, key, value, false); // Memory only
       });
   }
 
@@ -1789,22 +3049,20 @@ public:
 
   // Settings management
   BaseSetting* findSetting(const String& category, const String& key) {
-    for (BaseSetting* setting : settings) {
-      if (String(setting->getCategory()) == category) {
-        if (String(setting->getKey()) == key) {
-          return setting;
-        }
-      }
-    }
-    return nullptr;
+    return settingIndex.find(category.c_str(), category.length(), key.c_str(), key.length());
+  }
+
+  BaseSetting* findSetting(const char* category, const char* key) {
+    return settingIndex.find(category, key);
   }
 
   BaseSetting* findSettingByKeyHint(const String& category, const char* keyHint) {
     if (!keyHint || !keyHint[0]) {
       return nullptr;
     }
-    const String hashedKey = hashStringForStorage(String(keyHint));
-    return findSetting(category, hashedKey);
+    char hashedKey[CM_STORAGE_KEY_BUFFER_SIZE];
+    formatStorageKey(keyHint, strlen(keyHint), hashedKey);
+    return settingIndex.find(category.c_str(), category.length(), hashedKey, strlen(hashedKey));
   }
 
   BaseSetting* addSetting(std::unique_ptr<BaseSetting> setting) {
@@ -1818,7 +3076,9 @@ public:
     BaseSetting* raw = ownedSettings.back().get();
     raw->setLogger([](const char* msg) { CM_CORE_LOG("%s", msg); });
     settings.push_back(raw);
+    settingIndex.insert(raw);
     registerSettingPlacement(raw);
+    raw->bumpGeneration(); // Registration changes the settings set, so observers re-read it
     return raw;
   }
 
@@ -1831,7 +3091,9 @@ public:
     }
     setting->setLogger([](const char* msg) { CM_CORE_LOG("%s", msg); });
     settings.push_back(setting);
+    settingIndex.insert(setting);
     registerSettingPlacement(setting);
+    setting->bumpGeneration(); // Registration changes the settings set, so observers re-read it
     return setting;
   }
 
@@ -1855,6 +3117,37 @@ public:
     }
   }
 
+  SettingsRamReport getSettingsRamReport() const {
+    SettingsRamReport report;
+    for (const BaseSetting* s : settings) {
+      const SettingRamUsage usage = s->getRamUsage();
+      ++report.settings;
+      report.flashDescriptors += usage.flashDescriptor ? 1 : 0;
+      report.objectBytes += usage.objectBytes;
+      report.heapBytes += usage.heapBytes;
+    }
+    return report;
+  }
+
+  // One line per setting plus totals, e.g. printSettingsRamReport(Serial).
+  void printSettingsRamReport(Print& out) const {
+    for (const BaseSetting* s : settings) {
+      const SettingRamUsage usage = s->getRamUsage();
+      out.printf("%-12s %-20s object=%3u heap=%3u %s\n",
+                 s->getCategory(),
+                 s->getDisplayName(),
+                 static_cast<unsigned>(usage.objectBytes),
+                 static_cast<unsigned>(usage.heapBytes),
+                 usage.flashDescriptor ? "flash" : "ram");
+    }
+    const SettingsRamReport report = getSettingsRamReport();
+    out.printf("settings=%u flash_descriptors=%u object_bytes=%u heap_bytes=%u\n",
+               static_cast<unsigned>(report.settings),
+               static_cast<unsigned>(report.flashDescriptors),
+               static_cast<unsigned>(report.objectBytes),
+               static_cast<unsigned>(report.heapBytes));
+  }
+
   // Layout registries (Settings + Live)
   void addSettingsPage(const char* pageName, int order);
   void addSettingsCard(const char* pageName, const char* cardName, int order);
@@ -1908,26 +3201,22 @@ public:
       throw std::runtime_error("Failed to initialize preferences");
     }
 
-    for (BaseSetting* s : settings) {
-      if (s->shouldPersist()) {
-        s->load(prefs);
+    if (storageMode == SettingsStorageMode::Blob) {
+      loadAllFromBlob();
+    } else {
+      for (BaseSetting* s : settings) {
+        if (s->shouldPersist()) {
+          s->load(prefs);
+        }
       }
     }
     prefs.end();
 
     // After loading persisted settings on boot, propagate important runtime-affecting values
     // so subsystems (like OTA) reflect saved configuration immediately.
-    auto containsNoCase = [](const String& hay, const char* needle) {
-      String h = hay;
-      h.toLowerCase();
-      String n = String(needle);
-      n.toLowerCase();
-      return h.indexOf(n) >= 0;
-    };
-
     for (BaseSetting* s : settings) {
-      String cat = s->getCategory();
-      String key = s->getDisplayName();
+      const char* cat = s->getCategory();
+      const char* key = s->getDisplayName();
 
       // System OTA password at boot
       if (containsNoCase(cat, "system") && containsNoCase(key, "ota") && containsNoCase(key, "pass")) {
@@ -1947,201 +3236,487 @@ public:
   }
 
   void saveAll() {
+    persistDirty = false;
     if (!prefs.begin("ConfigManager", false)) {
       CM_CORE_LOG("[E] Failed to open preferences for writing");
       return;
     }
+    ++persistStats.sessions;
 
-    for (BaseSetting* s : settings) {
-      if (!s->shouldPersist()) {
-        continue;
+    commitSettings(false);
+    prefs.end();
+  }
+
+  // Storage mode: PerKey stores one NVS key per setting (default). Blob stores all
+  // binary-capable settings in one CRC-protected snapshot, so loadAll() is one read.
+  // Switching to Blob migrates existing per-key values on the next loadAll().
+  void setSettingsStorageMode(SettingsStorageMode mode) {
+    storageMode = mode;
+  }
+  SettingsStorageMode getSettingsStorageMode() const {
+    return storageMode;
+  }
+
+  // Write-behind persistence
+  // updateSetting() and Config<T>::save() queue the setting; queued settings are written
+  // in one NVS session once no new change arrived for the quiet period (0 = immediately).
+  void setPersistQuietPeriod(uint32_t quietMs) {
+    persistQuietMs = quietMs;
+  }
+  uint32_t getPersistQuietPeriod() const {
+    return persistQuietMs;
+  }
+  bool hasPendingWrites() const {
+    return persistDirty;
+  }
+  const PersistStats& getPersistStats() const {
+    return persistStats;
+  }
+  void resetPersistStats() {
+    persistStats = PersistStats{};
+  }
+
+  // Settings epoch: advances whenever any setting value changes. Subsystems cache it and
+  // skip re-reading their settings while it is unchanged.
+  static uint32_t getSettingsEpoch() {
+    return BaseSetting::currentSettingsEpoch();
+  }
+
+  // Calls `callback` from handleClient() after any setting of `category` changed
+  // (nullptr or "" = any category). Several changes between two loops coalesce into one call.
+  void onAnyChange(const char* category, std::function<void()> callback) {
+    if (!callback) {
+      return;
+    }
+    if (changeSubscriptions.empty()) {
+      dispatchedSettingsEpoch = getSettingsEpoch();
+    }
+    changeSubscriptions.push_back(ChangeSubscription{String(category ? category : ""), std::move(callback)});
+  }
+
+  // Commits all queued settings now. Called automatically before reboot and OTA.
+  bool flush() {
+    if (!persistDirty.exchange(false)) {
+      return true;
+    }
+    if (!prefs.begin("ConfigManager", false)) {
+      persistDirty = true;
+      CM_CORE_LOG("[E] Failed to open preferences for flush");
+      return false;
+    }
+    ++persistStats.sessions;
+
+    commitSettings(true);
+    prefs.end();
+    CM_CORE_LOG_VERBOSE("[D] Flushed settings (sessions=%u written=%u coalesced=%u)",
+                        static_cast<unsigned>(persistStats.sessions),
+                        static_cast<unsigned>(persistStats.written),
+                        static_cast<unsigned>(persistStats.coalesced));
+    return true;
+  }
+
+  // Apply setting to memory only (temporary, lost after reboot)
+  bool applySetting(const String& category, const String& key, const String& value) {
+    return assignSetting(category, key, value.c_str(), value.length(), false);
+  }
+
+  // Update setting and save to flash (persistent)
+  bool updateSetting(const String& category, const String& key, const String& value) {
+    return assignSetting(category, key, value.c_str(), value.length(), true);
+  }
+
+  // Variant entry point for single parsed JSON values; avoids a String per scalar.
+  bool applySettingValue(const String& category, const String& key, JsonVariantConst value, bool persist) {
+    return withValueText(value, [&](const char* text, size_t len) {
+      return assignSetting(category, key, text, len, persist);
+    });
+  }
+
+  // All-or-nothing batch of setting changes (used by /config/apply_all and /config/save_all).
+  //
+  //   auto tx = ConfigManager.beginTransaction();
+  //   tx.stage("WiFi", "ssid", "home");
+  //   tx.stage("WiFi", "dhcp", "false");
+  //   tx.commit(); // or rollback(); destruction without commit() rolls back
+  //
+  // stage() validates the value (type parse, IO pin rules) without touching the setting.
+  // commit() refuses if any stage() failed; otherwise it applies every value, queues the
+  // persistent ones for a single NVS session, and only then runs the change callbacks.
+  class Transaction {
+  public:
+    Transaction(ConfigManagerClass& owner, bool persistValues)
+        : manager(owner), persist(persistValues) {
+    }
+    Transaction(const Transaction&) = delete;
+    Transaction& operator=(const Transaction&) = delete;
+    ~Transaction() {
+      rollback();
+    }
+
+    bool stage(const String& category, const String& key, const char* value, size_t len) {
+      if (!open) {
+        return false;
       }
-      if (s->needsSave()) {
-        s->save(prefs);
+      BaseSetting* setting = manager.findSetting(category, key);
+      if (!setting) {
+        CM_CORE_LOG("[ERROR] Setting not found: %s.%s", category.c_str(), key.c_str());
+        return reject();
+      }
+      if (!setting->acceptsString(value, len)) {
+        CM_CORE_LOG("[W] Rejected value for %s.%s (%s)", category.c_str(), key.c_str(), persist ? "save" : "apply");
+        return reject();
       }
+      StagedValue entry;
+      entry.setting = setting;
+      entry.value.concat(value, len);
+      entry.otaPassword = isOtaPasswordKey(category, key);
+      if (manager.isIOPinSetting(setting)) {
+        // Checked in validateIOPins() once the whole batch is staged.
+        entry.category = category;
+        entry.key = key;
+        ioPinsChecked = false;
+      }
+      staged.push_back(std::move(entry));
+      return true;
     }
-    prefs.end();
-  }
-
-  // Apply setting to memory only (temporary, lost after reboot)
-  bool applySetting(const String& category, const String& key, const String& value) {
-    CM_CORE_LOG("[DEBUG] applySetting called (memory only): category='%s', key='%s', value='%s'",
-                category.c_str(),
-                key.c_str(),
-                value.c_str());
-
-    BaseSetting* setting = findSetting(category, key);
-    if (!setting) {
-      CM_CORE_LOG("[ERROR] Setting not found: %s.%s", category.c_str(), key.c_str());
-      return false;
+    bool stage(const String& category, const String& key, const String& value) {
+      return stage(category, key, value.c_str(), value.length());
     }
-
-    if (shouldBlockIOPinChange(setting, category, key, value, true)) {
-      return false;
+    bool stage(const String& category, const String& key, JsonVariantConst value) {
+      return withValueText(value, [&](const char* text, size_t len) {
+        return stage(category, key, text, len);
+      });
     }
 
-    CM_CORE_LOG("[DEBUG] Found setting: %s.%s (storage key: %s)",
-                setting->getCategory(),
-                setting->getDisplayName(),
-                setting->getName());
-
-    DynamicJsonDocument doc(256);
-
-    // Convert string value to appropriate JSON type based on setting type
-    if (value == "true") {
-      doc.set(true);
-    } else if (value == "false") {
-      doc.set(false);
-    } else {
-      // Try to parse as number first, then fallback to string
-      char* endPtr;
-      long longVal = strtol(value.c_str(), &endPtr, 10);
-      if (*endPtr == '\0') {
-        // Successfully parsed as integer
-        doc.set((int)longVal);
-      } else {
-        // Try as float
-        float floatVal = strtof(value.c_str(), &endPtr);
-        if (*endPtr == '\0') {
-          // Successfully parsed as float
-          doc.set(floatVal);
-        } else {
-          // Use as string
-          doc.set(value);
+    // Checks the staged IO pins against the configuration the transaction produces:
+    // swapping two pins passes, two staged settings on one pin fail. Call it after the
+    // last stage() (in the request context, for the pin warning popup); commit() calls
+    // it otherwise. Returns the number of pins rejected.
+    size_t validateIOPins() {
+      if (ioPinsChecked) {
+        return 0;
+      }
+      ioPinsChecked = true;
+      ConfigManagerClass::IOPinAssignments pins;
+      for (const StagedValue& entry : staged) {
+        if (entry.key.length() > 0) {
+          pins.emplace_back(entry.setting, static_cast<int>(strtol(entry.value.c_str(), nullptr, 10)));
+        }
+      }
+      size_t blocked = 0;
+      for (const StagedValue& entry : staged) {
+        if (entry.key.length() > 0 && manager.shouldBlockIOPinChange(entry.setting, entry.category, entry.key, entry.value, !persist, pins)) {
+          reject();
+          ++blocked;
         }
       }
+      return blocked;
     }
 
-    bool result = setting->fromJSON(doc.as<JsonVariant>());
+    // Applies the staged values. Returns false, with nothing applied, if a value was
+    // rejected. Also returns false if saving to flash failed: the values are then
+    // applied in memory and stay queued for the next flush(), as with updateSetting().
+    bool commit() {
+      if (!open) {
+        return false;
+      }
+      validateIOPins();
+      if (failed) {
+        CM_CORE_LOG("[W] Transaction rolled back: %u staged, %u rejected",
+                    static_cast<unsigned>(staged.size()),
+                    static_cast<unsigned>(rejected));
+        rollback();
+        return false;
+      }
+      open = false;
 
-    // Side-effects: keep runtime subsystems in sync with specific settings
-    if (result) {
-      // Cppcheck rationale: Avoid changing mutable Arduino integration handles without a call-site audit.
-      // cppcheck-suppress constVariablePointer
-      if (BaseSetting* otaEnable = findSettingByKeyHint(category, "OTAEn"); otaEnable && otaEnable == setting) {
-        if (setting->getType() == SettingType::BOOL) {
-          otaManager.enable(static_cast<Config<bool>*>(setting)->get());
+      for (StagedValue& entry : staged) {
+        entry.setting->holdCallback();
+      }
+      for (StagedValue& entry : staged) {
+        // Validated in stage(); parsing is deterministic, so this cannot fail.
+        entry.setting->fromString(entry.value.c_str(), entry.value.length());
+        if (persist && entry.setting->shouldPersist()) {
+          manager.requestPersist(entry.setting);
         }
       }
 
-      // Heuristic: treat keys containing both "ota" and "pass" (case-insensitive) as OTA password
-      auto containsNoCase = [](const String& hay, const char* needle) {
-        String h = hay;
-        h.toLowerCase();
-        String n = String(needle);
-        n.toLowerCase();
-        return h.indexOf(n) >= 0;
-      };
-      if (containsNoCase(category, "system") && containsNoCase(key, "ota") && containsNoCase(key, "pass")) {
-        // Apply immediately to OTA manager; this affects both HTTP OTA (/ota_update) and ArduinoOTA if initialized
-        otaManager.setPassword(value);
-        CM_CORE_LOG("[DEBUG] OTA password (memory) updated via setting '%s.%s' (len=%d)", category.c_str(), key.c_str(), (int)value.length());
+      bool persisted = true;
+      if (persist && manager.persistQuietMs == 0 && !manager.flush()) {
+        CM_CORE_LOG("[ERROR] Failed to open preferences for saving");
+        persisted = false;
+      }
+
+      for (StagedValue& entry : staged) {
+        manager.applySettingSideEffects(entry.setting, entry.value.c_str(), entry.value.length(), entry.otaPassword, persist);
+      }
+      for (StagedValue& entry : staged) {
+        entry.setting->releaseCallback();
       }
+      CM_CORE_LOG_VERBOSE("[D] Transaction committed %u settings (%s)",
+                          static_cast<unsigned>(staged.size()),
+                          persist ? "save" : "apply");
+      staged.clear();
+      return persisted;
     }
 
-    CM_CORE_LOG("[DEBUG] Setting apply result (memory only): %s", result ? "SUCCESS" : "FAILED");
-    return result;
-  }
+    // Discards all staged values; nothing has been applied yet.
+    void rollback() {
+      open = false;
+      staged.clear();
+    }
 
-  // Update setting and save to flash (persistent)
-  bool updateSetting(const String& category, const String& key, const String& value) {
-    CM_CORE_LOG("[DEBUG] updateSetting called (save to flash): category='%s', key='%s', value='%s'",
-                category.c_str(),
-                key.c_str(),
-                value.c_str());
+    size_t stagedCount() const {
+      return staged.size();
+    }
+    size_t rejectedCount() const {
+      return rejected;
+    }
 
-    BaseSetting* setting = findSetting(category, key);
-    if (!setting) {
-      CM_CORE_LOG("[ERROR] Setting not found: %s.%s", category.c_str(), key.c_str());
+  private:
+    struct StagedValue {
+      BaseSetting* setting = nullptr;
+      String value;
+      bool otaPassword = false;
+      String category; // IO pin settings only (see validateIOPins())
+      String key;
+    };
+
+    ConfigManagerClass& manager;
+    bool persist;
+    bool open = true;
+    bool ioPinsChecked = true;
+    bool failed = false;
+    size_t rejected = 0;
+    std::vector<StagedValue> staged;
+
+    bool reject() {
+      failed = true;
+      ++rejected;
       return false;
     }
+  };
+
+  // persist = false applies in memory only (like applySetting()).
+  Transaction beginTransaction(bool persist = true) {
+    return Transaction(*this, persist);
+  }
+
+  // A change requested by a web handler, applied by handleClient() on the loop task.
+  struct LoopMutation {
+    enum class Kind : uint8_t {
+      None,
+      Settings,      // Staged (validated) transaction, committed on the loop
+      RuntimeAction, // Queued for dispatch; values for the same control are merged
+      GuiAction,
+      ResetDefaults,
+      Reboot,
+    };
+    Kind kind = Kind::None;
+    std::unique_ptr<Transaction> settings;
+    cm::web::RuntimeCommand action;
+    String messageId; // GuiAction
+    String actionId;
+  };
 
-    if (shouldBlockIOPinChange(setting, category, key, value, false)) {
+  // Hands a mutation from the network (async_tcp) task to the loop task through a
+  // lock-free single-producer mailbox: only web handlers may post. Returns false when
+  // CM_LOOP_MAILBOX_SIZE mutations are already waiting.
+  bool postToLoop(LoopMutation&& mutation) {
+    if (!loopMailbox.push(std::move(mutation))) {
+      loopMailboxFull.fetch_add(1, std::memory_order_relaxed);
       return false;
     }
+    loopMailboxPosted.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+  bool postTransactionToLoop(std::unique_ptr<Transaction> tx) {
+    LoopMutation mutation;
+    mutation.kind = LoopMutation::Kind::Settings;
+    mutation.settings = std::move(tx);
+    return postToLoop(std::move(mutation));
+  }
+  // applySetting()/updateSetting() for web handlers: the value is validated now (unknown
+  // setting, type, IO pin rules) and assigned, saved and reported to change callbacks
+  // on the loop task.
+  bool postSettingToLoop(const String& category, const String& key, const String& value, bool persist) {
+    auto tx = std::make_unique<Transaction>(*this, persist);
+    return tx->stage(category, key, value) && tx->validateIOPins() == 0 && postTransactionToLoop(std::move(tx));
+  }
+
+  struct LoopMailboxStats {
+    uint32_t posted = 0;
+    uint32_t full = 0;     // Rejected because the mailbox was full
+    uint32_t applied = 0;
+    uint32_t maxBatch = 0; // Most mutations one handleClient() pass applied
+  };
+  LoopMailboxStats getLoopMailboxStats() const {
+    LoopMailboxStats stats;
+    stats.posted = loopMailboxPosted.load(std::memory_order_relaxed);
+    stats.full = loopMailboxFull.load(std::memory_order_relaxed);
+    stats.applied = loopMailboxApplied;
+    stats.maxBatch = loopMailboxMaxBatch;
+    return stats;
+  }
 
-    CM_CORE_LOG("[DEBUG] Found setting: %s.%s (storage key: %s)",
-                setting->getCategory(),
-                setting->getDisplayName(),
-                setting->getName());
+private:
+  cm::runtime::SpscMailbox<LoopMutation> loopMailbox{CM_LOOP_MAILBOX_SIZE};
+  std::atomic<uint32_t> loopMailboxPosted{0};
+  std::atomic<uint32_t> loopMailboxFull{0};
+  uint32_t loopMailboxApplied = 0;
+  uint32_t loopMailboxMaxBatch = 0;
+  // Runtime actions from the mailbox; values for the same control are merged until
+  // dispatchRuntimeActions_() runs them.
+  cm::web::RuntimeCommandQueue runtimeActionQueue{CM_RUNTIME_ACTION_QUEUE_SIZE};
+  std::vector<cm::web::RuntimeCommand> runtimeActionBatch;
+
+  // Reset and reboot from the web server are flags rather than mailbox entries: they
+  // cannot be refused by a full mailbox and still run on the loop task.
+  std::atomic<bool> resetRequested{false};
+  std::atomic<bool> rebootRequested{false};
+  // flushOnLoop() tickets: the loop flushes when requested != served, then publishes
+  // the ticket it read before flushing.
+  std::atomic<uint32_t> flushRequestedTicket{0};
+  std::atomic<uint32_t> flushServedTicket{0};
+
+  void serviceFlushRequest_() {
+    const uint32_t ticket = flushRequestedTicket.load(std::memory_order_acquire);
+    if (ticket == flushServedTicket.load(std::memory_order_relaxed)) {
+      return;
+    }
+    flush();
+    flushServedTicket.store(ticket, std::memory_order_release);
+  }
 
-    DynamicJsonDocument doc(256);
+  void applyRequestedAction_(std::atomic<bool>& requested, LoopMutation::Kind kind) {
+    if (!requested.exchange(false, std::memory_order_acquire)) {
+      return;
+    }
+    LoopMutation mutation;
+    mutation.kind = kind;
+    applyLoopMutation_(mutation);
+  }
 
-    // Convert string value to appropriate JSON type based on setting type
-    if (value == "true") {
-      CM_CORE_LOG("[DEBUG] Converting string 'true' to boolean true");
-      doc.set(true);
-    } else if (value == "false") {
-      CM_CORE_LOG("[DEBUG] Converting string 'false' to boolean false");
-      doc.set(false);
-    } else {
-      // Try to parse as number first, then fallback to string
-      char* endPtr;
-      long longVal = strtol(value.c_str(), &endPtr, 10);
-      if (*endPtr == '\0') {
-        // Successfully parsed as integer
-        CM_CORE_LOG("[DEBUG] Converting string '%s' to integer %ld", value.c_str(), longVal);
-        doc.set((int)longVal);
-      } else {
-        // Try as float
-        float floatVal = strtof(value.c_str(), &endPtr);
-        if (*endPtr == '\0') {
-          // Successfully parsed as float
-          CM_CORE_LOG("[DEBUG] Converting string '%s' to float %.2f", value.c_str(), floatVal);
-          doc.set(floatVal);
-        } else {
-          // Use as string
-          CM_CORE_LOG("[DEBUG] Using value '%s' as string", value.c_str());
-          doc.set(value);
+  void applyLoopMutation_(LoopMutation& mutation) {
+    switch (mutation.kind) {
+      case LoopMutation::Kind::None:
+        break;
+      case LoopMutation::Kind::Settings:
+        if (mutation.settings && !mutation.settings->commit()) {
+          CM_CORE_LOG("[W] Posted settings change was not saved");
         }
-      }
+        break;
+      case LoopMutation::Kind::RuntimeAction:
+        queueRuntimeAction_(std::move(mutation.action));
+        break;
+      case LoopMutation::Kind::GuiAction:
+        if (!handleGuiAction(mutation.messageId, mutation.actionId)) {
+          CM_CORE_LOG_VERBOSE("[W] GUI action for unknown message %s", mutation.messageId.c_str());
+        }
+        break;
+      case LoopMutation::Kind::ResetDefaults:
+        for (const auto& entry : settings) {
+          entry->setDefault();
+        }
+        saveAll();
+        break;
+      case LoopMutation::Kind::Reboot:
+        reboot();
+        break;
     }
+  }
 
-    CM_CORE_LOG("[DEBUG] JSON document created. Calling fromJSON...");
-    bool result = setting->fromJSON(doc.as<JsonVariant>());
-
-    if (result) {
-      if (setting->shouldPersist()) {
-        // Save the updated setting to flash storage immediately
-        CM_CORE_LOG("[DEBUG] Saving setting to flash storage");
-
-        if (!prefs.begin("ConfigManager", false)) {
-          CM_CORE_LOG("[ERROR] Failed to open preferences for saving");
-          return false;
+  void queueRuntimeAction_(cm::web::RuntimeCommand&& command) {
+    const uint32_t clientId = command.clientId;
+    const uint32_t seq = command.seq;
+    switch (runtimeActionQueue.push(std::move(command))) {
+      case cm::web::RuntimeCommandQueue::PushResult::Queued:
+        break;
+      case cm::web::RuntimeCommandQueue::PushResult::Coalesced:
+#if CM_ENABLE_WS_PUSH
+        if (clientId) {
+          ++wsCommandsCoalesced;
+        }
+#endif
+        break;
+      case cm::web::RuntimeCommandQueue::PushResult::Full:
+        CM_CORE_LOG_VERBOSE("[W] Runtime action queue full, dropped seq %lu", (unsigned long)seq);
+#if CM_ENABLE_WS_PUSH
+        if (clientId) {
+          wsCommandsRejected.fetch_add(1, std::memory_order_relaxed);
         }
-        setting->save(prefs);
-        prefs.end();
+#endif
+        ackRuntimeAction_(clientId, seq, "busy");
+        break;
+    }
+  }
 
-        CM_CORE_LOG("[DEBUG] Setting saved to flash successfully");
-      } else {
-        CM_CORE_LOG("[DEBUG] Setting %s.%s is non-persistent; skipping flash save", category.c_str(), key.c_str());
+  // Runs the queued runtime actions and acknowledges the WebSocket ones with their
+  // sequence number.
+  void dispatchRuntimeActions_() {
+    if (runtimeActionQueue.size() == 0) {
+      return;
+    }
+    runtimeActionQueue.drain(runtimeActionBatch);
+    for (const auto& command : runtimeActionBatch) {
+      const bool ok = cm::web::dispatchRuntimeAction(this, command.kind, command.group, command.key, command.hasValue, command.boolValue, command.intValue, command.floatValue);
+      if (command.clientId) {
+        ackRuntimeAction_(command.clientId, command.seq, ok ? nullptr : "invalid");
       }
-
-      // Side-effects: keep runtime subsystems in sync with specific settings
-      // Cppcheck rationale: Avoid changing mutable Arduino integration handles without a call-site audit.
-      // cppcheck-suppress constVariablePointer
-      if (BaseSetting* otaEnable = findSettingByKeyHint(category, "OTAEn"); otaEnable && otaEnable == setting) {
-        if (setting->getType() == SettingType::BOOL) {
-          otaManager.enable(static_cast<Config<bool>*>(setting)->get());
-        }
+#if CM_ENABLE_WS_PUSH
+      if (command.clientId) {
+        const uint32_t latencyUs = static_cast<uint32_t>(esp_timer_get_time() - command.receivedUs);
+        ++wsCommandsDispatched;
+        wsCommandLastLatencyUs = latencyUs;
+        wsCommandMaxLatencyUs = std::max(wsCommandMaxLatencyUs, latencyUs);
       }
+#endif
+    }
+  }
 
-      // Heuristic: treat keys containing both "ota" and "pass" (case-insensitive) as OTA password
-      auto containsNoCase = [](const String& hay, const char* needle) {
-        String h = hay;
-        h.toLowerCase();
-        String n = String(needle);
-        n.toLowerCase();
-        return h.indexOf(n) >= 0;
-      };
-      if (containsNoCase(category, "system") && containsNoCase(key, "ota") && containsNoCase(key, "pass")) {
-        otaManager.setPassword(value);
-        CM_CORE_LOG("[DEBUG] OTA password (persisted) updated via setting '%s.%s' (len=%d)", category.c_str(), key.c_str(), (int)value.length());
-      }
+  void ackRuntimeAction_(uint32_t clientId, uint32_t seq, const char* error) {
+#if CM_ENABLE_WS_PUSH
+    if (clientId && ws) {
+      wsSendCommandAck(ws->client(clientId), seq, error);
     }
+#else
+    (void)clientId;
+    (void)seq;
+    (void)error;
+#endif
+  }
 
-    CM_CORE_LOG("[DEBUG] Setting update result: %s", result ? "SUCCESS" : "FAILED");
-    return result;
+public:
+  // Applies what web handlers posted since the last call (at most one mailbox worth,
+  // so a flood cannot stall the loop), then dispatches the runtime actions.
+  void handleLoopMailbox() {
+    LoopMutation mutation;
+    uint32_t applied = 0;
+    while (applied < loopMailbox.capacity() && loopMailbox.pop(mutation)) {
+      applyLoopMutation_(mutation);
+      ++applied;
+    }
+    loopMailboxApplied += applied;
+    loopMailboxMaxBatch = std::max(loopMailboxMaxBatch, applied);
+    dispatchRuntimeActions_();
+    applyRequestedAction_(resetRequested, LoopMutation::Kind::ResetDefaults);
+    applyRequestedAction_(rebootRequested, LoopMutation::Kind::Reboot);
+    serviceFlushRequest_();
+  }
+
+  // flush() for other tasks (e.g. an OTA upload on the web server task): flush() is not
+  // thread-safe, so the loop runs it and the caller waits up to timeoutMs for that.
+  // False on timeout; the writes then stay queued for the loop.
+  bool flushOnLoop(uint32_t timeoutMs) {
+    const uint32_t ticket = flushRequestedTicket.fetch_add(1, std::memory_order_acq_rel) + 1;
+    const uint32_t start = millis();
+    while (static_cast<int32_t>(flushServedTicket.load(std::memory_order_acquire) - ticket) < 0) {
+      if (millis() - start >= timeoutMs) {
+        return false;
+      }
+      delay(5);
+    }
+    return true;
   }
 
   void checkSettingsForErrors() {
@@ -2577,7 +4152,13 @@ public:
 
   // Non-blocking client handling
   void handleClient() {
+    CM_LOOP_MARK();
+    CM_LOOP_SCOPE(HandleClient);
     updateLoopTiming();
+    runtimeManager.updateHistory();
+    handleLoopMailbox();
+    servicePersistence();
+    dispatchChangeSubscriptions();
     handleWebsocketPush();
     handleOTA();
   }
@@ -2593,10 +4174,9 @@ public:
 #endif
 
   // System control
-  // Cppcheck rationale: Preserve the existing instance API for source compatibility.
-  // cppcheck-suppress functionStatic
   void reboot() {
     CM_CORE_LOG_VERBOSE("[R] Rebooting...");
+    flush();
     delay(1000);
     ESP.restart();
   }
@@ -2605,6 +4185,7 @@ public:
   void setCustomCss(const char* css, size_t len) {
     customCss = css;
     customCssLen = len;
+    ++customCssRevision;
     CM_CORE_LOG("[I] Custom CSS registered (len=%u)", (unsigned)len);
   }
 
@@ -2614,6 +4195,10 @@ public:
   size_t getCustomCssLen() const {
     return customCss ? (customCssLen ? customCssLen : strlen(customCss)) : 0;
   }
+  // Bumped by setCustomCss(); part of the /user_theme.css ETag.
+  uint32_t getCustomCssRevision() const {
+    return customCssRevision;
+  }
 
   void clearAllFromPrefs() {
     for (const auto& entry : settings) {
@@ -2720,122 +4305,29 @@ public:
     CM_CORE_LOG("[W] stopOTA not implemented in OTAManager");
   }
 
-  // JSON export
+  // JSON export (compact). /config.json streams the same document via cm::web::ConfigJsonStream.
   String toJSON(bool includeSecrets = false) {
-    JsonDocument doc;
-    JsonObject root = doc.to<JsonObject>();
-
-    String catNames[20];
-    int catCount = 0;
-    for (const auto* s : settings) {
-      // Do not pre-filter dynamic visibility here; include all web-visible
-      // settings and let the UI honor the resolved showIf boolean.
-      if (!s->shouldShowInWeb())
-        continue;
-
-      const char* category = s->getCategory();
-      JsonObject catObj;
-
-      bool foundCat = false;
-      for (int i = 0; i < catCount; ++i) {
-        if (catNames[i] == category) {
-          catObj = root[category];
-          foundCat = true;
-          break;
-        }
-      }
-
-      if (!foundCat) {
-        catObj = root.createNestedObject(category);
-        catNames[catCount++] = category;
-
-        const char* prettyName = s->getCategoryPretty();
-        if (prettyName) {
-          catObj["categoryPretty"] = prettyName; // Used by frontend Category.vue
-        }
-      }
-
-      // Optional: card grouping inside the category.
-      // If a setting declares a card, it will be emitted into category.cards[card].settings.
-      // WebUI can render cards as separate Settings panels while keeping the persisted category token stable.
-      JsonObject targetObj = catObj;
-      const char* card = s->getCard();
-      if (card && card[0]) {
-        JsonObject cardsObj;
-        JsonVariant existingCards = catObj["cards"];
-        if (existingCards.isNull()) {
-          cardsObj = catObj.createNestedObject("cards");
-        } else if (existingCards.is<JsonObject>()) {
-          cardsObj = existingCards.as<JsonObject>();
-        } else {
-          catObj.remove("cards");
-          cardsObj = catObj.createNestedObject("cards");
-        }
-
-        JsonObject cardObj;
-        JsonVariant existingCard = cardsObj[card];
-        if (existingCard.isNull()) {
-          cardObj = cardsObj.createNestedObject(card);
-          const char* cardPretty = s->getCardPretty();
-          if (cardPretty && cardPretty[0]) {
-            cardObj["cardPretty"] = cardPretty;
-          }
-          cardObj["cardOrder"] = s->getCardOrder();
-        } else if (existingCard.is<JsonObject>()) {
-          cardObj = existingCard.as<JsonObject>();
-        } else {
-          cardsObj.remove(card);
-          cardObj = cardsObj.createNestedObject(card);
-          const char* cardPretty = s->getCardPretty();
-          if (cardPretty && cardPretty[0]) {
-            cardObj["cardPretty"] = cardPretty;
-          }
-          cardObj["cardOrder"] = s->getCardOrder();
-        }
-
-        JsonObject settingsObj;
-        JsonVariant existingCardSettings = cardObj["settings"];
-        if (existingCardSettings.isNull()) {
-          settingsObj = cardObj.createNestedObject("settings");
-        } else if (existingCardSettings.is<JsonObject>()) {
-          settingsObj = existingCardSettings.as<JsonObject>();
-        } else {
-          cardObj.remove("settings");
-          settingsObj = cardObj.createNestedObject("settings");
-        }
-
-        targetObj = settingsObj;
-      }
-
-      if (includeSecrets || !s->isSecret()) {
-        if (s->isSecret()) {
-          CM_CORE_LOG("[DEBUG] Including secret field: %s.%s (includeSecrets=%s)",
-                      s->getCategory(),
-                      s->getDisplayName(),
-                      includeSecrets ? "true" : "false");
-        }
-        s->toJSON(targetObj);
-      } else {
-        CM_CORE_LOG("[DEBUG] Skipping secret field: %s.%s (includeSecrets=%s)",
-                    s->getCategory(),
-                    s->getDisplayName(),
-                    includeSecrets ? "true" : "false");
-      }
-    }
-
     String output;
-    serializeJsonPretty(doc, output);
+    cm::web::StringPrint sink(output);
+    cm::web::ConfigJsonStream(settings, includeSecrets).writeTo(sink);
     return output;
   }
 
+  const std::vector<BaseSetting*>& getSettings() const {
+    return settings;
+  }
+
   String buildLiveLayoutJSON() const;
 
   // Runtime providers
   void addRuntimeProvider(const RuntimeValueProvider& provider) {
     runtimeManager.addRuntimeProvider(provider);
   }
-  void addRuntimeProvider(const String& name, std::function<void(JsonObject&)> fillFunc, int order = 100) {
-    runtimeManager.addRuntimeProvider(name, fillFunc, order);
+  void addRuntimeProvider(const String& name, std::function<void(JsonObject&)> fillFunc, int order = 100, uint32_t refreshIntervalMs = 0) {
+    runtimeManager.addRuntimeProvider(name, fillFunc, order, refreshIntervalMs);
+  }
+  bool markRuntimeProviderDirty(const String& name) {
+    return runtimeManager.markRuntimeProviderDirty(name);
   }
 
   // OTA management
@@ -2843,7 +4335,8 @@ public:
   void setupOTA(const String& hostname, const String& password = "") {
     // Wire up reboot callback for web OTA uploads
     otaManager.setCallbacks(
-      []() {
+      [this]() {
+        flush();
         ESP.restart();
       },
       [](const char* msg) {
@@ -2852,6 +4345,7 @@ public:
     otaManager.setup(hostname, password);
   }
   void handleOTA() {
+    CM_LOOP_SCOPE(OTA);
     otaManager.handle();
   }
   void enableOTA(bool enabled = true) {
@@ -2867,6 +4361,9 @@ public:
   void enableBuiltinSystemProvider() {
     runtimeManager.enableBuiltinSystemProvider();
   }
+  void enableDiagnosticsProvider() {
+    runtimeManager.enableDiagnosticsProvider();
+  }
   void updateLoopTiming() {
     runtimeManager.updateLoopTiming();
   }
@@ -2879,16 +4376,24 @@ public:
   void addWebSocketDisconnectListener(std::function<void(AsyncWebSocketClient*)> cb) {
     wsDisconnectCallbacks.push_back(std::move(cb));
   }
+  // Copies the text once into a buffer all client queues share. A client whose queue
+  // is full misses the message instead of holding it back from the others.
   bool sendWebSocketText(const String& payload) {
     if (!wsEnabled || !ws) {
       return false;
     }
-    if (!ws->availableForWriteAll()) {
-      ws->cleanupClients();
-      return false;
+    const AsyncWebSocketSharedBuffer buffer = wsShareBuffer_(reinterpret_cast<const uint8_t*>(payload.c_str()), payload.length());
+    std::vector<WsClientInfo> clients;
+    wsCopyClients_(clients);
+    bool sent = false;
+    for (const auto& c : clients) {
+      AsyncWebSocketClient* client = ws->client(c.id);
+      if (client && !client->queueIsFull()) {
+        client->text(buffer);
+        sent = true;
+      }
     }
-    ws->textAll(payload);
-    return true;
+    return sent;
   }
   // Cppcheck rationale: Preserve the existing instance API for source compatibility.
   // cppcheck-suppress functionStatic
@@ -2903,6 +4408,7 @@ public:
     return true;
   }
   size_t getWebSocketClientCount() const {
+    std::lock_guard<std::mutex> lock(wsClientsMutex);
     return wsClients.size();
   }
 
@@ -2911,38 +4417,102 @@ public:
   }
 
   void handleWebsocketPush() {
+    CM_LOOP_SCOPE(WebSocketPush);
     if (!wsEnabled || !ws)
       return;
     wsHeartbeatMaintenance();
-    if (wsClients.empty())
+    if (getWebSocketClientCount() == 0)
       return;
 
     unsigned long now = millis();
-    if (now - wsLastPush < wsInterval)
+    if (!wsPushRequested.exchange(false) && now - wsLastPush < wsInterval)
       return;
     wsLastPush = now;
-
-    String payload;
-    if (customPayloadBuilder) {
-      payload = customPayloadBuilder();
-    } else {
-      payload = runtimeManager.runtimeValuesToJSON();
-    }
-
-    sendWebSocketText(payload);
+    pushRuntimeFrame_(now);
   }
 
   bool pushRuntimeSnapshot() {
     if (!wsEnabled || !ws)
       return false;
-    String payload;
-    if (customPayloadBuilder) {
-      payload = customPayloadBuilder();
-    } else {
-      payload = runtimeManager.runtimeValuesToJSON();
-    }
     wsLastPush = millis();
-    return sendWebSocketText(payload);
+    return pushRuntimeFrame_(wsLastPush);
+  }
+
+  // Enables delta frames: after a keyframe (the full runtime object) only changed fields
+  // are pushed. Keyframes go out on connect and every keyframeIntervalMs.
+  // Has no effect while a custom live payload builder is set.
+  void setWebSocketDeltaPush(bool enable, uint32_t keyframeIntervalMs = CM_WS_KEYFRAME_INTERVAL_DEFAULT_MS) {
+    wsDeltaEnabled = enable;
+    wsKeyframeInterval = keyframeIntervalMs;
+    wsKeyframeRequested = true;
+  }
+  bool isWebSocketDeltaPush() const {
+    return wsDeltaEnabled;
+  }
+
+  // Byte counts cover each serialized payload once (JSON and MessagePack when both
+  // formats are in use), not once per client.
+  struct WebSocketPushStats {
+    uint32_t frames = 0;
+    uint32_t keyframes = 0;
+    uint32_t dropped = 0;            // Frames not sent because a client queue was full
+    uint64_t bytesSent = 0;
+    uint64_t fullFrameBytes = 0;     // What full frames would have cost (last keyframe size per delta)
+    uint32_t bytesPerSecond = 0;     // Over the last CM_WS_STATS_WINDOW_MS window
+    uint32_t fullBytesPerSecond = 0; // Full-frame equivalent over the same window
+  };
+  const WebSocketPushStats& getWebSocketPushStats() const {
+    return wsPushStats;
+  }
+  void resetWebSocketPushStats() {
+    wsPushStats = WebSocketPushStats{};
+  }
+
+  struct WebSocketClientStats {
+    uint32_t id = 0;
+    uint32_t queuedMessages = 0;
+    uint32_t queuedBytes = 0;   // Estimated from the sizes of the last frames sent to it
+    uint32_t droppedFrames = 0; // Runtime frames skipped because its queue was backed up
+    bool stale = false;         // Waiting for a keyframe after a skipped delta
+  };
+  std::vector<WebSocketClientStats> getWebSocketClientStats() const {
+    std::vector<WebSocketClientStats> result;
+    if (!ws) {
+      return result;
+    }
+    std::vector<WsClientInfo> clients;
+    wsCopyClients_(clients);
+    result.reserve(clients.size());
+    for (const auto& c : clients) {
+      AsyncWebSocketClient* client = ws->client(c.id);
+      WebSocketClientStats stats;
+      stats.id = c.id;
+      stats.queuedMessages = client ? static_cast<uint32_t>(client->queueLen()) : 0;
+      stats.queuedBytes = c.queuedBytes(stats.queuedMessages);
+      stats.droppedFrames = c.droppedFrames;
+      stats.stale = c.stale;
+      result.push_back(stats);
+    }
+    return result;
+  }
+
+  struct WebSocketCommandStats {
+    uint32_t received = 0;
+    uint32_t coalesced = 0;     // Replaced by a newer value for the same control before dispatch
+    uint32_t rejected = 0;      // Invalid, or the command queue was full
+    uint32_t dispatched = 0;
+    uint32_t lastLatencyUs = 0; // From receipt on the async_tcp task to the end of dispatch
+    uint32_t maxLatencyUs = 0;
+  };
+  WebSocketCommandStats getWebSocketCommandStats() const {
+    WebSocketCommandStats stats;
+    stats.received = wsCommandsReceived.load(std::memory_order_relaxed);
+    stats.coalesced = wsCommandsCoalesced;
+    stats.rejected = wsCommandsRejected.load(std::memory_order_relaxed);
+    stats.dispatched = wsCommandsDispatched;
+    stats.lastLatencyUs = wsCommandLastLatencyUs;
+    stats.maxLatencyUs = wsCommandMaxLatencyUs;
+    return stats;
   }
 
   void enableWebSocketPush(uint32_t intervalMs = CM_WS_PUSH_INTERVAL_DEFAULT_MS) {
@@ -2957,8 +4527,10 @@ public:
           case WS_EVT_CONNECT:
             CM_CORE_LOG_VERBOSE("[WS] Client connect %u", client->id());
             wsMarkSeen(client->id());
+            // New clients need a full frame; the loop sends it on its next pass.
+            wsKeyframeRequested = true;
             if (pushOnConnect)
-              handleWebsocketPush();
+              wsPushRequested = true;
             // Cppcheck rationale: Avoid changing mutable callback and integration handles without a call-site audit.
             // cppcheck-suppress constVariableReference
             for (auto& cb : wsConnectCallbacks) {
@@ -2984,7 +4556,7 @@ public:
             wsMarkSeen(client->id());
             break;
           case WS_EVT_DATA: {
-            // check for application-level pong
+            // Application-level pong, hello ({...}) or runtime action command ([...])
             if (arg && data && len) {
               const auto* info = reinterpret_cast<const AwsFrameInfo*>(arg);
               if (info->final && info->index == 0 && info->len == len && info->opcode == WS_TEXT) {
@@ -2995,6 +4567,10 @@ public:
                 buf[n] = '\0';
                 if (strcmp(buf, "__pong") == 0) {
                   wsMarkSeen(client->id());
+                } else if (buf[0] == '{' && len <= 128) {
+                  wsHandleHello(client->id(), data, len);
+                } else if (buf[0] == '[' && len <= 256) {
+                  wsHandleCommand(client, data, len);
                 }
               }
             }
@@ -3023,6 +4599,198 @@ public:
   void setCustomLivePayloadBuilder(std::function<String()> fn) {
     customPayloadBuilder = fn;
   }
+
+private:
+  WebSocketPushStats wsPushStats;
+
+  // One serialized payload per client encoding (JSON/MessagePack, full keys/compact).
+  struct RuntimeFramePayloads {
+    String json;
+    String compactJson;
+    std::vector<uint8_t> msgpack;
+    std::vector<uint8_t> compactMsgpack;
+
+    size_t bytes() const {
+      return json.length() + compactJson.length() + msgpack.size() + compactMsgpack.size();
+    }
+  };
+
+  static RuntimeFrameEncoding clientFrameEncoding_(const WsClientInfo& c) {
+    if (c.msgpack) {
+      return c.compact ? RuntimeFrameEncoding::CompactMsgPack : RuntimeFrameEncoding::MsgPack;
+    }
+    return c.compact ? RuntimeFrameEncoding::CompactJson : RuntimeFrameEncoding::Json;
+  }
+
+  // True when all clients asked for the same encoding (JSON when none is connected).
+  static bool sharedFrameEncoding_(const std::vector<WsClientInfo>& clients, RuntimeFrameEncoding& encoding) {
+    encoding = clients.empty() ? RuntimeFrameEncoding::Json : clientFrameEncoding_(clients.front());
+    for (const auto& c : clients) {
+      if (clientFrameEncoding_(c) != encoding) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static AsyncWebSocketSharedBuffer wsShareBuffer_(const uint8_t* data, size_t length) {
+    return std::make_shared<std::vector<uint8_t>>(data, data + length);
+  }
+
+  // True while the client has too many messages queued to take another runtime frame.
+  static bool wsClientBackedUp_(AsyncWebSocketClient* client) {
+    return client->queueIsFull() || client->queueLen() >= CM_WS_CLIENT_QUEUE_LIMIT;
+  }
+
+  // Works on a copy of the client list so WebSocket events never wait for a frame to be
+  // built; clients that connect meanwhile start stale and get the next keyframe.
+  bool pushRuntimeFrame_(unsigned long now) {
+    wsCopyClients_(wsLoopClients);
+    const bool pushed = pushRuntimeFrameTo_(wsLoopClients, now);
+    wsStoreFrameState_(wsLoopClients);
+    return pushed;
+  }
+
+  bool pushRuntimeFrameTo_(std::vector<WsClientInfo>& clients, unsigned long now) {
+    // Backed-up clients skip frames (latest wins). A client that missed a delta gets
+    // nothing until the keyframe requested here once its queue has drained.
+    bool anyReady = false;
+    for (auto& c : clients) {
+      AsyncWebSocketClient* client = ws->client(c.id);
+      if (!client) {
+        continue;
+      }
+      if (wsClientBackedUp_(client)) {
+        ++c.droppedFrames;
+        continue;
+      }
+      anyReady = true;
+      if (c.stale) {
+        wsKeyframeRequested = true;
+      }
+    }
+    if (!anyReady) {
+      // Nothing was built, so the delta state still matches what the clients have.
+      ws->cleanupClients();
+      ++wsPushStats.dropped;
+      return false;
+    }
+
+    RuntimeFramePayloads payloads;
+    RuntimeFrameTargets targets;
+    // One shared buffer per encoding; every client queue references it, none copies it.
+    AsyncWebSocketSharedBuffer frames[4];
+    RuntimeFrameEncoding encoding = RuntimeFrameEncoding::Json;
+    const bool useShared = !customPayloadBuilder && sharedFrameEncoding_(clients, encoding);
+    if (useShared) {
+      // Serialized straight into the buffer the clients will send from.
+      targets.sharedEncoding = encoding;
+      targets.reserveShared = [&frames, encoding](size_t size) -> uint8_t* {
+        AsyncWebSocketSharedBuffer& frame = frames[static_cast<size_t>(encoding)];
+        frame = std::make_shared<std::vector<uint8_t>>(size);
+        return frame->data();
+      };
+    } else {
+      for (const auto& c : clients) {
+        switch (clientFrameEncoding_(c)) {
+          case RuntimeFrameEncoding::CompactMsgPack:
+            targets.compactMsgpack = &payloads.compactMsgpack;
+            break;
+          case RuntimeFrameEncoding::MsgPack:
+            targets.msgpack = &payloads.msgpack;
+            break;
+          case RuntimeFrameEncoding::CompactJson:
+            targets.compactJson = &payloads.compactJson;
+            break;
+          case RuntimeFrameEncoding::Json:
+            targets.json = &payloads.json;
+            break;
+        }
+      }
+    }
+
+    bool keyframe = true;
+    const bool delta = wsDeltaEnabled && !customPayloadBuilder;
+    if (customPayloadBuilder) {
+      // Custom payloads are opaque text; every client gets them as-is.
+      payloads.json = customPayloadBuilder();
+    } else {
+      if (delta) {
+        keyframe = wsKeyframeRequested.exchange(false) || now - wsLastKeyframe >= wsKeyframeInterval;
+      }
+      if (!runtimeManager.runtimeFrame(delta, keyframe, targets)) {
+        return true; // Nothing changed
+      }
+    }
+
+    if (!useShared) {
+      frames[static_cast<size_t>(RuntimeFrameEncoding::Json)] = wsShareBuffer_(reinterpret_cast<const uint8_t*>(payloads.json.c_str()), payloads.json.length());
+      frames[static_cast<size_t>(RuntimeFrameEncoding::CompactJson)] = wsShareBuffer_(reinterpret_cast<const uint8_t*>(payloads.compactJson.c_str()), payloads.compactJson.length());
+      frames[static_cast<size_t>(RuntimeFrameEncoding::MsgPack)] = wsShareBuffer_(payloads.msgpack.data(), payloads.msgpack.size());
+      frames[static_cast<size_t>(RuntimeFrameEncoding::CompactMsgPack)] = wsShareBuffer_(payloads.compactMsgpack.data(), payloads.compactMsgpack.size());
+    }
+    uint32_t bytes = 0;
+    for (const AsyncWebSocketSharedBuffer& frame : frames) {
+      bytes += frame ? frame->size() : 0;
+    }
+
+    bool skipped = false;
+    for (auto& c : clients) {
+      AsyncWebSocketClient* client = ws->client(c.id);
+      if (!client) {
+        continue;
+      }
+      const RuntimeFrameEncoding clientEncoding = customPayloadBuilder ? RuntimeFrameEncoding::Json : clientFrameEncoding_(c);
+      const AsyncWebSocketSharedBuffer& frame = frames[static_cast<size_t>(clientEncoding)];
+      if (!frame || frame->empty()) {
+        continue;
+      }
+      if (wsClientBackedUp_(client) || (c.stale && !keyframe)) {
+        // Only deltas depend on the frames before them.
+        c.stale = c.stale || delta;
+        ++c.droppedFrames;
+        skipped = true;
+        continue;
+      }
+      if (clientEncoding == RuntimeFrameEncoding::Json || clientEncoding == RuntimeFrameEncoding::CompactJson) {
+        client->text(frame);
+      } else {
+        client->binary(frame);
+      }
+      c.recordFrame(frame->size());
+      if (keyframe) {
+        c.stale = false;
+      }
+    }
+    if (skipped) {
+      ++wsPushStats.dropped;
+    }
+    if (keyframe) {
+      wsLastKeyframe = now;
+      ++wsPushStats.keyframes;
+    }
+    const uint32_t fullBytes = delta ? runtimeManager.getRuntimeDeltaEncoder().lastKeyframeBytes() : bytes;
+    recordWebSocketFrame_(now, bytes, fullBytes);
+    return true;
+  }
+
+  void recordWebSocketFrame_(unsigned long now, uint32_t bytes, uint32_t fullBytes) {
+    ++wsPushStats.frames;
+    wsPushStats.bytesSent += bytes;
+    wsPushStats.fullFrameBytes += fullBytes;
+    wsStatsWindowBytes += bytes;
+    wsStatsWindowFullBytes += fullBytes;
+    const unsigned long elapsed = now - wsStatsWindowStart;
+    if (elapsed >= CM_WS_STATS_WINDOW_MS) {
+      wsPushStats.bytesPerSecond = static_cast<uint32_t>(static_cast<uint64_t>(wsStatsWindowBytes) * 1000 / elapsed);
+      wsPushStats.fullBytesPerSecond = static_cast<uint32_t>(static_cast<uint64_t>(wsStatsWindowFullBytes) * 1000 / elapsed);
+      wsStatsWindowStart = now;
+      wsStatsWindowBytes = 0;
+      wsStatsWindowFullBytes = 0;
+    }
+  }
+
+public:
   void WebSocketPush(bool enable = true, uint32_t intervalMs = CM_WS_PUSH_INTERVAL_DEFAULT_MS) {
 #if CM_ENABLE_WS_PUSH
     if (enable) {
@@ -3042,6 +4810,10 @@ public:
   void setWebSocketInterval(uint32_t) {}
   void setPushOnConnect(bool) {}
   void setCustomLivePayloadBuilder(std::function<String()>) {}
+  void setWebSocketDeltaPush(bool, uint32_t = CM_WS_KEYFRAME_INTERVAL_DEFAULT_MS) {}
+  bool isWebSocketDeltaPush() const {
+    return false;
+  }
   bool pushRuntimeSnapshot() {
     return false;
   }
@@ -10,10 +10,22 @@
 // - CM_ENABLE_WIFI (1)
 // - CM_ENABLE_OTA (1)
 // - CM_ENABLE_SYSTEM_PROVIDER (1)
+// - CM_SYSTEM_PROVIDER_REFRESH_MS (1000)
+// - CM_DIAGNOSTICS_PROVIDER_REFRESH_MS (5000)
+// - CM_ENABLE_LOOP_PROFILER (1)
 // - CM_ENABLE_SYSTEM_TIME (1)
 // - CM_ENABLE_STYLE_RULES (1)
 // - CM_ENABLE_USER_CSS (1)
 // - CM_ENABLE_THEMING (1)
+// - CM_PERSIST_QUIET_MS (0)
+// - CM_RUNTIME_FRAME_ARENA_BYTES (4096)
+// - CM_WS_CLIENT_QUEUE_LIMIT (2)
+// - CM_RUNTIME_ACTION_QUEUE_SIZE (16)
+// - CM_LOOP_MAILBOX_SIZE (32)
+// - CM_HTTP_MAX_CRITICAL (2), CM_HTTP_MAX_INTERACTIVE (4), CM_HTTP_MAX_BULK (3)
+// - CM_HTTP_MIN_FREE_HEAP (32768), CM_HTTP_MIN_LARGEST_BLOCK (8192), CM_HTTP_RETRY_AFTER_S (2)
+// - CM_OTA_FLUSH_TIMEOUT_MS (1000)
+// - CM_RUNTIME_HISTORY_FIELDS (8), CM_RUNTIME_HISTORY_1S (120), CM_RUNTIME_HISTORY_1M (120), CM_RUNTIME_HISTORY_15M (96)
 
 // --- Removed flags (error if a project still defines them) ---
 #ifdef CM_ENABLE_WS_PUSH
@@ -30,6 +42,24 @@
 #define CM_ENABLE_SYSTEM_PROVIDER 1
 #endif
 
+// Minimum interval (ms) between refreshes of the built-in system provider; frames in
+// between reuse its last values. 0 refreshes it for every frame.
+#ifndef CM_SYSTEM_PROVIDER_REFRESH_MS
+#define CM_SYSTEM_PROVIDER_REFRESH_MS 1000
+#endif
+
+// Minimum interval (ms) between refreshes of the opt-in diagnostics provider
+// (enableDiagnosticsProvider()).
+#ifndef CM_DIAGNOSTICS_PROVIDER_REFRESH_MS
+#define CM_DIAGNOSTICS_PROVIDER_REFRESH_MS 5000
+#endif
+
+// Loop latency histograms per subsystem (diagnostics.perf, /perf.json). With 0 the timers
+// compile to nothing.
+#ifndef CM_ENABLE_LOOP_PROFILER
+#define CM_ENABLE_LOOP_PROFILER 1
+#endif
+
 #ifndef CM_ENABLE_SYSTEM_TIME
 #define CM_ENABLE_SYSTEM_TIME 1
 #endif
@@ -54,6 +84,84 @@
 #define CM_ENABLE_WIFI 1
 #endif
 
+// Write-behind quiet period for persisted settings (ms). 0 keeps the previous
+// behavior of committing every save immediately; see setPersistQuietPeriod().
+#ifndef CM_PERSIST_QUIET_MS
+#define CM_PERSIST_QUIET_MS 0
+#endif
+
+// Size (bytes) of each of the two reusable arenas runtime frames are built in.
+// Frames that do not fit spill over to the heap; 0 builds every frame on the heap.
+#ifndef CM_RUNTIME_FRAME_ARENA_BYTES
+#define CM_RUNTIME_FRAME_ARENA_BYTES 4096
+#endif
+
+// WebSocket messages a client may have queued before runtime frames for it are
+// skipped (latest wins). Other clients keep receiving every frame.
+#ifndef CM_WS_CLIENT_QUEUE_LIMIT
+#define CM_WS_CLIENT_QUEUE_LIMIT 2
+#endif
+
+// Runtime actions (/ws commands and /runtime_action/* requests) waiting for dispatch
+// on the loop. Slider and input values for the same control are merged, so this
+// bounds distinct controls.
+#ifndef CM_RUNTIME_ACTION_QUEUE_SIZE
+#define CM_RUNTIME_ACTION_QUEUE_SIZE 16
+#endif
+
+// Mutations web handlers can hand to the loop task at once (settings writes, runtime
+// actions, GUI actions, reset, reboot); rounded up to a power of two. When full,
+// requests are answered 503 / busy.
+#ifndef CM_LOOP_MAILBOX_SIZE
+#define CM_LOOP_MAILBOX_SIZE 32
+#endif
+
+// HTTP admission control (cm::web::AdmissionController): requests in flight per class
+// (critical: OTA upload, save, reset, reboot; interactive: apply and actions; bulk:
+// config/runtime polling). Bulk requests need CM_HTTP_MIN_FREE_HEAP free heap and a
+// CM_HTTP_MIN_LARGEST_BLOCK block, interactive ones half of that; critical ones only
+// the concurrency slot. Refused requests get 503 with Retry-After: CM_HTTP_RETRY_AFTER_S.
+#ifndef CM_HTTP_MAX_CRITICAL
+#define CM_HTTP_MAX_CRITICAL 2
+#endif
+#ifndef CM_HTTP_MAX_INTERACTIVE
+#define CM_HTTP_MAX_INTERACTIVE 4
+#endif
+#ifndef CM_HTTP_MAX_BULK
+#define CM_HTTP_MAX_BULK 3
+#endif
+#ifndef CM_HTTP_MIN_FREE_HEAP
+#define CM_HTTP_MIN_FREE_HEAP 32768
+#endif
+#ifndef CM_HTTP_MIN_LARGEST_BLOCK
+#define CM_HTTP_MIN_LARGEST_BLOCK 8192
+#endif
+#ifndef CM_HTTP_RETRY_AFTER_S
+#define CM_HTTP_RETRY_AFTER_S 2
+#endif
+
+// A web OTA upload asks the loop task to flush queued setting writes and waits this
+// long for it before writing the new firmware.
+#ifndef CM_OTA_FLUSH_TIMEOUT_MS
+#define CM_OTA_FLUSH_TIMEOUT_MS 1000
+#endif
+
+// Runtime history (LiveFieldBuilder::history()): fields that can be recorded and the
+// buckets kept per resolution. Storage is reserved for all fields at once
+// (6 bytes per bucket, 2 KB per field with the defaults).
+#ifndef CM_RUNTIME_HISTORY_FIELDS
+#define CM_RUNTIME_HISTORY_FIELDS 8
+#endif
+#ifndef CM_RUNTIME_HISTORY_1S
+#define CM_RUNTIME_HISTORY_1S 120
+#endif
+#ifndef CM_RUNTIME_HISTORY_1M
+#define CM_RUNTIME_HISTORY_1M 120
+#endif
+#ifndef CM_RUNTIME_HISTORY_15M
+#define CM_RUNTIME_HISTORY_15M 96
+#endif
+
 // --- Core/library logging flags (still configurable) ---
 // These flags only affect CM_LOG/CM_LOG_VERBOSE usage inside the library core.
 // The advanced LoggingManager module remains available and is controlled via CM_LOGGING_LEVEL.
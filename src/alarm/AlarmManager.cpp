@@ -177,6 +177,7 @@ AlarmManager::AlarmHandle AlarmManager::addDigitalAlarm(const DigitalAlarmConfig
   entry.style = (cfg.severity == AlarmSeverity::Alarm) ? buildAlarmStyle() : buildWarningStyle();
 
   alarms.push_back(std::move(entry));
+  settingsEpochValid = false;
   ALARM_LOG_VERBOSE("Registered digital alarm '%s' (%s)", alarms.back().name.c_str(), alarms.back().id.c_str());
   return AlarmHandle(this, alarms.size() - 1);
 }
@@ -213,6 +214,7 @@ AlarmManager::AlarmHandle AlarmManager::addAnalogAlarm(const AnalogAlarmConfig&
   entry.style = (cfg.severity == AlarmSeverity::Alarm) ? buildAlarmStyle() : buildWarningStyle();
 
   alarms.push_back(std::move(entry));
+  settingsEpochValid = false;
   ALARM_LOG_VERBOSE("Registered analog alarm '%s' (%s)", alarms.back().name.c_str(), alarms.back().id.c_str());
   return AlarmHandle(this, alarms.size() - 1);
 }
@@ -561,6 +563,7 @@ void AlarmManager::registerSettings(AlarmEntry& entry,
     }
 
     entry.settingsRegistered = true;
+    settingsEpochValid = false;
   }
 
   const String effectiveGroup = (groupName && groupName[0]) ? String(groupName) : entry.name;
@@ -684,6 +687,14 @@ float AlarmManager::thresholdMaxNow(const AlarmEntry& entry) const {
   return entry.thresholdMaxSetting ? entry.thresholdMaxSetting->get() : entry.thresholdMax;
 }
 
+void AlarmManager::resolveSettings(AlarmEntry& entry) const {
+  entry.resolved.enabled = isEnabledNow(entry);
+  entry.resolved.minActive = isMinActiveNow(entry);
+  entry.resolved.maxActive = isMaxActiveNow(entry);
+  entry.resolved.thresholdMin = thresholdMinNow(entry);
+  entry.resolved.thresholdMax = thresholdMaxNow(entry);
+}
+
 // Cppcheck rationale: Preserve the existing instance API for source compatibility.
 // cppcheck-suppress functionStatic
 bool AlarmManager::readDigitalSource(const AlarmEntry& entry, bool& value) const {
@@ -720,12 +731,23 @@ void AlarmManager::update() {
     }
   }
   lastUpdateMs = nowMsRaw;
+  CM_LOOP_SCOPE(Alarms);
+
+  // Enable flags and thresholds only change with the settings epoch.
+  const uint32_t epoch = ConfigManagerClass::getSettingsEpoch();
+  if (!settingsEpochValid || epoch != settingsEpochSeen) {
+    for (auto& entry : alarms) {
+      resolveSettings(entry);
+    }
+    settingsEpochSeen = epoch;
+    settingsEpochValid = true;
+  }
+
   const auto now = std::chrono::milliseconds(nowMsRaw);
   for (auto& entry : alarms) {
     bool nextActive = false;
     AlarmState nextState = AlarmState::Ok;
-    bool enabled = isEnabledNow(entry);
-    if (!enabled) {
+    if (!entry.resolved.enabled) {
       nextActive = false;
       nextState = AlarmState::Ok;
     } else if (isDigitalKind(entry.kind)) {
@@ -741,10 +763,10 @@ void AlarmManager::update() {
       if (!readAnalogSource(entry, value)) {
         continue;
       }
-      const bool minActive = isMinActiveNow(entry);
-      const bool maxActive = isMaxActiveNow(entry);
-      const float minVal = thresholdMinNow(entry);
-      const float maxVal = thresholdMaxNow(entry);
+      const bool minActive = entry.resolved.minActive;
+      const bool maxActive = entry.resolved.maxActive;
+      const float minVal = entry.resolved.thresholdMin;
+      const float maxVal = entry.resolved.thresholdMax;
 
       if (entry.kind == AlarmKind::AnalogBelow) {
         if (minActive && isFiniteFloat(minVal) && value < minVal) {
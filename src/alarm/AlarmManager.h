@@ -183,6 +183,15 @@ private:
     Config<float>* thresholdMinSetting = nullptr;
     Config<float>* thresholdMaxSetting = nullptr;
 
+    // Settings snapshot used by update(); refreshed when the settings epoch changes.
+    struct Resolved {
+      bool enabled = true;
+      bool minActive = false;
+      bool maxActive = false;
+      float thresholdMin = 0.0f;
+      float thresholdMax = 0.0f;
+    } resolved;
+
     bool active = false;
     AlarmState state = AlarmState::Ok;
     std::function<void()> onEnter;
@@ -201,6 +210,8 @@ private:
 
   uint32_t updateIntervalMs = 1500;
   uint32_t lastUpdateMs = 0;
+  uint32_t settingsEpochSeen = 0;
+  bool settingsEpochValid = false;
 
   struct AlarmLiveGroup {
     String group;
@@ -237,6 +248,7 @@ private:
   bool isMaxActiveNow(const AlarmEntry& entry) const;
   float thresholdMinNow(const AlarmEntry& entry) const;
   float thresholdMaxNow(const AlarmEntry& entry) const;
+  void resolveSettings(AlarmEntry& entry) const;
   bool readDigitalSource(const AlarmEntry& entry, bool& value) const;
   bool readAnalogSource(const AlarmEntry& entry, float& value) const;
 };
@@ -26,19 +26,55 @@ inline constexpr char IO[] = "IO";
 inline constexpr char Ntp[] = "NTP";
 } // namespace CoreCategories
 
+// Flash-resident metadata and defaults of the core settings (see ConfigDescriptor<T>).
+// Storage keys match the former ConfigOptions definitions, so stored values are kept.
+namespace CoreDescriptors {
+#if CM_ENABLE_WIFI
+namespace WiFi {
+inline constexpr ConfigDescriptor<String> wifiSsid{{.key = "WiFiSSID", .name = "WiFi SSID", .category = CoreCategories::WiFi, .sortOrder = 1}, ""};
+inline constexpr ConfigDescriptor<String> wifiPassword{{.key = "WiFiPassword", .name = "WiFi Password", .category = CoreCategories::WiFi, .sortOrder = 2, .isPassword = true}, ""};
+inline constexpr ConfigDescriptor<bool> useDhcp{{.key = "WiFiUseDHCP", .name = "Use DHCP", .category = CoreCategories::WiFi, .sortOrder = 3}, true};
+inline constexpr ConfigDescriptor<String> staticIp{{.key = "WiFiStaticIP", .name = "Static IP", .category = CoreCategories::WiFi, .sortOrder = 4}, "192.168.0.10"};
+inline constexpr ConfigDescriptor<String> gateway{{.key = "WiFiGateway", .name = "Gateway", .category = CoreCategories::WiFi, .sortOrder = 5}, "192.168.0.1"};
+inline constexpr ConfigDescriptor<String> subnet{{.key = "WiFiSubnet", .name = "Subnet Mask", .category = CoreCategories::WiFi, .sortOrder = 6}, "255.255.255.0"};
+inline constexpr ConfigDescriptor<String> dnsPrimary{{.key = "WiFiDNS1", .name = "Primary DNS", .category = CoreCategories::WiFi, .sortOrder = 7}, "192.168.0.1"};
+inline constexpr ConfigDescriptor<String> dnsSecondary{{.key = "WiFiDNS2", .name = "Secondary DNS", .category = CoreCategories::WiFi, .sortOrder = 8}, "8.8.8.8"};
+inline constexpr ConfigDescriptor<int> rebootTimeoutMin{{.key = "WiFiRb", .name = "Reboot if WiFi lost (min)", .category = CoreCategories::WiFi, .sortOrder = 20}, 5};
+} // namespace WiFi
+#endif
+namespace System {
+inline constexpr ConfigDescriptor<bool> allowOTA{{.key = "OTAEn", .name = "Allow OTA Updates", .category = CoreCategories::System, .sortOrder = 1}, true};
+inline constexpr ConfigDescriptor<String> otaPassword{{.key = "OTAPass", .name = "OTA Password", .category = CoreCategories::System, .sortOrder = 2, .isPassword = true}, ""};
+} // namespace System
+namespace Ntp {
+inline constexpr ConfigDescriptor<int> frequencySec{{.key = "NTPFrq", .name = "NTP Sync Interval (s)", .category = CoreCategories::Ntp, .sortOrder = 1}, 3600};
+inline constexpr ConfigDescriptor<String> server1{{.key = "NTP1", .name = "NTP Server 1", .category = CoreCategories::Ntp, .sortOrder = 2}, "192.168.2.250"};
+inline constexpr ConfigDescriptor<String> server2{{.key = "NTP2", .name = "NTP Server 2", .category = CoreCategories::Ntp, .sortOrder = 3}, "pool.ntp.org"};
+inline constexpr ConfigDescriptor<String> tz{{.key = "NTPTZ", .name = "Time Zone (POSIX)", .category = CoreCategories::Ntp, .sortOrder = 4}, "CET-1CEST,M3.5.0/02,M10.5.0/03"};
+} // namespace Ntp
+namespace Buttons {
+inline constexpr ConfigDescriptor<int> apModePin{{.key = "BtnAP", .name = "AP Mode Button GPIO", .category = CoreCategories::Buttons, .sortOrder = 1}, -1};
+inline constexpr ConfigDescriptor<int> resetDefaultsPin{{.key = "BtnRst", .name = "Reset Defaults Button GPIO", .category = CoreCategories::Buttons, .sortOrder = 2}, -1};
+inline constexpr ConfigDescriptor<bool> apModeActiveLow{{.key = "BtnAPLow", .name = "AP Mode LOW-Active", .category = CoreCategories::Buttons, .sortOrder = 3}, true};
+inline constexpr ConfigDescriptor<bool> apModeUsePullup{{.key = "BtnAPPU", .name = "AP Mode Use Pull-Up", .category = CoreCategories::Buttons, .sortOrder = 4}, true};
+inline constexpr ConfigDescriptor<bool> resetActiveLow{{.key = "BtnRstLow", .name = "Reset LOW-Active", .category = CoreCategories::Buttons, .sortOrder = 5}, true};
+inline constexpr ConfigDescriptor<bool> resetUsePullup{{.key = "BtnRstPU", .name = "Reset Use Pull-Up", .category = CoreCategories::Buttons, .sortOrder = 6}, true};
+} // namespace Buttons
+} // namespace CoreDescriptors
+
 #if CM_ENABLE_WIFI
 struct CoreWiFiSettings {
-  Config<String> wifiSsid{ConfigOptions<String>{.key = "WiFiSSID", .name = "WiFi SSID", .category = CoreCategories::WiFi, .defaultValue = String(""), .showInWeb = true, .sortOrder = 1}};
-  Config<String> wifiPassword{ConfigOptions<String>{.key = "WiFiPassword", .name = "WiFi Password", .category = CoreCategories::WiFi, .defaultValue = String(""), .showInWeb = true, .isPassword = true, .sortOrder = 2}};
-  Config<bool> useDhcp{ConfigOptions<bool>{.key = "WiFiUseDHCP", .name = "Use DHCP", .category = CoreCategories::WiFi, .defaultValue = true, .showInWeb = true, .sortOrder = 3}};
+  Config<String> wifiSsid{CoreDescriptors::WiFi::wifiSsid};
+  Config<String> wifiPassword{CoreDescriptors::WiFi::wifiPassword};
+  Config<bool> useDhcp{CoreDescriptors::WiFi::useDhcp};
 
-  Config<String> staticIp{ConfigOptions<String>{.key = "WiFiStaticIP", .name = "Static IP", .category = CoreCategories::WiFi, .defaultValue = String("192.168.0.10"), .showInWeb = true, .sortOrder = 4}};
-  Config<String> gateway{ConfigOptions<String>{.key = "WiFiGateway", .name = "Gateway", .category = CoreCategories::WiFi, .defaultValue = String("192.168.0.1"), .showInWeb = true, .sortOrder = 5}};
-  Config<String> subnet{ConfigOptions<String>{.key = "WiFiSubnet", .name = "Subnet Mask", .category = CoreCategories::WiFi, .defaultValue = String("255.255.255.0"), .showInWeb = true, .sortOrder = 6}};
-  Config<String> dnsPrimary{ConfigOptions<String>{.key = "WiFiDNS1", .name = "Primary DNS", .category = CoreCategories::WiFi, .defaultValue = String("192.168.0.1"), .showInWeb = true, .sortOrder = 7}};
-  Config<String> dnsSecondary{ConfigOptions<String>{.key = "WiFiDNS2", .name = "Secondary DNS", .category = CoreCategories::WiFi, .defaultValue = String("8.8.8.8"), .showInWeb = true, .sortOrder = 8}};
+  Config<String> staticIp{CoreDescriptors::WiFi::staticIp};
+  Config<String> gateway{CoreDescriptors::WiFi::gateway};
+  Config<String> subnet{CoreDescriptors::WiFi::subnet};
+  Config<String> dnsPrimary{CoreDescriptors::WiFi::dnsPrimary};
+  Config<String> dnsSecondary{CoreDescriptors::WiFi::dnsSecondary};
 
-  Config<int> rebootTimeoutMin{ConfigOptions<int>{.key = "WiFiRb", .name = "Reboot if WiFi lost (min)", .category = CoreCategories::WiFi, .defaultValue = 5, .showInWeb = true, .sortOrder = 20}};
+  Config<int> rebootTimeoutMin{CoreDescriptors::WiFi::rebootTimeoutMin};
 
   void attachTo(ConfigManagerClass& cfg) {
     cfg.addSetting(&wifiSsid);
@@ -63,8 +99,8 @@ struct CoreWiFiSettings {
 
 struct CoreSystemSettings {
   explicit CoreSystemSettings(const String& defaultVersion)
-      : allowOTA(ConfigOptions<bool>{.key = "OTAEn", .name = "Allow OTA Updates", .category = CoreCategories::System, .defaultValue = true, .showInWeb = true, .sortOrder = 1}),
-        otaPassword(ConfigOptions<String>{.key = "OTAPass", .name = "OTA Password", .category = CoreCategories::System, .defaultValue = String(""), .showInWeb = true, .isPassword = true, .sortOrder = 2}),
+      : allowOTA(CoreDescriptors::System::allowOTA),
+        otaPassword(CoreDescriptors::System::otaPassword),
         version(ConfigOptions<String>{.key = "P_Version", .name = "Program Version", .category = CoreCategories::System, .defaultValue = defaultVersion, .showInWeb = true, .sortOrder = 3}) {
   }
 
@@ -80,10 +116,10 @@ struct CoreSystemSettings {
 };
 
 struct CoreNtpSettings {
-  Config<int> frequencySec{ConfigOptions<int>{.key = "NTPFrq", .name = "NTP Sync Interval (s)", .category = CoreCategories::Ntp, .defaultValue = 3600, .showInWeb = true, .sortOrder = 1}};
-  Config<String> server1{ConfigOptions<String>{.key = "NTP1", .name = "NTP Server 1", .category = CoreCategories::Ntp, .defaultValue = String("192.168.2.250"), .showInWeb = true, .sortOrder = 2}};
-  Config<String> server2{ConfigOptions<String>{.key = "NTP2", .name = "NTP Server 2", .category = CoreCategories::Ntp, .defaultValue = String("pool.ntp.org"), .showInWeb = true, .sortOrder = 3}};
-  Config<String> tz{ConfigOptions<String>{.key = "NTPTZ", .name = "Time Zone (POSIX)", .category = CoreCategories::Ntp, .defaultValue = String("CET-1CEST,M3.5.0/02,M10.5.0/03"), .showInWeb = true, .sortOrder = 4}};
+  Config<int> frequencySec{CoreDescriptors::Ntp::frequencySec};
+  Config<String> server1{CoreDescriptors::Ntp::server1};
+  Config<String> server2{CoreDescriptors::Ntp::server2};
+  Config<String> tz{CoreDescriptors::Ntp::tz};
 
   void attachTo(ConfigManagerClass& cfg) {
     cfg.addSetting(&frequencySec);
@@ -103,15 +139,15 @@ struct CoreButtonSettings {
   //   - bool IOManager::checkApModeButton(const CoreButtonSettings& cfg, std::function<void()> onPressed);
   // Notes:
   //   - The callback should decide the action (e.g. show feedback, clear prefs, reboot).
-  Config<int> apModePin{ConfigOptions<int>{.key = "BtnAP", .name = "AP Mode Button GPIO", .category = CoreCategories::Buttons, .defaultValue = -1, .showInWeb = true, .sortOrder = 1}};
-  Config<int> resetDefaultsPin{ConfigOptions<int>{.key = "BtnRst", .name = "Reset Defaults Button GPIO", .category = CoreCategories::Buttons, .defaultValue = -1, .showInWeb = true, .sortOrder = 2}};
+  Config<int> apModePin{CoreDescriptors::Buttons::apModePin};
+  Config<int> resetDefaultsPin{CoreDescriptors::Buttons::resetDefaultsPin};
 
   // Default behavior matches the existing examples: INPUT_PULLUP + pressed == LOW.
-  Config<bool> apModeActiveLow{ConfigOptions<bool>{.key = "BtnAPLow", .name = "AP Mode LOW-Active", .category = CoreCategories::Buttons, .defaultValue = true, .showInWeb = true, .sortOrder = 3}};
-  Config<bool> apModeUsePullup{ConfigOptions<bool>{.key = "BtnAPPU", .name = "AP Mode Use Pull-Up", .category = CoreCategories::Buttons, .defaultValue = true, .showInWeb = true, .sortOrder = 4}};
+  Config<bool> apModeActiveLow{CoreDescriptors::Buttons::apModeActiveLow};
+  Config<bool> apModeUsePullup{CoreDescriptors::Buttons::apModeUsePullup};
 
-  Config<bool> resetActiveLow{ConfigOptions<bool>{.key = "BtnRstLow", .name = "Reset LOW-Active", .category = CoreCategories::Buttons, .defaultValue = true, .showInWeb = true, .sortOrder = 5}};
-  Config<bool> resetUsePullup{ConfigOptions<bool>{.key = "BtnRstPU", .name = "Reset Use Pull-Up", .category = CoreCategories::Buttons, .defaultValue = true, .showInWeb = true, .sortOrder = 6}};
+  Config<bool> resetActiveLow{CoreDescriptors::Buttons::resetActiveLow};
+  Config<bool> resetUsePullup{CoreDescriptors::Buttons::resetUsePullup};
 
   void attachTo(ConfigManagerClass& cfg) {
     cfg.addSetting(&apModePin);
@@ -14,4 +14,9 @@ const uint8_t* WebHTML::getWebHTMLGz() {
 size_t WebHTML::getWebHTMLGzLen() {
   return WEB_HTML_GZ_LEN;
 }
+// Cppcheck rationale: Preserve the existing instance API for source compatibility.
+// cppcheck-suppress functionStatic
+const char* WebHTML::getWebHTMLGzHash() {
+  return WEB_HTML_GZ_HASH;
+}
 #endif
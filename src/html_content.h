@@ -2462,9 +2462,11 @@ const uint8_t WEB_HTML_GZ[] PROGMEM = {
     0x57, 0x65, 0x36, 0x7b, 0xf2, 0xa7, 0xcf, 0xfe, 0xf4, 0xd9, 0xff, 0x03, 0xb3, 0x19, 0x5f, 0x51, 0x27, 0xd8, 0x02, 0x00
 };
 const size_t WEB_HTML_GZ_LEN = 58964;
+const char WEB_HTML_GZ_HASH[] = "5722b484c7bb430f";
 
 class WebHTML {
 public:
     const uint8_t* getWebHTMLGz();
     size_t getWebHTMLGzLen();
+    const char* getWebHTMLGzHash();
 };
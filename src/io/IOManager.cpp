@@ -165,6 +165,7 @@ void IOManager::addDigitalOutput(const DigitalOutputBinding& binding) {
   entry.showActiveLowInWeb = binding.showActiveLowInWeb;
 
   digitalOutputs.push_back(std::move(entry));
+  settingsEpochValid = false;
 }
 
 void IOManager::addDigitalInput(const DigitalInputBinding& binding) {
@@ -208,6 +209,7 @@ void IOManager::addDigitalInput(const DigitalInputBinding& binding) {
   entry.showPulldownInWeb = binding.showPulldownInWeb;
 
   digitalInputs.push_back(std::move(entry));
+  settingsEpochValid = false;
 }
 
 void IOManager::addAnalogInput(const AnalogInputBinding& binding) {
@@ -259,6 +261,7 @@ void IOManager::addAnalogInput(const AnalogInputBinding& binding) {
   entry.showMinEventInWeb = binding.showMinEventInWeb;
 
   analogInputs.push_back(std::move(entry));
+  settingsEpochValid = false;
 }
 
 void IOManager::addAnalogOutput(const AnalogOutputBinding& binding) {
@@ -304,6 +307,7 @@ void IOManager::addAnalogOutput(const AnalogOutputBinding& binding) {
   entry.value = entry.desiredValue;
 
   analogOutputs.push_back(std::move(entry));
+  settingsEpochValid = false;
 }
 
 void IOManager::addDigitalInput(const char* id,
@@ -1399,15 +1403,31 @@ bool IOManager::isStartupLongPressWindowActive(uint32_t nowMs) const {
   return static_cast<int32_t>(nowMs - startupLongPressWindowEndsMs) <= 0;
 }
 
+bool IOManager::consumeSettingsChange() {
+  const uint32_t epoch = ConfigManagerClass::getSettingsEpoch();
+  const bool changed = !settingsEpochValid || epoch != settingsEpochSeen;
+  settingsEpochSeen = epoch;
+  settingsEpochValid = true;
+  return changed;
+}
+
 void IOManager::update() {
+  CM_LOOP_SCOPE(IO);
+  // Pin, polarity and pull settings can only change with the settings epoch.
+  const bool settingsChanged = consumeSettingsChange();
+
   for (auto& entry : digitalOutputs) {
-    reconfigureIfNeeded(entry);
+    if (settingsChanged) {
+      reconfigureIfNeeded(entry);
+    }
     applyDesiredState(entry);
   }
 
   const uint32_t nowMs = millis();
   for (auto& entry : digitalInputs) {
-    reconfigureIfNeeded(entry);
+    if (settingsChanged) {
+      reconfigureIfNeeded(entry);
+    }
     readInputState(entry);
     if (entry.onChangeCallback) {
       if (!entry.hasLastStateForCallback) {
@@ -1422,14 +1442,18 @@ void IOManager::update() {
   }
 
   for (auto& entry : analogInputs) {
-    reconfigureIfNeeded(entry);
+    if (settingsChanged) {
+      reconfigureIfNeeded(entry);
+    }
     readAnalogInput(entry);
     processAnalogAlarm(entry);
     processAnalogEvents(entry, nowMs);
   }
 
   for (auto& entry : analogOutputs) {
-    reconfigureIfNeeded(entry);
+    if (settingsChanged) {
+      reconfigureIfNeeded(entry);
+    }
     applyDesiredAnalogOutput(entry);
   }
 }
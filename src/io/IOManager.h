@@ -651,6 +651,11 @@ private:
   uint32_t startupLongPressWindowEndsMs = 0;
   static constexpr uint32_t STARTUP_LONG_PRESS_WINDOW_MS = 10000;
 
+  // Settings epoch seen by the last update(); pins/polarity are only re-read when it moves.
+  uint32_t settingsEpochSeen = 0;
+  bool settingsEpochValid = false;
+  bool consumeSettingsChange();
+
   uint8_t nextDigitalOutputSlot = 0;
   uint8_t nextDigitalInputSlot = 0;
   uint8_t nextAnalogInputSlot = 0;
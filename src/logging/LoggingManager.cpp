@@ -377,6 +377,7 @@ void LoggingManager::logV(Level level, const char* tag, const char* format, va_l
 }
 
 void LoggingManager::loop() {
+  CM_LOOP_SCOPE(Logging);
   const unsigned long now = millis();
   for (auto& output : outputs_) {
     if (output) {
@@ -428,6 +428,8 @@ private:
     String topicValue;
     String jsonKeyPathValue;
     String lastSubscribedTopic;
+    String resolvedTopic;   // getReceiveTopic_() cached per settings epoch
+    String resolvedKeyPath; // getReceiveJsonKeyPath_() cached per settings epoch
     bool settingsRegistered = false;
     int settingsCardOrder = 0;
 
@@ -470,6 +472,8 @@ private:
   String lastTopic_;
   String lastPayload_;
   unsigned long lastMessageMs_ = 0;
+  uint32_t receiveSettingsEpoch_ = 0;
+  bool receiveSettingsValid_ = false;
   bool processingIncomingMessage_ = false;
 
   // Topic registry
@@ -504,6 +508,7 @@ private:
   void handleIncomingMessage_(const char* topic, const byte* payload, unsigned int length);
   void handleReceiveItems_(const char* topic, const byte* payload, unsigned int length);
   void updateReceiveSubscription_(ReceiveItem& item, bool force);
+  void refreshReceiveItems_();
   ReceiveItem* findReceiveItemById_(const char* id);
   String getReceiveTopic_(const ReceiveItem& item) const;
   String getReceiveJsonKeyPath_(const ReceiveItem& item) const;
@@ -1519,6 +1524,7 @@ inline void MQTTManager::update() {
 }
 
 inline void MQTTManager::loop() {
+  CM_LOOP_SCOPE(MQTT);
   if (!settings_.enableMQTT.get()) {
     if (state_ != ConnectionState::Disconnected) {
       disconnect();
@@ -1799,6 +1805,7 @@ inline void MQTTManager::addTopicReceiveFloat(const char* id,
   item.jsonKeyNameC = makeCString_(item.label + String(" JSON Key"));
 
   receiveItems_.push_back(std::move(item));
+  receiveSettingsValid_ = false;
 }
 
 inline void MQTTManager::addTopicReceiveInt(const char* id,
@@ -1826,6 +1833,7 @@ inline void MQTTManager::addTopicReceiveInt(const char* id,
   item.jsonKeyNameC = makeCString_(item.label + String(" JSON Key"));
 
   receiveItems_.push_back(std::move(item));
+  receiveSettingsValid_ = false;
 }
 
 inline void MQTTManager::addTopicReceiveBool(const char* id,
@@ -1850,6 +1858,7 @@ inline void MQTTManager::addTopicReceiveBool(const char* id,
   item.jsonKeyNameC = makeCString_(item.label + String(" JSON Key"));
 
   receiveItems_.push_back(std::move(item));
+  receiveSettingsValid_ = false;
 }
 
 inline void MQTTManager::addTopicReceiveString(const char* id,
@@ -1874,6 +1883,7 @@ inline void MQTTManager::addTopicReceiveString(const char* id,
   item.jsonKeyNameC = makeCString_(item.label + String(" JSON Key"));
 
   receiveItems_.push_back(std::move(item));
+  receiveSettingsValid_ = false;
 }
 
 inline void MQTTManager::configureFromSettings_() {
@@ -2147,6 +2157,7 @@ inline void MQTTManager::handleReceiveItems_(const char* topic, const byte* payl
   if (!topic) {
     return;
   }
+  refreshReceiveItems_();
 
   String incomingTopic(topic);
   incomingTopic.trim();
@@ -2159,7 +2170,7 @@ inline void MQTTManager::handleReceiveItems_(const char* topic, const byte* payl
     if (!item.target) {
       continue;
     }
-    const String configuredTopic = getReceiveTopic_(item);
+    const String& configuredTopic = item.resolvedTopic;
     if (configuredTopic.isEmpty()) {
       continue;
     }
@@ -2169,7 +2180,7 @@ inline void MQTTManager::handleReceiveItems_(const char* topic, const byte* payl
     matchedAny = true;
 
     String extracted;
-    const String keyPath = getReceiveJsonKeyPath_(item);
+    const String& keyPath = item.resolvedKeyPath;
     const bool hasJson = normalizedPayload.startsWith("{") || normalizedPayload.startsWith("[");
     bool ok = false;
 
@@ -2242,6 +2253,21 @@ inline void MQTTManager::handleReceiveItems_(const char* topic, const byte* payl
   }
 }
 
+// Topic and JSON key path only change with the settings epoch; resolve them once per change
+// instead of copying and trimming both Strings for every item on every incoming message.
+inline void MQTTManager::refreshReceiveItems_() {
+  const uint32_t epoch = ConfigManagerClass::getSettingsEpoch();
+  if (receiveSettingsValid_ && epoch == receiveSettingsEpoch_) {
+    return;
+  }
+  receiveSettingsEpoch_ = epoch;
+  receiveSettingsValid_ = true;
+  for (auto& item : receiveItems_) {
+    item.resolvedTopic = getReceiveTopic_(item);
+    item.resolvedKeyPath = getReceiveJsonKeyPath_(item);
+  }
+}
+
 inline void MQTTManager::updateReceiveSubscription_(ReceiveItem& item, bool force) {
   const String nextTopic = getReceiveTopic_(item);
   if (!force && nextTopic == item.lastSubscribedTopic) {
@@ -83,6 +83,10 @@ void ConfigManagerOTA::setup(const String& hostname, const String& password) {
     }
 
     ArduinoOTA.onStart([this]() {
+      // Commit queued setting writes before flash is busy with the update.
+      if (configManager) {
+        configManager->flush();
+      }
       setActive(true);
       String type = (ArduinoOTA.getCommand() == U_FLASH) ? "sketch" : "filesystem";
       OTA_LOG("Start updating %s", type.c_str());
@@ -230,7 +234,11 @@ void ConfigManagerOTA::handleOTAUpload(AsyncWebServerRequest* request) {
 
   if (ctx->hasError) {
     OTA_LOG("Upload failed: %s", ctx->errorReason.c_str());
-    request->send(ctx->statusCode, "application/json", String("{\"status\":\"error\",\"reason\":\"") + ctx->errorReason + "\"}");
+    AsyncWebServerResponse* response = request->beginResponse(ctx->statusCode, "application/json", String("{\"status\":\"error\",\"reason\":\"") + ctx->errorReason + "\"}");
+    if (ctx->statusCode == 503) {
+      response->addHeader("Retry-After", String(CM_HTTP_RETRY_AFTER_S));
+    }
+    request->send(response);
     cleanup(request);
     return;
   }
@@ -245,7 +253,12 @@ void ConfigManagerOTA::handleOTAUpload(AsyncWebServerRequest* request) {
   AsyncWebServerResponse* response = request->beginResponse(200, "application/json", "{\"status\":\"ok\",\"action\":\"reboot\"}");
   response->addHeader("Connection", "close");
 
-  request->onDisconnect([this]() {
+  // onDisconnect keeps a single callback, so this one also releases the admission slot.
+  const bool admitted = ctx->admitted;
+  request->onDisconnect([this, admitted]() {
+    if (admitted && configManager) {
+      configManager->getWebManager().getAdmission().release(cm::web::RequestClass::Critical);
+    }
     OTA_LOG("HTTP client disconnected, rebooting...");
     delay(500);
     if (rebootCallback) {
@@ -268,6 +281,15 @@ void ConfigManagerOTA::handleOTAUploadData(AsyncWebServerRequest* request, Strin
     ctx = new OtaUploadContext();
     request->_tempObject = ctx;
 
+    // Critical admission class; a refused upload leaves a running update alone.
+    if (configManager && configManager->getWebManager().acquireRequestSlot(request, cm::web::RequestClass::Critical) != cm::web::AdmissionController::Decision::Admitted) {
+      ctx->hasError = true;
+      ctx->statusCode = 503;
+      ctx->errorReason = "busy";
+      return;
+    }
+    ctx->admitted = configManager != nullptr;
+
     if (Update.isRunning()) {
       OTA_LOG("Existing update in progress, aborting prior session");
       Update.abort();
@@ -297,6 +319,11 @@ void ConfigManagerOTA::handleOTAUploadData(AsyncWebServerRequest* request, Strin
       }
     }
     ctx->authorized = true;
+    // Commit queued setting writes before flash is busy with the update. This runs on
+    // the web server task, so the loop does the NVS writes.
+    if (configManager && !configManager->flushOnLoop(CM_OTA_FLUSH_TIMEOUT_MS)) {
+      OTA_LOG("Settings flush timed out; pending writes stay queued");
+    }
 
     size_t expected = request->contentLength();
     if (expected == 0) {
@@ -20,6 +20,7 @@ struct OtaUploadContext {
   bool began = false;
   bool success = false;
   bool probe = false;
+  bool admitted = false; // Holds a Critical admission slot until disconnect
   int statusCode = 200;
   String errorReason;
   size_t written = 0;
@@ -0,0 +1,119 @@
+#include "LoopProfiler.h"
+
+namespace {
+
+constexpr const char* SECTION_NAMES[cm::runtime::LoopProfiler::SECTIONS] = {
+  "loop", "handleClient", "wsPush", "ota", "mqtt", "io", "alarms", "logging"};
+
+cm::runtime::LoopProfiler profiler;
+
+uint32_t bucketUpperUs(size_t bucket) {
+  return bucket == 0 ? 0 : static_cast<uint32_t>((1ull << bucket) - 1);
+}
+
+// Upper bound of the bucket holding the permille-th sample, capped at the maximum.
+uint32_t percentileUs(const uint32_t (&buckets)[cm::runtime::LoopProfiler::BUCKETS], uint32_t count, uint32_t maxUs, uint32_t permille) {
+  if (count == 0) {
+    return 0;
+  }
+  const uint64_t target = (static_cast<uint64_t>(count) * permille + 999) / 1000;
+  uint64_t seen = 0;
+  for (size_t b = 0; b < cm::runtime::LoopProfiler::BUCKETS; ++b) {
+    seen += buckets[b];
+    if (seen >= target) {
+      const uint32_t upper = bucketUpperUs(b);
+      return b + 1 == cm::runtime::LoopProfiler::BUCKETS || upper > maxUs ? maxUs : upper;
+    }
+  }
+  return maxUs;
+}
+
+} // namespace
+
+cm::runtime::LoopProfiler& cm::runtime::LoopProfiler::instance() {
+  return profiler;
+}
+
+const char* cm::runtime::LoopProfiler::sectionName(LoopSection section) {
+  const size_t index = static_cast<size_t>(section);
+  return index < SECTIONS ? SECTION_NAMES[index] : "";
+}
+
+size_t cm::runtime::LoopProfiler::bucketOf(uint32_t us) {
+  const size_t bits = us == 0 ? 0 : static_cast<size_t>(32 - __builtin_clz(us));
+  return bits < BUCKETS ? bits : BUCKETS - 1;
+}
+
+void cm::runtime::LoopProfiler::record(LoopSection section, uint32_t us) {
+  const size_t index = static_cast<size_t>(section);
+  if (index >= SECTIONS) {
+    return;
+  }
+  Histogram& h = sections_[index];
+  h.buckets[bucketOf(us)].fetch_add(1, std::memory_order_relaxed);
+  if (us > h.maxUs.load(std::memory_order_relaxed)) {
+    h.maxUs.store(us, std::memory_order_relaxed);
+  }
+}
+
+void cm::runtime::LoopProfiler::markLoop(int64_t nowUs) {
+  if (lastLoopUs_ != 0) {
+    record(LoopSection::Loop, static_cast<uint32_t>(nowUs - lastLoopUs_));
+  }
+  lastLoopUs_ = nowUs;
+}
+
+void cm::runtime::LoopProfiler::reset() {
+  for (Histogram& h : sections_) {
+    for (auto& bucket : h.buckets) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+    h.maxUs.store(0, std::memory_order_relaxed);
+  }
+}
+
+cm::runtime::LoopSectionStats cm::runtime::LoopProfiler::stats(LoopSection section) const {
+  LoopSectionStats result;
+  const size_t index = static_cast<size_t>(section);
+  if (index >= SECTIONS) {
+    return result;
+  }
+  const Histogram& h = sections_[index];
+  uint32_t buckets[BUCKETS];
+  uint32_t count = 0;
+  for (size_t b = 0; b < BUCKETS; ++b) {
+    buckets[b] = h.buckets[b].load(std::memory_order_relaxed);
+    count += buckets[b];
+  }
+  result.name = SECTION_NAMES[index];
+  result.count = count;
+  result.maxUs = h.maxUs.load(std::memory_order_relaxed);
+  result.p50Us = percentileUs(buckets, count, result.maxUs, 500);
+  result.p99Us = percentileUs(buckets, count, result.maxUs, 990);
+  return result;
+}
+
+void cm::runtime::LoopProfiler::toJSON(JsonObject out, bool withBuckets) const {
+  for (size_t i = 0; i < SECTIONS; ++i) {
+    const LoopSectionStats s = stats(static_cast<LoopSection>(i));
+    if (s.count == 0) {
+      continue;
+    }
+    JsonObject entry = out[s.name].to<JsonObject>();
+    entry["count"] = s.count;
+    entry["p50Us"] = s.p50Us;
+    entry["p99Us"] = s.p99Us;
+    entry["maxUs"] = s.maxUs;
+    if (withBuckets) {
+      // Trailing empty buckets are left out.
+      size_t used = BUCKETS;
+      while (used > 0 && sections_[i].buckets[used - 1].load(std::memory_order_relaxed) == 0) {
+        --used;
+      }
+      JsonArray buckets = entry["buckets"].to<JsonArray>();
+      for (size_t b = 0; b < used; ++b) {
+        buckets.add(sections_[i].buckets[b].load(std::memory_order_relaxed));
+      }
+    }
+  }
+}
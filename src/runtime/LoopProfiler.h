@@ -0,0 +1,100 @@
+#pragma once
+
+#include <ArduinoJson.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <esp_timer.h>
+
+#include "../ConfigManagerConfig.h"
+
+namespace cm::runtime {
+
+// Instrumented parts of the sketch loop. Sections nest: HandleClient includes
+// WebSocketPush and OTA.
+enum class LoopSection : uint8_t {
+  Loop,          // Time between two handleClient() calls, i.e. one sketch loop
+  HandleClient,
+  WebSocketPush,
+  OTA,
+  MQTT,
+  IO,
+  Alarms,
+  Logging,
+};
+
+struct LoopSectionStats {
+  const char* name = "";
+  uint32_t count = 0;
+  uint32_t p50Us = 0; // Percentiles are the upper bound of their log2 bucket, capped at maxUs
+  uint32_t p99Us = 0;
+  uint32_t maxUs = 0;
+};
+
+// Fixed-size log2 histograms of loop section durations. Bucket b counts durations in
+// [2^(b-1), 2^b) microseconds (bucket 0: below 1 us), the last bucket everything
+// longer. Recording is a few relaxed atomic updates and never allocates.
+//
+// Written by the loop task and read by the web server task; a reader can see a
+// sample that is counted in one field but not yet in another.
+class LoopProfiler {
+public:
+  static constexpr size_t SECTIONS = 8;
+  static constexpr size_t BUCKETS = 24; // Last bucket starts at ~4.2 s
+
+  // The profiler the CM_LOOP_SCOPE() timers report to.
+  static LoopProfiler& instance();
+  static const char* sectionName(LoopSection section);
+
+  void record(LoopSection section, uint32_t us);
+  // Records the time since the previous call as one Loop sample.
+  void markLoop(int64_t nowUs);
+  void reset();
+
+  LoopSectionStats stats(LoopSection section) const;
+  // {"<section>":{"count":..,"p50Us":..,"p99Us":..,"maxUs":..[,"buckets":[..]]},...}
+  // Sections without samples are left out.
+  void toJSON(JsonObject out, bool withBuckets) const;
+
+private:
+  struct Histogram {
+    std::atomic<uint32_t> buckets[BUCKETS] = {};
+    std::atomic<uint32_t> maxUs{0};
+  };
+
+  Histogram sections_[SECTIONS];
+  int64_t lastLoopUs_ = 0; // Loop task only
+
+  static size_t bucketOf(uint32_t us);
+};
+
+// Times the enclosing scope; see CM_LOOP_SCOPE().
+class LoopScope {
+public:
+  explicit LoopScope(LoopSection section)
+      : section_(section), startUs_(esp_timer_get_time()) {}
+  ~LoopScope() {
+    LoopProfiler::instance().record(section_, static_cast<uint32_t>(esp_timer_get_time() - startUs_));
+  }
+
+  LoopScope(const LoopScope&) = delete;
+  LoopScope& operator=(const LoopScope&) = delete;
+
+private:
+  LoopSection section_;
+  int64_t startUs_;
+};
+
+} // namespace cm::runtime
+
+// CM_LOOP_SCOPE(MQTT) times the rest of the enclosing block; CM_LOOP_MARK() ends one
+// sketch loop. Both compile to nothing with CM_ENABLE_LOOP_PROFILER=0.
+#if CM_ENABLE_LOOP_PROFILER
+#define CM_LOOP_SCOPE_JOIN_(a, b) a##b
+#define CM_LOOP_SCOPE_NAME_(line) CM_LOOP_SCOPE_JOIN_(cmLoopScope_, line)
+#define CM_LOOP_SCOPE(section) ::cm::runtime::LoopScope CM_LOOP_SCOPE_NAME_(__LINE__)(::cm::runtime::LoopSection::section)
+#define CM_LOOP_MARK() ::cm::runtime::LoopProfiler::instance().markLoop(esp_timer_get_time())
+#else
+#define CM_LOOP_SCOPE(section) ((void)0)
+#define CM_LOOP_MARK() ((void)0)
+#endif
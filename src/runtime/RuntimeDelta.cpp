@@ -0,0 +1,210 @@
+#include "RuntimeDelta.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr uint32_t FNV32_OFFSET = 2166136261u;
+constexpr uint32_t FNV32_PRIME = 16777619u;
+constexpr uint8_t GROUP_KEY_SEPARATOR = 0x1F;
+
+uint32_t fnv1a(uint32_t hash, const char* data, size_t len) {
+  for (size_t i = 0; i < len; ++i) {
+    hash = (hash ^ static_cast<uint8_t>(data[i])) * FNV32_PRIME;
+  }
+  return hash;
+}
+
+// Hashes serialized JSON without materializing it.
+class HashPrint final : public Print {
+public:
+  size_t write(uint8_t c) override {
+    hash_ = (hash_ ^ c) * FNV32_PRIME;
+    return 1;
+  }
+
+  size_t write(const uint8_t* data, size_t size) override {
+    hash_ = fnv1a(hash_, reinterpret_cast<const char*>(data), size);
+    return size;
+  }
+
+  uint32_t hash() const {
+    return hash_;
+  }
+
+private:
+  uint32_t hash_ = FNV32_OFFSET;
+};
+
+constexpr uint8_t FIELD_SEPARATOR = 0x1E;
+
+uint32_t fieldKeyHash(JsonString group, JsonString key) {
+  return cm::runtime::runtimeFieldHash(group.c_str(), group.size(), key.c_str(), key.size());
+}
+
+// The top-level uptime changes on every frame, so it never marks a delta as changed;
+// it rides along with deltas that carry other fields and with every keyframe.
+bool isUptime(JsonString group, JsonString key) {
+  return group.isNull() && key.size() == 6 && memcmp(key.c_str(), "uptime", 6) == 0;
+}
+
+uint32_t valueHash(JsonVariantConst value) {
+  HashPrint sink;
+  serializeJson(value, sink);
+  return sink.hash();
+}
+
+// Calls visit(group, key, value) for every field; top-level scalars use an empty group.
+template <typename Visitor>
+void forEachField(JsonObjectConst root, Visitor&& visit) {
+  for (JsonPairConst entry : root) {
+    JsonObjectConst fields = entry.value().as<JsonObjectConst>();
+    if (fields.isNull()) {
+      visit(JsonString(), entry.key(), entry.value());
+      continue;
+    }
+    for (JsonPairConst field : fields) {
+      visit(entry.key(), field.key(), field.value());
+    }
+  }
+}
+
+} // namespace
+
+uint32_t cm::runtime::runtimeFieldHash(const char* group, size_t groupLen, const char* key, size_t keyLen) {
+  uint32_t hash = fnv1a(FNV32_OFFSET, group, groupLen);
+  hash = (hash ^ GROUP_KEY_SEPARATOR) * FNV32_PRIME;
+  return fnv1a(hash, key, keyLen);
+}
+
+void cm::runtime::RuntimeFieldIds::add(const String& group, const String& key) {
+  byHash_.push_back({runtimeFieldHash(group.c_str(), group.length(), key.c_str(), key.length()), count_++});
+  tableHash_ = fnv1a(tableHash_, group.c_str(), group.length());
+  tableHash_ = (tableHash_ ^ GROUP_KEY_SEPARATOR) * FNV32_PRIME;
+  tableHash_ = fnv1a(tableHash_, key.c_str(), key.length());
+  tableHash_ = (tableHash_ ^ FIELD_SEPARATOR) * FNV32_PRIME;
+}
+
+void cm::runtime::RuntimeFieldIds::finish() {
+  std::stable_sort(byHash_.begin(), byHash_.end(), [](const Entry& a, const Entry& b) {
+    return a.fieldHash < b.fieldHash;
+  });
+  byHash_.erase(std::unique(byHash_.begin(), byHash_.end(), [](const Entry& a, const Entry& b) {
+                  return a.fieldHash == b.fieldHash;
+                }),
+                byHash_.end());
+}
+
+int cm::runtime::RuntimeFieldIds::find(uint32_t fieldHash) const {
+  auto it = std::lower_bound(byHash_.begin(), byHash_.end(), fieldHash, [](const Entry& entry, uint32_t hash) {
+    return entry.fieldHash < hash;
+  });
+  return it != byHash_.end() && it->fieldHash == fieldHash ? it->id : -1;
+}
+
+void cm::runtime::writeCompactValues(JsonObjectConst values, const RuntimeFieldIds& ids, JsonObject out) {
+  out["ids"] = ids.tableHash();
+  JsonArray fields = out["f"].to<JsonArray>();
+  JsonObject rest = out["x"].to<JsonObject>();
+  forEachField(values, [&](JsonString group, JsonString key, JsonVariantConst value) {
+    const int id = ids.find(fieldKeyHash(group, key));
+    if (id >= 0) {
+      fields.add(id);
+      fields.add(value);
+      return;
+    }
+    if (group.isNull()) {
+      rest[key] = value;
+      return;
+    }
+    JsonObject slot = rest[group].as<JsonObject>();
+    if (slot.isNull()) {
+      slot = rest[group].to<JsonObject>();
+    }
+    slot[key] = value;
+  });
+}
+
+JsonVariantConst cm::runtime::RuntimeDeltaEncoder::next(JsonObjectConst full, bool keyframe, JsonDocument& delta) {
+  if (keyframe) {
+    fields_.clear();
+    forEachField(full, [this](JsonString group, JsonString key, JsonVariantConst value) {
+      if (isUptime(group, key)) {
+        return;
+      }
+      fields_.push_back({fieldKeyHash(group, key), valueHash(value)});
+    });
+    std::sort(fields_.begin(), fields_.end(), [](const FieldState& a, const FieldState& b) {
+      return a.keyHash < b.keyHash;
+    });
+    seq_ = 0;
+    lastChanged_ = fields_.size();
+    lastKeyframeBytes_ = measureJson(full);
+    return full;
+  }
+
+  delta.clear();
+  delta["type"] = "runtimeDelta";
+  delta["seq"] = static_cast<uint16_t>(seq_ + 1);
+  JsonObject values = delta["values"].to<JsonObject>();
+  size_t changed = 0;
+  forEachField(full, [&](JsonString group, JsonString key, JsonVariantConst value) {
+    if (isUptime(group, key)) {
+      values[key] = value;
+      return;
+    }
+    if (!update(fieldKeyHash(group, key), valueHash(value))) {
+      return;
+    }
+    ++changed;
+    if (group.isNull()) {
+      values[key] = value;
+      return;
+    }
+    JsonObject slot = values[group].as<JsonObject>();
+    if (slot.isNull()) {
+      slot = values[group].to<JsonObject>();
+    }
+    slot[key] = value;
+  });
+
+  lastChanged_ = changed;
+  if (changed == 0) {
+    return JsonVariantConst();
+  }
+  ++seq_;
+  return delta.as<JsonVariantConst>();
+}
+
+bool cm::runtime::RuntimeDeltaEncoder::encode(JsonObjectConst full, bool keyframe, String& out) {
+  out = String();
+  JsonDocument delta;
+  const JsonVariantConst frame = next(full, keyframe, delta);
+  if (frame.isNull()) {
+    return false;
+  }
+  serializeJson(frame, out);
+  return true;
+}
+
+void cm::runtime::RuntimeDeltaEncoder::reset() {
+  fields_.clear();
+  seq_ = 0;
+  lastChanged_ = 0;
+}
+
+bool cm::runtime::RuntimeDeltaEncoder::update(uint32_t keyHash, uint32_t valueHash) {
+  auto it = std::lower_bound(fields_.begin(), fields_.end(), keyHash, [](const FieldState& field, uint32_t hash) {
+    return field.keyHash < hash;
+  });
+  if (it != fields_.end() && it->keyHash == keyHash) {
+    if (it->valueHash == valueHash) {
+      return false;
+    }
+    it->valueHash = valueHash;
+    return true;
+  }
+  fields_.insert(it, {keyHash, valueHash});
+  return true;
+}
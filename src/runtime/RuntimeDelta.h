@@ -0,0 +1,103 @@
+#pragma once
+
+#include <ArduinoJson.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cm::runtime {
+
+// FNV-1a over group, 0x1F, key: the field identity used by delta and compact frames.
+uint32_t runtimeFieldHash(const char* group, size_t groupLen, const char* key, size_t keyLen);
+
+// Numeric field IDs published by /runtime_meta.json: the ID of an entry is its
+// position in that array. The table hash covers (source group, key) of every entry
+// in ID order, so a client can check that its metadata matches a compact frame.
+class RuntimeFieldIds {
+public:
+  // Assigns the next ID to (group, key); call in runtime_meta.json order.
+  void add(const String& group, const String& key);
+  // Sorts the lookup table; the first ID wins for fields listed more than once.
+  void finish();
+  // Returns -1 for fields without an ID.
+  int find(uint32_t fieldHash) const;
+
+  uint32_t tableHash() const {
+    return tableHash_;
+  }
+  size_t size() const {
+    return count_;
+  }
+
+private:
+  struct Entry {
+    uint32_t fieldHash;
+    uint16_t id;
+  };
+
+  std::vector<Entry> byHash_;
+  uint32_t tableHash_ = 2166136261u;
+  uint16_t count_ = 0;
+};
+
+// Writes the members of a runtime values object (a full frame or delta `values`) in
+// compact form into `out`: "ids" (table hash), "f" (flat [id, value, ...] array for
+// fields with an ID) and "x" (the remaining fields, keyed as in /runtime.json).
+void writeCompactValues(JsonObjectConst values, const RuntimeFieldIds& ids, JsonObject out);
+
+// Builds delta-encoded WebSocket runtime frames.
+//
+// A keyframe is the full /runtime.json object, unchanged. A delta frame only carries
+// the fields whose value changed since the previous frame:
+//   {"type":"runtimeDelta","seq":<n>,"values":{"<group>":{"<key>":<value>},"uptime":<ms>}}
+// `seq` restarts at 1 after every keyframe, so a client that sees a gap knows it
+// missed a frame and must resynchronize (next keyframe or /runtime.json).
+//
+// Fields are tracked as (group, key) -> hash of the serialized value. Nested objects
+// and arrays below a group key are compared as one value. Fields that disappear are
+// only dropped on the client with the next keyframe. The top-level `uptime` is not
+// tracked: it is sent with every non-empty delta, so idle frames are skipped.
+class RuntimeDeltaEncoder {
+public:
+  // Updates the tracked values and returns the frame to send: `full` itself for a
+  // keyframe, otherwise the delta built into `delta` (pass a document on the frame
+  // arena so deltas do not allocate from the heap). Returns a null variant when a
+  // delta frame would not contain any field.
+  JsonVariantConst next(JsonObjectConst full, bool keyframe, JsonDocument& delta);
+
+  // next() serialized as JSON into `out`; false (and `out` empty) for an empty delta.
+  // Builds the delta on the default allocator.
+  bool encode(JsonObjectConst full, bool keyframe, String& out);
+
+  // Forgets all tracked values; the next encode() should be a keyframe.
+  void reset();
+
+  uint16_t sequence() const {
+    return seq_;
+  }
+  size_t trackedFields() const {
+    return fields_.size();
+  }
+  size_t lastChangedFields() const {
+    return lastChanged_;
+  }
+  // Size of the most recent keyframe, used as the full-frame reference for deltas.
+  size_t lastKeyframeBytes() const {
+    return lastKeyframeBytes_;
+  }
+
+private:
+  struct FieldState {
+    uint32_t keyHash;
+    uint32_t valueHash;
+  };
+
+  std::vector<FieldState> fields_; // Sorted by keyHash
+  uint16_t seq_ = 0;
+  size_t lastChanged_ = 0;
+  size_t lastKeyframeBytes_ = 0;
+
+  bool update(uint32_t keyHash, uint32_t valueHash);
+};
+
+} // namespace cm::runtime
@@ -0,0 +1,188 @@
+#include "RuntimeFrameArena.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <esp_heap_caps.h>
+
+namespace {
+
+constexpr size_t ARENA_ALIGN = 8;
+
+size_t alignedSize(size_t size) {
+  return (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+}
+
+class HeapAllocator final : public ArduinoJson::Allocator {
+public:
+  void* allocate(size_t size) override {
+    return malloc(size);
+  }
+  void deallocate(void* ptr) override {
+    free(ptr);
+  }
+  void* reallocate(void* ptr, size_t newSize) override {
+    return realloc(ptr, newSize);
+  }
+};
+
+HeapAllocator heapAllocator;
+
+} // namespace
+
+cm::runtime::RuntimeFrameArena::~RuntimeFrameArena() {
+  free(block_);
+}
+
+bool cm::runtime::RuntimeFrameArena::reserve(size_t capacity) {
+  if (block_) {
+    return true;
+  }
+  capacity_ = alignedSize(capacity);
+  if (capacity_ == 0) {
+    return false;
+  }
+  block_ = static_cast<uint8_t*>(heap_caps_malloc(capacity_, MALLOC_CAP_8BIT));
+  return block_ != nullptr;
+}
+
+bool cm::runtime::RuntimeFrameArena::owns(const void* ptr) const {
+  const uint8_t* p = static_cast<const uint8_t*>(ptr);
+  return block_ && p >= block_ && p < block_ + capacity_;
+}
+
+cm::runtime::RuntimeFrameArena::Header* cm::runtime::RuntimeFrameArena::headerOf(void* ptr) const {
+  return reinterpret_cast<Header*>(static_cast<uint8_t*>(ptr) - sizeof(Header));
+}
+
+void* cm::runtime::RuntimeFrameArena::allocate(size_t size) {
+  const size_t needed = sizeof(Header) + alignedSize(size);
+  if (!block_ || needed > capacity_ - used_) {
+    overflows_.fetch_add(1, std::memory_order_relaxed);
+    return malloc(size);
+  }
+  Header* header = reinterpret_cast<Header*>(block_ + used_);
+  header->size = static_cast<uint32_t>(size);
+  header->previous = last_;
+  last_ = static_cast<uint32_t>(used_);
+  used_ += needed;
+  ++live_;
+  if (used_ > highWater_.load(std::memory_order_relaxed)) {
+    highWater_.store(used_, std::memory_order_relaxed);
+  }
+  return header + 1;
+}
+
+void cm::runtime::RuntimeFrameArena::deallocate(void* ptr) {
+  if (!ptr) {
+    return;
+  }
+  if (!owns(ptr)) {
+    free(ptr);
+    return;
+  }
+  Header* header = headerOf(ptr);
+  const uint32_t offset = static_cast<uint32_t>(reinterpret_cast<uint8_t*>(header) - block_);
+  if (--live_ == 0) {
+    used_ = 0;
+    last_ = NONE;
+  } else if (offset == last_) {
+    used_ = offset;
+    last_ = header->previous;
+  }
+}
+
+void* cm::runtime::RuntimeFrameArena::reallocate(void* ptr, size_t newSize) {
+  if (!ptr) {
+    return allocate(newSize);
+  }
+  if (!owns(ptr)) {
+    return realloc(ptr, newSize);
+  }
+  Header* header = headerOf(ptr);
+  const size_t offset = static_cast<size_t>(reinterpret_cast<uint8_t*>(header) - block_);
+  const size_t needed = sizeof(Header) + alignedSize(newSize);
+  // The most recent allocation (typically a string being built) grows or shrinks in place.
+  if (offset == last_ && needed <= capacity_ - offset) {
+    header->size = static_cast<uint32_t>(newSize);
+    used_ = offset + needed;
+    if (used_ > highWater_.load(std::memory_order_relaxed)) {
+      highWater_.store(used_, std::memory_order_relaxed);
+    }
+    return ptr;
+  }
+  void* moved = allocate(newSize);
+  if (!moved) {
+    return nullptr;
+  }
+  memcpy(moved, ptr, header->size < newSize ? header->size : newSize);
+  deallocate(ptr);
+  return moved;
+}
+
+cm::runtime::RuntimeFrameArenaPool::Lease::Lease(Lease&& other) noexcept
+    : pool_(other.pool_), slot_(other.slot_), allocator_(other.allocator_) {
+  other.pool_ = nullptr;
+}
+
+cm::runtime::RuntimeFrameArenaPool::Lease::~Lease() {
+  if (pool_) {
+    pool_->release(slot_);
+  }
+}
+
+cm::runtime::RuntimeFrameArenaPool::RuntimeFrameArenaPool(size_t arenaBytes)
+    : arenaBytes_(arenaBytes) {
+  for (auto& busy : busy_) {
+    busy.store(false);
+  }
+}
+
+void cm::runtime::RuntimeFrameArenaPool::reserve() {
+  if (arenaBytes_ == 0) {
+    return;
+  }
+  for (size_t i = 0; i < ARENAS; ++i) {
+    bool expected = false;
+    if (busy_[i].compare_exchange_strong(expected, true)) {
+      arenas_[i].reserve(arenaBytes_);
+      busy_[i].store(false);
+    }
+  }
+}
+
+cm::runtime::RuntimeFrameArenaPool::Lease cm::runtime::RuntimeFrameArenaPool::acquire() {
+  if (arenaBytes_ > 0) {
+    for (size_t i = 0; i < ARENAS; ++i) {
+      bool expected = false;
+      if (busy_[i].compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+        if (!arenas_[i].reserved()) {
+          arenas_[i].reserve(arenaBytes_);
+        }
+        leases_.fetch_add(1, std::memory_order_relaxed);
+        return Lease(this, i, &arenas_[i]);
+      }
+    }
+    busyFallbacks_.fetch_add(1, std::memory_order_relaxed);
+  }
+  return Lease(nullptr, ARENAS, &heapAllocator);
+}
+
+void cm::runtime::RuntimeFrameArenaPool::release(size_t slot) {
+  if (slot < ARENAS) {
+    busy_[slot].store(false, std::memory_order_release);
+  }
+}
+
+cm::runtime::RuntimeFrameArenaStats cm::runtime::RuntimeFrameArenaPool::stats() const {
+  RuntimeFrameArenaStats result;
+  result.arenaBytes = arenaBytes_;
+  result.leases = leases_.load(std::memory_order_relaxed);
+  result.busyFallbacks = busyFallbacks_.load(std::memory_order_relaxed);
+  for (const auto& arena : arenas_) {
+    result.overflows += arena.overflows();
+    if (arena.highWaterBytes() > result.highWaterBytes) {
+      result.highWaterBytes = arena.highWaterBytes();
+    }
+  }
+  return result;
+}
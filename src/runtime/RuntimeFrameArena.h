@@ -0,0 +1,120 @@
+#pragma once
+
+#include <ArduinoJson.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace cm::runtime {
+
+// ArduinoJson allocator over one block that is allocated once and reused for every
+// runtime frame. Allocations are bumped from the block and it rewinds when the last
+// one is released, so building a frame does not touch the heap as long as the frame
+// fits. Larger frames spill over to malloc (counted as overflows).
+//
+// Not thread-safe: one document set at a time, see RuntimeFrameArenaPool.
+class RuntimeFrameArena final : public ArduinoJson::Allocator {
+public:
+  explicit RuntimeFrameArena(size_t capacity = 0)
+      : capacity_(capacity) {}
+  ~RuntimeFrameArena();
+
+  RuntimeFrameArena(const RuntimeFrameArena&) = delete;
+  RuntimeFrameArena& operator=(const RuntimeFrameArena&) = delete;
+
+  // Allocates the block; call early, while the heap is still in one piece.
+  bool reserve(size_t capacity);
+  bool reserved() const {
+    return block_ != nullptr;
+  }
+
+  void* allocate(size_t size) override;
+  void deallocate(void* ptr) override;
+  void* reallocate(void* ptr, size_t newSize) override;
+
+  size_t capacity() const {
+    return capacity_;
+  }
+  size_t highWaterBytes() const {
+    return highWater_.load(std::memory_order_relaxed);
+  }
+  uint32_t overflows() const {
+    return overflows_.load(std::memory_order_relaxed);
+  }
+
+private:
+  struct Header {
+    uint32_t size;
+    uint32_t previous; // Offset of the allocation made before this one
+  };
+
+  static constexpr uint32_t NONE = UINT32_MAX;
+
+  uint8_t* block_ = nullptr;
+  size_t capacity_;
+  size_t used_ = 0;
+  uint32_t last_ = NONE;
+  size_t live_ = 0;
+  std::atomic<size_t> highWater_{0};
+  std::atomic<uint32_t> overflows_{0};
+
+  bool owns(const void* ptr) const;
+  Header* headerOf(void* ptr) const;
+};
+
+struct RuntimeFrameArenaStats {
+  size_t arenaBytes = 0;       // Per arena
+  size_t highWaterBytes = 0;   // Largest frame seen in any arena
+  uint32_t leases = 0;         // Frames built in an arena
+  uint32_t overflows = 0;      // Allocations that did not fit and went to the heap
+  uint32_t busyFallbacks = 0;  // Frames built on the heap because both arenas were in use
+};
+
+// Two arenas, so the WebSocket push (loop task) and /runtime.json (web server task)
+// can build frames at the same time. A third concurrent frame uses the heap.
+class RuntimeFrameArenaPool {
+public:
+  static constexpr size_t ARENAS = 2;
+
+  // Keeps one arena (or the heap fallback) until destroyed; documents that use
+  // allocator() must be destroyed first.
+  class Lease {
+  public:
+    Lease(Lease&& other) noexcept;
+    Lease& operator=(Lease&&) = delete;
+    Lease(const Lease&) = delete;
+    Lease& operator=(const Lease&) = delete;
+    ~Lease();
+
+    ArduinoJson::Allocator* allocator() const {
+      return allocator_;
+    }
+
+  private:
+    friend class RuntimeFrameArenaPool;
+    Lease(RuntimeFrameArenaPool* pool, size_t slot, ArduinoJson::Allocator* allocator)
+        : pool_(pool), slot_(slot), allocator_(allocator) {}
+
+    RuntimeFrameArenaPool* pool_;
+    size_t slot_;
+    ArduinoJson::Allocator* allocator_;
+  };
+
+  explicit RuntimeFrameArenaPool(size_t arenaBytes);
+
+  // Allocates both arenas up front (otherwise on first use). 0 bytes disables the pool.
+  void reserve();
+  Lease acquire();
+  RuntimeFrameArenaStats stats() const;
+
+private:
+  RuntimeFrameArena arenas_[ARENAS];
+  std::atomic<bool> busy_[ARENAS];
+  size_t arenaBytes_;
+  std::atomic<uint32_t> leases_{0};
+  std::atomic<uint32_t> busyFallbacks_{0};
+
+  void release(size_t slot);
+};
+
+} // namespace cm::runtime
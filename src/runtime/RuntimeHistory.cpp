@@ -0,0 +1,190 @@
+#include "RuntimeHistory.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <new>
+
+namespace {
+
+constexpr const char* RESOLUTION_NAMES[cm::runtime::RuntimeHistory::RESOLUTIONS] = {"1s", "1m", "15m"};
+constexpr uint32_t RESOLUTION_SECONDS[cm::runtime::RuntimeHistory::RESOLUTIONS] = {1, 60, 900};
+
+constexpr cm::runtime::RuntimeHistoryBucket GAP_BUCKET = {
+  cm::runtime::RuntimeHistory::GAP, cm::runtime::RuntimeHistory::GAP, cm::runtime::RuntimeHistory::GAP};
+
+} // namespace
+
+cm::runtime::RuntimeHistory::RuntimeHistory(size_t maxFields, const uint16_t (&capacities)[RESOLUTIONS])
+    : maxFields_(maxFields) {
+  for (size_t r = 0; r < RESOLUTIONS; ++r) {
+    capacities_[r] = capacities[r] > 0 ? capacities[r] : 1;
+    bucketsPerField_ += capacities_[r];
+  }
+  if (maxFields_ > 0) {
+    pool_.reset(new (std::nothrow) RuntimeHistoryBucket[maxFields_ * bucketsPerField_]);
+    if (!pool_) {
+      maxFields_ = 0;
+    }
+  }
+  fields_.reserve(maxFields_);
+}
+
+const char* cm::runtime::RuntimeHistory::resolutionName(size_t resolution) {
+  return resolution < RESOLUTIONS ? RESOLUTION_NAMES[resolution] : "";
+}
+
+uint32_t cm::runtime::RuntimeHistory::resolutionIntervalMs(size_t resolution) {
+  return resolution < RESOLUTIONS ? RESOLUTION_SECONDS[resolution] * 1000u : 0;
+}
+
+int cm::runtime::RuntimeHistory::resolutionIndex(const char* name) {
+  if (!name) {
+    return -1;
+  }
+  for (size_t r = 0; r < RESOLUTIONS; ++r) {
+    if (strcmp(name, RESOLUTION_NAMES[r]) == 0) {
+      return static_cast<int>(r);
+    }
+  }
+  return -1;
+}
+
+bool cm::runtime::RuntimeHistory::addField(const String& group, const String& key, float scale, std::function<float()> source) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (fields_.size() >= maxFields_ || !source) {
+    return false;
+  }
+  for (const Field& existing : fields_) {
+    // Cppcheck rationale: Keep the allocation-free, early-exit loop on the embedded target.
+    // cppcheck-suppress useStlAlgorithm
+    if (existing.group == group && existing.key == key) {
+      return false;
+    }
+  }
+
+  Field field;
+  field.group = group;
+  field.key = key;
+  field.scale = scale > 0.0f ? scale : 1.0f;
+  field.source = std::move(source);
+  RuntimeHistoryBucket* storage = pool_.get() + fields_.size() * bucketsPerField_;
+  for (size_t r = 0; r < RESOLUTIONS; ++r) {
+    field.rings[r].buckets = storage;
+    field.rings[r].capacity = capacities_[r];
+    storage += capacities_[r];
+  }
+  fields_.push_back(std::move(field));
+  return true;
+}
+
+void cm::runtime::RuntimeHistory::sample(unsigned long nowMs) {
+  const uint32_t tick = static_cast<uint32_t>(nowMs / 1000);
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (tick == lastTick_) {
+    return;
+  }
+  lastTick_ = tick;
+  for (Field& field : fields_) {
+    record(field, tick, quantize(field.source(), field.scale));
+  }
+}
+
+bool cm::runtime::RuntimeHistory::read(const String& group, const String& key, size_t resolution, RuntimeHistorySeries& out) const {
+  if (resolution >= RESOLUTIONS) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const Field& field : fields_) {
+    if (field.key != key || (group.length() && field.group != group)) {
+      continue;
+    }
+    const Ring& ring = field.rings[resolution];
+    const Accumulator& acc = field.acc[resolution];
+    out.scale = field.scale;
+    out.intervalMs = resolutionIntervalMs(resolution);
+    out.buckets.clear();
+    if (!field.started) {
+      out.startMs = 0;
+      return true;
+    }
+    out.startMs = (acc.bucket - ring.count) * out.intervalMs;
+    out.buckets.reserve(ring.count + 1u);
+    for (uint16_t i = 0; i < ring.count; ++i) {
+      out.buckets.push_back(ring.buckets[(ring.head + i) % ring.capacity]);
+    }
+    out.buckets.push_back(close(acc));
+    return true;
+  }
+  return false;
+}
+
+size_t cm::runtime::RuntimeHistory::fieldCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return fields_.size();
+}
+
+int16_t cm::runtime::RuntimeHistory::quantize(float value, float scale) {
+  if (!std::isfinite(value)) {
+    return GAP;
+  }
+  const float q = std::round(value / scale);
+  if (q >= static_cast<float>(INT16_MAX)) {
+    return INT16_MAX;
+  }
+  if (q <= -static_cast<float>(INT16_MAX)) {
+    return -INT16_MAX; // INT16_MIN marks gaps
+  }
+  return static_cast<int16_t>(q);
+}
+
+void cm::runtime::RuntimeHistory::push(Ring& ring, const RuntimeHistoryBucket& bucket) {
+  if (ring.count < ring.capacity) {
+    ring.buckets[(ring.head + ring.count) % ring.capacity] = bucket;
+    ++ring.count;
+    return;
+  }
+  ring.buckets[ring.head] = bucket;
+  ring.head = static_cast<uint16_t>((ring.head + 1) % ring.capacity);
+}
+
+cm::runtime::RuntimeHistoryBucket cm::runtime::RuntimeHistory::close(const Accumulator& acc) {
+  if (acc.count == 0) {
+    return GAP_BUCKET;
+  }
+  const int32_t half = acc.sum >= 0 ? acc.count / 2 : -(acc.count / 2);
+  return {acc.min, static_cast<int16_t>((acc.sum + half) / acc.count), acc.max};
+}
+
+void cm::runtime::RuntimeHistory::record(Field& field, uint32_t tick, int16_t value) {
+  for (size_t r = 0; r < RESOLUTIONS; ++r) {
+    Accumulator& acc = field.acc[r];
+    Ring& ring = field.rings[r];
+    const uint32_t bucket = tick / RESOLUTION_SECONDS[r];
+    if (!field.started) {
+      acc.bucket = bucket;
+    } else if (bucket != acc.bucket) {
+      push(ring, close(acc));
+      // Buckets the loop never sampled (it was blocked) become gaps; bounded by the ring.
+      const uint32_t skipped = std::min<uint32_t>(bucket - acc.bucket - 1, ring.capacity);
+      for (uint32_t i = 0; i < skipped; ++i) {
+        push(ring, GAP_BUCKET);
+      }
+      acc = Accumulator();
+      acc.bucket = bucket;
+    }
+    if (value == GAP) {
+      continue;
+    }
+    if (acc.count == 0) {
+      acc.min = value;
+      acc.max = value;
+    } else {
+      acc.min = std::min(acc.min, value);
+      acc.max = std::max(acc.max, value);
+    }
+    acc.sum += value;
+    ++acc.count;
+  }
+  field.started = true;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace cm::runtime {
+
+// One history bucket: quantized min/avg/max (value = q * scale).
+struct RuntimeHistoryBucket {
+  int16_t min;
+  int16_t avg;
+  int16_t max;
+};
+
+// Copy of one field's buckets at one resolution, oldest first. The last bucket is
+// the one still being filled. Buckets without samples hold RuntimeHistory::GAP.
+struct RuntimeHistorySeries {
+  float scale = 1.0f;
+  uint32_t intervalMs = 0;
+  uint32_t startMs = 0; // Uptime at the start of the first bucket
+  std::vector<RuntimeHistoryBucket> buckets;
+};
+
+// Fixed-size ring buffers of quantized samples for opted-in runtime fields.
+//
+// Each field is sampled once per second and kept at three resolutions (1 s, 1 min,
+// 15 min) as min/avg/max buckets of int16 values with a per-field scale. All rings
+// are carved out of one allocation sized for maxFields when the store is created,
+// so memory does not grow with uptime. A sample costs O(1) per field.
+class RuntimeHistory {
+public:
+  static constexpr size_t RESOLUTIONS = 3;
+  static constexpr int16_t GAP = INT16_MIN;
+
+  // capacities: buckets kept per resolution (1 s, 1 min, 15 min).
+  RuntimeHistory(size_t maxFields, const uint16_t (&capacities)[RESOLUTIONS]);
+
+  // "1s", "1m", "15m"
+  static const char* resolutionName(size_t resolution);
+  static uint32_t resolutionIntervalMs(size_t resolution);
+  // Returns -1 for unknown names.
+  static int resolutionIndex(const char* name);
+
+  // False when all maxFields slots are taken or (group, key) is already recorded.
+  bool addField(const String& group, const String& key, float scale, std::function<float()> source);
+  // Call often (e.g. every loop); samples once per second of uptime.
+  void sample(unsigned long nowMs);
+  bool read(const String& group, const String& key, size_t resolution, RuntimeHistorySeries& out) const;
+
+  size_t fieldCount() const;
+  size_t maxFields() const {
+    return maxFields_;
+  }
+  // Bucket storage reserved for maxFields, in bytes.
+  size_t memoryBytes() const {
+    return maxFields_ * bucketsPerField_ * sizeof(RuntimeHistoryBucket);
+  }
+
+private:
+  struct Accumulator {
+    uint32_t bucket = 0; // Bucket index since boot (uptime / interval)
+    int32_t sum = 0;
+    uint16_t count = 0;
+    int16_t min = 0;
+    int16_t max = 0;
+  };
+
+  struct Ring {
+    RuntimeHistoryBucket* buckets = nullptr;
+    uint16_t capacity = 0;
+    uint16_t head = 0; // Oldest bucket
+    uint16_t count = 0;
+  };
+
+  struct Field {
+    String group;
+    String key;
+    float scale = 1.0f;
+    std::function<float()> source;
+    Ring rings[RESOLUTIONS];
+    Accumulator acc[RESOLUTIONS];
+    bool started = false;
+  };
+
+  mutable std::mutex mutex_;
+  std::vector<Field> fields_;
+  std::unique_ptr<RuntimeHistoryBucket[]> pool_;
+  size_t maxFields_;
+  uint16_t capacities_[RESOLUTIONS];
+  size_t bucketsPerField_ = 0;
+  uint32_t lastTick_ = UINT32_MAX;
+
+  static int16_t quantize(float value, float scale);
+  static void push(Ring& ring, const RuntimeHistoryBucket& bucket);
+  static RuntimeHistoryBucket close(const Accumulator& acc);
+  void record(Field& field, uint32_t tick, int16_t value);
+};
+
+} // namespace cm::runtime
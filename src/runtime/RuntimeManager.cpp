@@ -1,8 +1,11 @@
 #include "RuntimeManager.h"
 #include "../ConfigManager.h"
 #include <algorithm>
+#include <cstring>
 #include <esp_heap_caps.h>
+#include <esp_timer.h>
 #include <limits>
+#include <new>
 #include <utility>
 #include <time.h>
 
@@ -42,6 +45,7 @@ void logRuntimeMetaSerializationFailure(const char* reason, size_t requiredBytes
               static_cast<unsigned>(fieldCount));
 }
 
+// Members of one /runtime_meta.json entry except "id", which the payload build prepends.
 void populateRuntimeMetaJson(JsonObject o, const RuntimeFieldMeta& m) {
   o["group"] = m.group;
   if (m.sourceGroup.length()) {
@@ -97,6 +101,8 @@ void populateRuntimeMetaJson(JsonObject o, const RuntimeFieldMeta& m) {
     o["max"] = m.floatMax;
     o["init"] = m.floatInit;
   }
+  if (m.hasHistory)
+    o["history"] = true;
   if (m.hasAlarm)
     o["hasAlarm"] = true;
   if (m.alarmWhenTrue)
@@ -144,25 +150,213 @@ void populateRuntimeMetaJson(JsonObject o, const RuntimeFieldMeta& m) {
   }
 }
 
-size_t runtimeMetaJsonSize(const RuntimeFieldMeta& meta) {
+// Serializes the entry as `"group":...}`, i.e. without the opening brace, so the
+// payload build can write `{"id":<n>,` in front of it.
+bool serializeRuntimeMetaFragment(const RuntimeFieldMeta& meta, String& out) {
   StaticJsonDocument<1536> entryDoc;
   populateRuntimeMetaJson(entryDoc.to<JsonObject>(), meta);
-  return measureJson(entryDoc);
+  const size_t size = measureJson(entryDoc);
+  out = String();
+  if (size < 3 || !out.reserve(size)) {
+    return false;
+  }
+  StringAppendPrint writer(out);
+  if (serializeJson(entryDoc, writer) != size || out.length() != size) {
+    out = String();
+    return false;
+  }
+  out.remove(0, 1);
+  return true;
 }
 
-bool appendRuntimeMetaJson(String& out, const RuntimeFieldMeta& meta) {
-  StaticJsonDocument<1536> entryDoc;
-  populateRuntimeMetaJson(entryDoc.to<JsonObject>(), meta);
-  const size_t offset = out.length();
-  StringAppendPrint writer(out);
-  const size_t written = serializeJson(entryDoc, writer);
-  return written != 0 && out.length() == offset + written;
+// `{"id":<n>,` in front of each fragment; returns its length.
+size_t formatRuntimeMetaIdPrefix(char (&buffer)[24], size_t id) {
+  const int written = snprintf(buffer, sizeof(buffer), "{\"id\":%u,", static_cast<unsigned>(id));
+  return written > 0 ? static_cast<size_t>(written) : 0;
+}
+
+bool runtimeMetaLess(const RuntimeFieldMeta& a, const RuntimeFieldMeta& b) {
+  if (a.group == b.group) {
+    if (a.order == b.order)
+      return a.label < b.label;
+    return a.order < b.order;
+  }
+  return a.group < b.group;
+}
+
+template <typename Control>
+void writeControlValue(JsonObject& slot, const Control& control) {
+  if (control.getter) {
+    slot[control.key] = control.getter();
+  }
+}
+
+void serializeFrame(JsonVariantConst frame, String* json, std::vector<uint8_t>* msgpack) {
+  if (json) {
+    *json = String();
+    serializeJson(frame, *json);
+  }
+  if (msgpack) {
+    msgpack->resize(measureMsgPack(frame));
+    serializeMsgPack(frame, msgpack->data(), msgpack->size());
+  }
+}
+
+// Print over a caller buffer of exactly the measured frame size.
+class FixedBufferPrint final : public Print {
+public:
+  FixedBufferPrint(uint8_t* buffer, size_t capacity)
+      : buffer_(buffer), capacity_(capacity) {}
+
+  size_t write(uint8_t byte) override {
+    return write(&byte, 1);
+  }
+
+  size_t write(const uint8_t* data, size_t size) override {
+    const size_t take = std::min(size, capacity_ - used_);
+    memcpy(buffer_ + used_, data, take);
+    used_ += take;
+    return take;
+  }
+
+private:
+  uint8_t* buffer_;
+  size_t capacity_;
+  size_t used_ = 0;
+};
+
+void serializeShared(JsonVariantConst frame, bool msgpack, const std::function<uint8_t*(size_t)>& reserve) {
+  const size_t size = msgpack ? measureMsgPack(frame) : measureJson(frame);
+  uint8_t* buffer = reserve(size);
+  if (!buffer) {
+    return;
+  }
+  FixedBufferPrint out(buffer, size);
+  if (msgpack) {
+    serializeMsgPack(frame, out);
+  } else {
+    serializeJson(frame, out);
+  }
+}
+
+void recordProviderFill(RuntimeProviderCache& cache, int64_t startUs) {
+  const uint32_t elapsed = static_cast<uint32_t>(esp_timer_get_time() - startUs);
+  cache.misses.fetch_add(1, std::memory_order_relaxed);
+  cache.lastFillUs.store(elapsed, std::memory_order_relaxed);
+  uint32_t previousMax = cache.maxFillUs.load(std::memory_order_relaxed);
+  while (elapsed > previousMax && !cache.maxFillUs.compare_exchange_weak(previousMax, elapsed, std::memory_order_relaxed)) {
+  }
+}
+
+// Calls the provider when it is due, otherwise copies its cached fragment into slot.
+void fillProviderSlot(const RuntimeValueProvider& provider, RuntimeProviderCache& cache, JsonObject& slot, unsigned long now) {
+  if (!provider.fill) {
+    return;
+  }
+  if (provider.refreshIntervalMs == 0) {
+    const int64_t start = esp_timer_get_time();
+    provider.fill(slot);
+    recordProviderFill(cache, start);
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  const bool dirty = cache.dirty.exchange(false);
+  if (dirty || !cache.valid || now - cache.lastFillMs >= provider.refreshIntervalMs) {
+    const int64_t start = esp_timer_get_time();
+    JsonObject fresh = cache.fragment.to<JsonObject>();
+    provider.fill(fresh);
+    cache.lastFillMs = now;
+    cache.valid = true;
+    recordProviderFill(cache, start);
+  } else {
+    cache.hits.fetch_add(1, std::memory_order_relaxed);
+  }
+  for (JsonPairConst member : cache.fragment.as<JsonObjectConst>()) {
+    slot[member.key()] = member.value();
+  }
 }
 
 } // namespace
 
+size_t RuntimeControlRegistry::groupIndex(const String& name) {
+  for (size_t i = 0; i < groups.size(); ++i) {
+    // Cppcheck rationale: Keep the allocation-free, early-exit loop on the embedded target.
+    // cppcheck-suppress useStlAlgorithm
+    if (groups[i].name == name) {
+      return i;
+    }
+  }
+  RuntimeControlGroup created;
+  created.name = name;
+  groups.push_back(std::move(created));
+  return groups.size() - 1;
+}
+
+void RuntimeControlRegistry::addProvider(const RuntimeValueProvider& provider) {
+  // Insert after providers with the same order so registration order breaks ties.
+  auto it = std::upper_bound(providers.begin(), providers.end(), provider.order, [](int order, const RuntimeValueProvider& existing) {
+    return order < existing.order;
+  });
+  const size_t position = static_cast<size_t>(it - providers.begin());
+  const size_t group = groupIndex(provider.name);
+  groups[group].hasProvider = true;
+  providers.insert(it, provider);
+
+  RuntimeProviderLink link;
+  link.group = static_cast<uint16_t>(group);
+  link.cache = std::make_shared<RuntimeProviderCache>();
+  providerLinks.insert(providerLinks.begin() + position, link);
+  for (size_t i = 0; i < providerLinks.size(); ++i) {
+    providerLinks[i].lastInGroup = true;
+    for (size_t j = i + 1; j < providerLinks.size(); ++j) {
+      if (providerLinks[j].group == providerLinks[i].group) {
+        providerLinks[i].lastInGroup = false;
+        break;
+      }
+    }
+  }
+}
+
+void RuntimeControlRegistry::indexControl(RuntimeControlRef::Kind kind, const String& group, size_t index) {
+  std::vector<RuntimeControlRef>& controls = groups[groupIndex(group)].controls;
+  RuntimeControlRef ref;
+  ref.kind = kind;
+  ref.index = static_cast<uint16_t>(index);
+  auto it = std::upper_bound(controls.begin(), controls.end(), kind, [](RuntimeControlRef::Kind value, const RuntimeControlRef& existing) {
+    return value < existing.kind;
+  });
+  controls.insert(it, ref);
+}
+
+void RuntimeControlRegistry::writeControls(JsonObject& slot, const RuntimeControlGroup& group) const {
+  using Kind = RuntimeControlRef::Kind;
+  for (const RuntimeControlRef& ref : group.controls) {
+    switch (ref.kind) {
+      case Kind::Checkbox:
+        writeControlValue(slot, checkboxes[ref.index]);
+        break;
+      case Kind::StateButton:
+        writeControlValue(slot, stateButtons[ref.index]);
+        break;
+      case Kind::IntSlider:
+        writeControlValue(slot, intSliders[ref.index]);
+        break;
+      case Kind::FloatSlider:
+        writeControlValue(slot, floatSliders[ref.index]);
+        break;
+      case Kind::IntInput:
+        writeControlValue(slot, intInputs[ref.index]);
+        break;
+      case Kind::FloatInput:
+        writeControlValue(slot, floatInputs[ref.index]);
+        break;
+    }
+  }
+}
+
 ConfigManagerRuntime::ConfigManagerRuntime()
-    : configManager(nullptr)
+    : configManager(nullptr), runtimeRegistry(std::make_shared<RuntimeControlRegistry>())
 #if CM_ENABLE_SYSTEM_PROVIDER
       ,
       builtinSystemProviderEnabled(false), builtinSystemProviderRegistered(false), loopWindowStart(0), loopSamples(0), loopAccumMs(0.0), loopAvgMs(0.0)
@@ -175,12 +369,16 @@ ConfigManagerRuntime::~ConfigManagerRuntime() {
 
 void ConfigManagerRuntime::begin(ConfigManagerClass* cm) {
   configManager = cm;
+  frameArenas.reserve();
   RUNTIME_LOG("Runtime manager initialized");
   if (configManager) {
     std::vector<RuntimeFieldMeta> metaSnapshot;
     {
       std::lock_guard<std::mutex> lock(runtimeDataMutex);
-      metaSnapshot = runtimeMeta;
+      metaSnapshot.reserve(runtimeMeta.size());
+      for (const RuntimeMetaEntry& entry : runtimeMeta) {
+        metaSnapshot.push_back(entry.meta);
+      }
     }
     for (const auto& meta : metaSnapshot) {
       configManager->registerLivePlacement(meta);
@@ -192,16 +390,68 @@ void ConfigManagerRuntime::setLogCallback(LogCallback logger) {
   logCallback = logger;
 }
 
-void ConfigManagerRuntime::addRuntimeProvider(const RuntimeValueProvider& provider) {
-  {
-    std::lock_guard<std::mutex> lock(runtimeDataMutex);
-    runtimeProviders.push_back(provider);
+void ConfigManagerRuntime::updateRegistry(const std::function<void(RuntimeControlRegistry&)>& mutate) {
+  std::lock_guard<std::mutex> lock(runtimeDataMutex);
+  // Readers only take references under this mutex, so a use count of one means no
+  // snapshot is out and the registry can be extended in place (the common case at boot).
+  if (runtimeRegistry.use_count() != 1) {
+    runtimeRegistry = std::make_shared<RuntimeControlRegistry>(*runtimeRegistry);
   }
+  mutate(*runtimeRegistry);
+}
+
+std::shared_ptr<const RuntimeControlRegistry> ConfigManagerRuntime::getControlRegistry() const {
+  std::lock_guard<std::mutex> lock(runtimeDataMutex);
+  return runtimeRegistry;
+}
+
+void ConfigManagerRuntime::addRuntimeProvider(const RuntimeValueProvider& provider) {
+  updateRegistry([&provider](RuntimeControlRegistry& registry) { registry.addProvider(provider); });
   RUNTIME_LOG("Added provider: %s (order: %d)", provider.name.c_str(), provider.order);
 }
 
-void ConfigManagerRuntime::addRuntimeProvider(const String& name, std::function<void(JsonObject&)> fillFunc, int order) {
-  addRuntimeProvider(RuntimeValueProvider(name, fillFunc, order));
+void ConfigManagerRuntime::addRuntimeProvider(const String& name, std::function<void(JsonObject&)> fillFunc, int order, uint32_t refreshIntervalMs) {
+  addRuntimeProvider(RuntimeValueProvider(name, fillFunc, order, refreshIntervalMs));
+}
+
+bool ConfigManagerRuntime::markRuntimeProviderDirty(const String& name) {
+  const std::shared_ptr<const RuntimeControlRegistry> registry = getControlRegistry();
+  bool found = false;
+  for (size_t i = 0; i < registry->providers.size(); ++i) {
+    if (registry->providers[i].name == name) {
+      registry->providerLinks[i].cache->dirty.store(true);
+      found = true;
+    }
+  }
+  return found;
+}
+
+std::vector<RuntimeProviderStats> ConfigManagerRuntime::getRuntimeProviderStats() const {
+  const std::shared_ptr<const RuntimeControlRegistry> registry = getControlRegistry();
+  std::vector<RuntimeProviderStats> stats;
+  stats.reserve(registry->providers.size());
+  for (size_t i = 0; i < registry->providers.size(); ++i) {
+    const RuntimeProviderCache& cache = *registry->providerLinks[i].cache;
+    RuntimeProviderStats entry;
+    entry.name = registry->providers[i].name;
+    entry.refreshIntervalMs = registry->providers[i].refreshIntervalMs;
+    entry.hits = cache.hits.load(std::memory_order_relaxed);
+    entry.misses = cache.misses.load(std::memory_order_relaxed);
+    entry.lastFillUs = cache.lastFillUs.load(std::memory_order_relaxed);
+    entry.maxFillUs = cache.maxFillUs.load(std::memory_order_relaxed);
+    stats.push_back(std::move(entry));
+  }
+  return stats;
+}
+
+void ConfigManagerRuntime::resetRuntimeProviderStats() {
+  const std::shared_ptr<const RuntimeControlRegistry> registry = getControlRegistry();
+  for (const RuntimeProviderLink& link : registry->providerLinks) {
+    link.cache->hits.store(0);
+    link.cache->misses.store(0);
+    link.cache->lastFillUs.store(0);
+    link.cache->maxFillUs.store(0);
+  }
 }
 
 void ConfigManagerRuntime::addRuntimeMeta(const RuntimeFieldMeta& meta) {
@@ -215,7 +465,8 @@ void ConfigManagerRuntime::addRuntimeMeta(const RuntimeFieldMeta& meta) {
   {
     std::lock_guard<std::mutex> cacheLock(runtimeMetaCacheMutex);
     std::lock_guard<std::mutex> dataLock(runtimeDataMutex);
-    runtimeMeta.push_back(normalized);
+    runtimeMeta.push_back(RuntimeMetaEntry{normalized, String()});
+    runtimeMetaSortDirty = true;
     markRuntimeMetaJsonCacheDirtyLocked();
   }
   // Cppcheck rationale: The value is consumed by a compile-time logging macro in enabled builds.
@@ -234,11 +485,17 @@ bool ConfigManagerRuntime::updateRuntimeMeta(const String& group, const String&
 
   std::lock_guard<std::mutex> cacheLock(runtimeMetaCacheMutex);
   std::lock_guard<std::mutex> dataLock(runtimeDataMutex);
-  for (auto& meta : runtimeMeta) {
-    // Cppcheck rationale: Keep the allocation-free, early-exit loop on the embedded target.
-    // cppcheck-suppress useStlAlgorithm
+  for (size_t i = 0; i < runtimeMeta.size(); ++i) {
+    RuntimeFieldMeta& meta = runtimeMeta[i].meta;
     if (meta.key == key && (meta.group == group || meta.sourceGroup == group)) {
       updater(meta);
+      // Only this entry is serialized again; the list is re-sorted only if the
+      // update moved it past a neighbour.
+      runtimeMeta[i].fragment = String();
+      if ((i > 0 && runtimeMetaLess(meta, runtimeMeta[i - 1].meta)) ||
+          (i + 1 < runtimeMeta.size() && runtimeMetaLess(runtimeMeta[i + 1].meta, meta))) {
+        runtimeMetaSortDirty = true;
+      }
       markRuntimeMetaJsonCacheDirtyLocked();
       return true;
     }
@@ -246,13 +503,13 @@ bool ConfigManagerRuntime::updateRuntimeMeta(const String& group, const String&
   return false;
 }
 
-RuntimeFieldMeta* ConfigManagerRuntime::findRuntimeMeta(const String& group, const String& key) {
+const RuntimeFieldMeta* ConfigManagerRuntime::findRuntimeMeta(const String& group, const String& key) const {
   std::lock_guard<std::mutex> lock(runtimeDataMutex);
-  for (auto& meta : runtimeMeta) {
+  for (const auto& entry : runtimeMeta) {
     // Cppcheck rationale: Keep the allocation-free, early-exit loop on the embedded target.
     // cppcheck-suppress useStlAlgorithm
-    if (meta.key == key && (meta.group == group || meta.sourceGroup == group)) {
-      return &meta;
+    if (entry.meta.key == key && (entry.meta.group == group || entry.meta.sourceGroup == group)) {
+      return &entry.meta;
     }
   }
   return nullptr;
@@ -280,199 +537,142 @@ const RuntimeAlarm* ConfigManagerRuntime::findAlarm(const String& name) const {
   return nullptr;
 }
 
-String ConfigManagerRuntime::runtimeValuesToJSON() {
-  // Must stay small enough for frequent WS pushes, but large enough for typical runtime payloads.
-  DynamicJsonDocument d(4096);
-  JsonObject root = d.to<JsonObject>();
-  root["uptime"] = millis();
-
-  std::vector<RuntimeValueProvider> providersSnapshot;
-  std::vector<RuntimeCheckbox> checkboxesSnapshot;
-  std::vector<RuntimeStateButton> stateButtonsSnapshot;
-  std::vector<RuntimeIntSlider> intSlidersSnapshot;
-  std::vector<RuntimeFloatSlider> floatSlidersSnapshot;
-  std::vector<RuntimeIntInput> intInputsSnapshot;
-  std::vector<RuntimeFloatInput> floatInputsSnapshot;
-  std::vector<RuntimeAlarm> alarmsSnapshot;
-  {
-    std::lock_guard<std::mutex> lock(runtimeDataMutex);
-    providersSnapshot = runtimeProviders;
-    checkboxesSnapshot = runtimeCheckboxes;
-    stateButtonsSnapshot = runtimeStateButtons;
-    intSlidersSnapshot = runtimeIntSliders;
-    floatSlidersSnapshot = runtimeFloatSliders;
-    intInputsSnapshot = runtimeIntInputs;
-    floatInputsSnapshot = runtimeFloatInputs;
-    alarmsSnapshot = runtimeAlarms;
-  }
-
-  // Do not sort runtimeProviders in-place here: runtimeValuesToJSON() can be called from
-  // multiple contexts (WS push + HTTP handlers). In-place std::sort would introduce data races.
-  std::vector<const RuntimeValueProvider*> providers;
-  providers.reserve(providersSnapshot.size());
-  for (const auto& prov : providersSnapshot) {
-    // Cppcheck rationale: Keep the allocation-free, early-exit loop on the embedded target.
-    // cppcheck-suppress useStlAlgorithm
-    providers.push_back(&prov);
-  }
-  std::sort(providers.begin(), providers.end(), [](const RuntimeValueProvider* a, const RuntimeValueProvider* b) {
-    return a->order < b->order;
-  });
-
-  for (const auto* provPtr : providers) {
-    if (!provPtr) {
-      continue;
+size_t ConfigManagerRuntime::fillRuntimeValues(JsonObject root) {
+  const unsigned long now = millis();
+  root["uptime"] = now;
+
+  // Shares the registry snapshot: no copies of the provider/control vectors per push.
+  const std::shared_ptr<const RuntimeControlRegistry> registry = getControlRegistry();
+
+  // Providers first (sorted by order), each followed by its group's controls;
+  // then groups that only have controls. Every control is visited once.
+  for (size_t i = 0; i < registry->providers.size(); ++i) {
+    const RuntimeValueProvider& prov = registry->providers[i];
+    const RuntimeProviderLink& link = registry->providerLinks[i];
+    JsonObject slot = root[prov.name].as<JsonObject>();
+    if (slot.isNull()) {
+      slot = root[prov.name].to<JsonObject>();
     }
-    const auto& prov = *provPtr;
-    JsonObject slot;
-    JsonVariant existing = root[prov.name];
-    if (existing.isNull()) {
-      slot = root.createNestedObject(prov.name);
-    } else if (existing.is<JsonObject>()) {
-      slot = existing.as<JsonObject>();
-    } else {
-      root.remove(prov.name);
-      slot = root.createNestedObject(prov.name);
-    }
-    if (prov.fill) {
-      prov.fill(slot);
-    }
-
-    // Add interactive control states for this provider/group
-    for (auto& checkbox : checkboxesSnapshot) {
-      if (checkbox.group == prov.name && checkbox.getter) {
-        slot[checkbox.key] = checkbox.getter();
-      }
-    }
-
-    for (auto& button : stateButtonsSnapshot) {
-      if (button.group == prov.name && button.getter) {
-        slot[button.key] = button.getter();
-      }
-    }
-
-    for (auto& slider : intSlidersSnapshot) {
-      if (slider.group == prov.name && slider.getter) {
-        slot[slider.key] = slider.getter();
-      }
-    }
-
-    for (auto& slider : floatSlidersSnapshot) {
-      if (slider.group == prov.name && slider.getter) {
-        slot[slider.key] = slider.getter();
-      }
+    fillProviderSlot(prov, *link.cache, slot, now);
+    if (link.lastInGroup) {
+      registry->writeControls(slot, registry->groups[link.group]);
     }
+  }
 
-    for (auto& input : intInputsSnapshot) {
-      if (input.group == prov.name && input.getter) {
-        slot[input.key] = input.getter();
-      }
+  // Interactive controls must be present even when no provider exists for their group.
+  // Otherwise the frontend cannot retrieve the latest values after refresh and may snap
+  // back to defaults (e.g. sliders to 0).
+  for (const RuntimeControlGroup& group : registry->groups) {
+    if (group.hasProvider || group.controls.empty()) {
+      continue;
     }
+    JsonObject slot = root[group.name].to<JsonObject>();
+    registry->writeControls(slot, group);
+  }
 
-    for (auto& input : floatInputsSnapshot) {
-      if (input.group == prov.name && input.getter) {
-        slot[input.key] = input.getter();
+  // Alarm states change at runtime, so they are read in place instead of snapshotted.
+  size_t alarmCount = 0;
+  {
+    std::lock_guard<std::mutex> lock(runtimeDataMutex);
+    alarmCount = runtimeAlarms.size();
+    if (alarmCount > 0) {
+      JsonObject alarms = root.createNestedObject("alarms");
+      for (const auto& a : runtimeAlarms) {
+        alarms[a.name] = a.active;
       }
     }
   }
 
-  // Ensure interactive controls are present even when no runtime provider exists for their group.
-  // Otherwise the frontend cannot retrieve the latest values after refresh and may snap back
-  // to defaults (e.g. sliders to 0).
-  auto getOrCreateSlot = [&](const String& groupName) -> JsonObject {
-    JsonObject slot;
-    JsonVariant existing = root[groupName];
-    if (existing.isNull()) {
-      slot = root.createNestedObject(groupName);
-    } else if (existing.is<JsonObject>()) {
-      slot = existing.as<JsonObject>();
-    } else {
-      root.remove(groupName);
-      slot = root.createNestedObject(groupName);
-    }
-    return slot;
-  };
-
-  for (auto& checkbox : checkboxesSnapshot) {
-    if (checkbox.getter) {
-      JsonObject slot = getOrCreateSlot(checkbox.group);
-      slot[checkbox.key] = checkbox.getter();
-    }
+  size_t estimatedBytes = 512;
+  estimatedBytes += registry->providers.size() * 96;
+  estimatedBytes += registry->checkboxes.size() * 24;
+  estimatedBytes += registry->stateButtons.size() * 24;
+  estimatedBytes += registry->intSliders.size() * 28;
+  estimatedBytes += registry->floatSliders.size() * 28;
+  estimatedBytes += registry->intInputs.size() * 28;
+  estimatedBytes += registry->floatInputs.size() * 28;
+  estimatedBytes += alarmCount * 16;
+  if (estimatedBytes > 8192) {
+    estimatedBytes = 8192;
   }
+  return estimatedBytes;
+}
 
-  for (auto& button : stateButtonsSnapshot) {
-    if (button.getter) {
-      JsonObject slot = getOrCreateSlot(button.group);
-      slot[button.key] = button.getter();
-    }
-  }
+String ConfigManagerRuntime::runtimeValuesToJSON() {
+  // Built in a reused arena, so frequent requests do not churn the heap.
+  const cm::runtime::RuntimeFrameArenaPool::Lease arena = frameArenas.acquire();
+  JsonDocument d(arena.allocator());
+  const size_t estimatedBytes = fillRuntimeValues(d.to<JsonObject>());
 
-  for (auto& slider : intSlidersSnapshot) {
-    if (slider.getter) {
-      JsonObject slot = getOrCreateSlot(slider.group);
-      slot[slider.key] = slider.getter();
-    }
+  String out;
+  out.reserve(estimatedBytes);
+  const size_t written = serializeJson(d, out);
+  if (written == 0 || out.length() == 0 || out[0] != '{') {
+    // Never return an empty/invalid frame; the WebUI expects a JSON object.
+    return "{}";
   }
+  return out;
+}
 
-  for (auto& slider : floatSlidersSnapshot) {
-    if (slider.getter) {
-      JsonObject slot = getOrCreateSlot(slider.group);
-      slot[slider.key] = slider.getter();
-    }
+bool ConfigManagerRuntime::runtimeFrame(bool delta, bool keyframe, const RuntimeFrameTargets& targets) {
+  const cm::runtime::RuntimeFrameArenaPool::Lease arena = frameArenas.acquire();
+  JsonDocument d(arena.allocator());
+  fillRuntimeValues(d.to<JsonObject>());
+  JsonDocument deltaDoc(arena.allocator());
+  const JsonVariantConst frame = delta ? runtimeDeltaEncoder.next(d.as<JsonObjectConst>(), keyframe, deltaDoc) : d.as<JsonVariantConst>();
+  if (frame.isNull()) {
+    return false;
   }
+  serializeFrame(frame, targets.json, targets.msgpack);
 
-  for (auto& input : intInputsSnapshot) {
-    if (input.getter) {
-      JsonObject slot = getOrCreateSlot(input.group);
-      slot[input.key] = input.getter();
-    }
+  const bool shared = static_cast<bool>(targets.reserveShared);
+  const bool sharedCompact = shared && (targets.sharedEncoding == RuntimeFrameEncoding::CompactJson || targets.sharedEncoding == RuntimeFrameEncoding::CompactMsgPack);
+  if (shared && !sharedCompact) {
+    serializeShared(frame, targets.sharedEncoding == RuntimeFrameEncoding::MsgPack, targets.reserveShared);
   }
 
-  for (auto& input : floatInputsSnapshot) {
-    if (input.getter) {
-      JsonObject slot = getOrCreateSlot(input.group);
-      slot[input.key] = input.getter();
+  if (targets.compactJson || targets.compactMsgpack || sharedCompact) {
+    const std::shared_ptr<const cm::runtime::RuntimeFieldIds> ids = getRuntimeFieldIds();
+    const cm::runtime::RuntimeFieldIds noIds;
+    JsonDocument compact(arena.allocator());
+    JsonObject out = compact.to<JsonObject>();
+    if (delta && !keyframe) {
+      out["type"] = "runtimeDelta";
+      out["seq"] = frame["seq"];
+      cm::runtime::writeCompactValues(frame["values"].as<JsonObjectConst>(), ids ? *ids : noIds, out);
+    } else {
+      out["type"] = "runtimeCompact";
+      cm::runtime::writeCompactValues(frame.as<JsonObjectConst>(), ids ? *ids : noIds, out);
     }
-  }
-
-  if (!alarmsSnapshot.empty()) {
-    JsonObject alarms = root.createNestedObject("alarms");
-    // Cppcheck rationale: Avoid changing mutable callback and integration handles without a call-site audit.
-    // cppcheck-suppress constVariableReference
-    for (auto& a : alarmsSnapshot) {
-      alarms[a.name] = a.active;
+    serializeFrame(compact.as<JsonVariantConst>(), targets.compactJson, targets.compactMsgpack);
+    if (sharedCompact) {
+      serializeShared(compact.as<JsonVariantConst>(), targets.sharedEncoding == RuntimeFrameEncoding::CompactMsgPack, targets.reserveShared);
     }
   }
+  return true;
+}
 
-  String out;
-  size_t estimatedBytes = 512;
-  estimatedBytes += providersSnapshot.size() * 96;
-  estimatedBytes += checkboxesSnapshot.size() * 24;
-  estimatedBytes += stateButtonsSnapshot.size() * 24;
-  estimatedBytes += intSlidersSnapshot.size() * 28;
-  estimatedBytes += floatSlidersSnapshot.size() * 28;
-  estimatedBytes += intInputsSnapshot.size() * 28;
-  estimatedBytes += floatInputsSnapshot.size() * 28;
-  estimatedBytes += alarmsSnapshot.size() * 16;
-  if (estimatedBytes > 8192) {
-    estimatedBytes = 8192;
-  }
-  out.reserve(estimatedBytes);
-  const size_t written = serializeJson(d, out);
-  if (written == 0 || out.length() == 0 || out[0] != '{') {
-    // Never return an empty/invalid frame; the WebUI expects a JSON object.
-    return "{}";
-  }
+bool ConfigManagerRuntime::runtimeDeltaFrame(bool keyframe, String& out) {
+  RuntimeFrameTargets targets;
+  targets.json = &out;
+  return runtimeFrame(true, keyframe, targets);
+}
+
+std::vector<uint8_t> ConfigManagerRuntime::runtimeValuesToMsgPack() {
+  std::vector<uint8_t> out;
+  RuntimeFrameTargets targets;
+  targets.msgpack = &out;
+  runtimeFrame(false, true, targets);
   return out;
 }
 
-String ConfigManagerRuntime::buildRuntimeMetaJsonLocked() {
+String ConfigManagerRuntime::buildRuntimeMetaJsonLocked(cm::runtime::RuntimeFieldIds& ids) {
   // Keep the stored metadata ordered so serialization can read it directly
   // while the mutex keeps strings, vectors, and iterators stable.
 #ifdef development
-  std::vector<RuntimeFieldMeta>& meta = runtimeMetaOverrideActive ? runtimeMetaOverride : runtimeMeta;
+  std::vector<RuntimeMetaEntry>& meta = runtimeMetaOverrideActive ? runtimeMetaOverrideEntries : runtimeMeta;
 #else
-  std::vector<RuntimeFieldMeta>& meta = runtimeMeta;
+  std::vector<RuntimeMetaEntry>& meta = runtimeMeta;
 #endif
 
 #ifdef CM_RUNTIME_META_TEST_INSTRUMENTATION
@@ -481,34 +681,29 @@ String ConfigManagerRuntime::buildRuntimeMetaJsonLocked() {
   }
 #endif
 
-  std::sort(meta.begin(), meta.end(), [](const RuntimeFieldMeta& a, const RuntimeFieldMeta& b) {
-    if (a.group == b.group) {
-      if (a.order == b.order)
-        return a.label < b.label;
-      return a.order < b.order;
-    }
-    return a.group < b.group;
-  });
+  if (runtimeMetaSortDirty) {
+    std::sort(meta.begin(), meta.end(), [](const RuntimeMetaEntry& a, const RuntimeMetaEntry& b) {
+      return runtimeMetaLess(a.meta, b.meta);
+    });
+    runtimeMetaSortDirty = false;
+  }
 
-  // Determine the exact response size before allocating the one unavoidable
-  // output buffer. Avoiding incremental growth is important on fragmented heaps.
+  // Serialize the entries that changed since the last build and determine the exact
+  // response size before allocating the one unavoidable output buffer. Avoiding
+  // incremental growth is important on fragmented heaps.
+  char prefix[24];
   size_t outputSize = 2; // '[' and ']'
-  bool firstEntry = true;
-  for (const auto& m : meta) {
-    const size_t entrySize = runtimeMetaJsonSize(m);
-    if (entrySize == 0 || entrySize > std::numeric_limits<size_t>::max() - outputSize) {
+  for (size_t i = 0; i < meta.size(); ++i) {
+    if (meta[i].fragment.isEmpty() && !serializeRuntimeMetaFragmentLocked(meta[i])) {
+      logRuntimeMetaSerializationFailure("serialize", outputSize, meta.size());
+      return String();
+    }
+    const size_t entrySize = formatRuntimeMetaIdPrefix(prefix, i) + meta[i].fragment.length() + (i > 0 ? 1 : 0);
+    if (entrySize > std::numeric_limits<size_t>::max() - outputSize) {
       logRuntimeMetaSerializationFailure("size", outputSize, meta.size());
       return String();
     }
     outputSize += entrySize;
-    if (!firstEntry) {
-      if (outputSize == std::numeric_limits<size_t>::max()) {
-        logRuntimeMetaSerializationFailure("size", outputSize, meta.size());
-        return String();
-      }
-      ++outputSize;
-    }
-    firstEntry = false;
   }
 
   String out;
@@ -521,20 +716,21 @@ String ConfigManagerRuntime::buildRuntimeMetaJsonLocked() {
     return String();
   }
 
-  bool first = true;
-  for (const auto& m : meta) {
-    if (!first) {
-      if (!out.concat(',')) {
-        logRuntimeMetaSerializationFailure("separator", outputSize, meta.size());
-        return String();
-      }
+  // A field's ID is its position in this array.
+  for (size_t i = 0; i < meta.size(); ++i) {
+    const RuntimeMetaEntry& entry = meta[i];
+    if (i > 0 && !out.concat(',')) {
+      logRuntimeMetaSerializationFailure("separator", outputSize, meta.size());
+      return String();
     }
-    first = false;
-    if (!appendRuntimeMetaJson(out, m)) {
-      logRuntimeMetaSerializationFailure("serialize", outputSize, meta.size());
+    const size_t prefixLength = formatRuntimeMetaIdPrefix(prefix, i);
+    if (!out.concat(prefix, prefixLength) || !out.concat(entry.fragment)) {
+      logRuntimeMetaSerializationFailure("append", outputSize, meta.size());
       return String();
     }
+    ids.add(entry.meta.sourceGroup.length() ? entry.meta.sourceGroup : entry.meta.group, entry.meta.key);
   }
+  ids.finish();
 
   if (!out.concat(']')) {
     logRuntimeMetaSerializationFailure("close", outputSize, meta.size());
@@ -547,6 +743,13 @@ String ConfigManagerRuntime::buildRuntimeMetaJsonLocked() {
   return out;
 }
 
+bool ConfigManagerRuntime::serializeRuntimeMetaFragmentLocked(RuntimeMetaEntry& entry) {
+#ifdef CM_RUNTIME_META_TEST_INSTRUMENTATION
+  ++runtimeMetaFragmentBuildCount;
+#endif
+  return serializeRuntimeMetaFragment(entry.meta, entry.fragment);
+}
+
 void ConfigManagerRuntime::markRuntimeMetaJsonCacheDirtyLocked() {
   runtimeMetaJsonCacheDirty = true;
   ++runtimeMetaRevision;
@@ -568,12 +771,13 @@ std::shared_ptr<const String> ConfigManagerRuntime::runtimeMetaJsonPayload() {
 
   uint32_t builtRevision = 0;
   String candidate;
+  auto candidateIds = std::make_shared<cm::runtime::RuntimeFieldIds>();
   {
     std::lock_guard<std::mutex> dataLock(runtimeDataMutex);
 #ifdef CM_RUNTIME_META_TEST_INSTRUMENTATION
     ++runtimeMetaSerializationBuildCount;
 #endif
-    candidate = buildRuntimeMetaJsonLocked();
+    candidate = buildRuntimeMetaJsonLocked(*candidateIds);
     builtRevision = runtimeMetaRevision.load();
   }
 
@@ -587,17 +791,24 @@ std::shared_ptr<const String> ConfigManagerRuntime::runtimeMetaJsonPayload() {
   if (replacement && replacement->length() != 0) {
     if (runtimeMetaRevision.load() == builtRevision) {
       runtimeMetaJsonCache = replacement;
+      runtimeFieldIds = candidateIds;
       runtimeMetaJsonCacheDirty = false;
     } else if (!runtimeMetaJsonCache) {
       // The candidate is complete JSON for the most recent stable state
       // seen by this build. Keep it as a temporary fallback, but rebuild
       // again before treating it as current metadata.
       runtimeMetaJsonCache = replacement;
+      runtimeFieldIds = candidateIds;
     }
   }
   return runtimeMetaJsonCache;
 }
 
+std::shared_ptr<const cm::runtime::RuntimeFieldIds> ConfigManagerRuntime::getRuntimeFieldIds() const {
+  std::lock_guard<std::mutex> cacheLock(runtimeMetaCacheMutex);
+  return runtimeFieldIds;
+}
+
 String ConfigManagerRuntime::runtimeMetaToJSON() {
   const std::shared_ptr<const String> payload = runtimeMetaJsonPayload();
   return payload ? *payload : String();
@@ -617,15 +828,16 @@ void ConfigManagerRuntime::defineRuntimeIntValue(const String& group, const Stri
   meta.card = card;
   addRuntimeMeta(meta);
 
-  {
-    std::lock_guard<std::mutex> lock(runtimeDataMutex);
-    runtimeIntInputs.emplace_back(group, key, getter, setter, minValue, maxValue);
-  }
+  updateRegistry([&](RuntimeControlRegistry& registry) {
+    registry.intInputs.emplace_back(group, key, getter, setter, minValue, maxValue);
+    registry.indexControl(RuntimeControlRef::Kind::IntInput, group, registry.intInputs.size() - 1);
+  });
   RUNTIME_LOG("Added int input: %s.%s [%d-%d]", group.c_str(), key.c_str(), minValue, maxValue);
 }
 
 void ConfigManagerRuntime::handleIntInputChange(const String& group, const String& key, int value) {
-  for (auto& input : runtimeIntInputs) {
+  const auto registry = getControlRegistry();
+  for (const auto& input : registry->intInputs) {
     // Cppcheck rationale: Keep the allocation-free, early-exit loop on the embedded target.
     // cppcheck-suppress useStlAlgorithm
     if (input.group == group && input.key == key) {
@@ -656,15 +868,16 @@ void ConfigManagerRuntime::defineRuntimeFloatValue(const String& group, const St
   meta.card = card;
   addRuntimeMeta(meta);
 
-  {
-    std::lock_guard<std::mutex> lock(runtimeDataMutex);
-    runtimeFloatInputs.emplace_back(group, key, getter, setter, minValue, maxValue);
-  }
+  updateRegistry([&](RuntimeControlRegistry& registry) {
+    registry.floatInputs.emplace_back(group, key, getter, setter, minValue, maxValue);
+    registry.indexControl(RuntimeControlRef::Kind::FloatInput, group, registry.floatInputs.size() - 1);
+  });
   RUNTIME_LOG("Added float input: %s.%s [%.2f-%.2f]", group.c_str(), key.c_str(), minValue, maxValue);
 }
 
 void ConfigManagerRuntime::handleFloatInputChange(const String& group, const String& key, float value) {
-  for (auto& input : runtimeFloatInputs) {
+  const auto registry = getControlRegistry();
+  for (const auto& input : registry->floatInputs) {
     // Cppcheck rationale: Keep the allocation-free, early-exit loop on the embedded target.
     // cppcheck-suppress useStlAlgorithm
     if (input.group == group && input.key == key) {
@@ -680,50 +893,63 @@ void ConfigManagerRuntime::handleFloatInputChange(const String& group, const Str
 }
 
 void ConfigManagerRuntime::registerRuntimeButton(const String& group, const String& key, std::function<void()> onPress) {
-  std::lock_guard<std::mutex> lock(runtimeDataMutex);
-  runtimeButtons.emplace_back(group, key, onPress);
+  updateRegistry([&](RuntimeControlRegistry& registry) { registry.buttons.emplace_back(group, key, onPress); });
   RUNTIME_LOG("Added button: %s.%s", group.c_str(), key.c_str());
 }
 
 void ConfigManagerRuntime::registerRuntimeCheckbox(const String& group, const String& key, std::function<bool()> getter, std::function<void(bool)> setter) {
-  std::lock_guard<std::mutex> lock(runtimeDataMutex);
-  runtimeCheckboxes.emplace_back(group, key, getter, setter);
+  updateRegistry([&](RuntimeControlRegistry& registry) {
+    registry.checkboxes.emplace_back(group, key, getter, setter);
+    registry.indexControl(RuntimeControlRef::Kind::Checkbox, group, registry.checkboxes.size() - 1);
+  });
   RUNTIME_LOG("Added checkbox: %s.%s", group.c_str(), key.c_str());
 }
 
 void ConfigManagerRuntime::registerRuntimeStateButton(const String& group, const String& key, std::function<bool()> getter, std::function<void(bool)> setter) {
-  std::lock_guard<std::mutex> lock(runtimeDataMutex);
-  runtimeStateButtons.emplace_back(group, key, getter, setter);
+  updateRegistry([&](RuntimeControlRegistry& registry) {
+    registry.stateButtons.emplace_back(group, key, getter, setter);
+    registry.indexControl(RuntimeControlRef::Kind::StateButton, group, registry.stateButtons.size() - 1);
+  });
   RUNTIME_LOG("Added state button: %s.%s", group.c_str(), key.c_str());
 }
 
 void ConfigManagerRuntime::registerRuntimeMomentaryButton(const String& group, const String& key, std::function<bool()> getter, std::function<void(bool)> setter) {
-  std::lock_guard<std::mutex> lock(runtimeDataMutex);
-  runtimeStateButtons.emplace_back(group, key, getter, setter);
+  updateRegistry([&](RuntimeControlRegistry& registry) {
+    registry.stateButtons.emplace_back(group, key, getter, setter);
+    registry.indexControl(RuntimeControlRef::Kind::StateButton, group, registry.stateButtons.size() - 1);
+  });
   RUNTIME_LOG("Added momentary button: %s.%s", group.c_str(), key.c_str());
 }
 
 void ConfigManagerRuntime::registerRuntimeIntSlider(const String& group, const String& key, std::function<int()> getter, std::function<void(int)> setter, int minValue, int maxValue) {
-  std::lock_guard<std::mutex> lock(runtimeDataMutex);
-  runtimeIntSliders.emplace_back(group, key, getter, setter, minValue, maxValue);
+  updateRegistry([&](RuntimeControlRegistry& registry) {
+    registry.intSliders.emplace_back(group, key, getter, setter, minValue, maxValue);
+    registry.indexControl(RuntimeControlRef::Kind::IntSlider, group, registry.intSliders.size() - 1);
+  });
   RUNTIME_LOG("Added int slider: %s.%s [%d-%d]", group.c_str(), key.c_str(), minValue, maxValue);
 }
 
 void ConfigManagerRuntime::registerRuntimeFloatSlider(const String& group, const String& key, std::function<float()> getter, std::function<void(float)> setter, float minValue, float maxValue) {
-  std::lock_guard<std::mutex> lock(runtimeDataMutex);
-  runtimeFloatSliders.emplace_back(group, key, getter, setter, minValue, maxValue);
+  updateRegistry([&](RuntimeControlRegistry& registry) {
+    registry.floatSliders.emplace_back(group, key, getter, setter, minValue, maxValue);
+    registry.indexControl(RuntimeControlRef::Kind::FloatSlider, group, registry.floatSliders.size() - 1);
+  });
   RUNTIME_LOG("Added float slider: %s.%s [%.2f-%.2f]", group.c_str(), key.c_str(), minValue, maxValue);
 }
 
 void ConfigManagerRuntime::registerRuntimeIntInput(const String& group, const String& key, std::function<int()> getter, std::function<void(int)> setter, int minValue, int maxValue) {
-  std::lock_guard<std::mutex> lock(runtimeDataMutex);
-  runtimeIntInputs.emplace_back(group, key, getter, setter, minValue, maxValue);
+  updateRegistry([&](RuntimeControlRegistry& registry) {
+    registry.intInputs.emplace_back(group, key, getter, setter, minValue, maxValue);
+    registry.indexControl(RuntimeControlRef::Kind::IntInput, group, registry.intInputs.size() - 1);
+  });
   RUNTIME_LOG("Added int input: %s.%s [%d-%d]", group.c_str(), key.c_str(), minValue, maxValue);
 }
 
 void ConfigManagerRuntime::registerRuntimeFloatInput(const String& group, const String& key, std::function<float()> getter, std::function<void(float)> setter, float minValue, float maxValue) {
-  std::lock_guard<std::mutex> lock(runtimeDataMutex);
-  runtimeFloatInputs.emplace_back(group, key, getter, setter, minValue, maxValue);
+  updateRegistry([&](RuntimeControlRegistry& registry) {
+    registry.floatInputs.emplace_back(group, key, getter, setter, minValue, maxValue);
+    registry.indexControl(RuntimeControlRef::Kind::FloatInput, group, registry.floatInputs.size() - 1);
+  });
   RUNTIME_LOG("Added float input: %s.%s [%.2f-%.2f]", group.c_str(), key.c_str(), minValue, maxValue);
 }
 
@@ -828,7 +1054,7 @@ void ConfigManagerRuntime::enableBuiltinSystemProvider() {
             // obj["allowOTA"] = ota.isEnabled();
             obj["otaActive"] = ota.isActive();
             obj["otaHasPassword"] = ota.hasPassword();
-        } }, 0);
+        } }, 0, CM_SYSTEM_PROVIDER_REFRESH_MS);
 
   // Provide basic meta so UI can display the RSSI and its quality text
   {
@@ -931,6 +1157,121 @@ void ConfigManagerRuntime::updateLoopTiming() {
 
 #endif // CM_ENABLE_SYSTEM_PROVIDER
 
+void ConfigManagerRuntime::enableDiagnosticsProvider() {
+  if (diagnosticsProviderRegistered) {
+    return;
+  }
+  diagnosticsProviderRegistered = true;
+  addRuntimeProvider("diagnostics", [this](JsonObject& obj) { fillDiagnostics(obj); }, 1000, CM_DIAGNOSTICS_PROVIDER_REFRESH_MS);
+  RUNTIME_LOG("Diagnostics provider enabled");
+}
+
+// Not listed in runtime_meta; read via /runtime.json or the WebSocket frames.
+void ConfigManagerRuntime::fillDiagnostics(JsonObject& obj) {
+  // Fill cost per provider group.
+  JsonObject providers = obj["providers"].to<JsonObject>();
+  for (const RuntimeProviderStats& stats : getRuntimeProviderStats()) {
+    JsonObject entry = providers[stats.name].as<JsonObject>();
+    if (entry.isNull()) {
+      entry = providers[stats.name].to<JsonObject>();
+    }
+    entry["fillUs"] = entry["fillUs"].as<uint32_t>() + stats.lastFillUs;
+    entry["maxFillUs"] = entry["maxFillUs"].as<uint32_t>() + stats.maxFillUs;
+    entry["hits"] = entry["hits"].as<uint32_t>() + stats.hits;
+    entry["misses"] = entry["misses"].as<uint32_t>() + stats.misses;
+  }
+
+#if CM_ENABLE_WS_PUSH
+  // Send queue per WebSocket client; frames are skipped while it is backed up.
+  if (configManager) {
+    JsonArray wsClients = obj["wsClients"].to<JsonArray>();
+    for (const auto& client : configManager->getWebSocketClientStats()) {
+      JsonObject entry = wsClients.add<JsonObject>();
+      entry["id"] = client.id;
+      entry["queued"] = client.queuedMessages;
+      entry["queuedBytes"] = client.queuedBytes;
+      entry["dropped"] = client.droppedFrames;
+    }
+    // Runtime actions received over /ws (dispatched by handleLoopMailbox()).
+    const auto commands = configManager->getWebSocketCommandStats();
+    JsonObject wsCommands = obj["wsCommands"].to<JsonObject>();
+    wsCommands["received"] = commands.received;
+    wsCommands["coalesced"] = commands.coalesced;
+    wsCommands["rejected"] = commands.rejected;
+    wsCommands["dispatched"] = commands.dispatched;
+    wsCommands["latencyUs"] = commands.lastLatencyUs;
+    wsCommands["maxLatencyUs"] = commands.maxLatencyUs;
+  }
+#endif
+
+  // Web mutations handed to the loop task (ConfigManagerClass::postToLoop()).
+  if (configManager) {
+    const auto mailbox = configManager->getLoopMailboxStats();
+    JsonObject loopMailbox = obj["loopMailbox"].to<JsonObject>();
+    loopMailbox["posted"] = mailbox.posted;
+    loopMailbox["full"] = mailbox.full;
+    loopMailbox["applied"] = mailbox.applied;
+    loopMailbox["maxBatch"] = mailbox.maxBatch;
+  }
+
+  // HTTP admission per class (ConfigManagerWeb::admit()).
+  if (configManager) {
+    const auto& admission = configManager->getWebManager().getAdmission();
+    JsonObject http = obj["http"].to<JsonObject>();
+    for (uint8_t i = 0; i < static_cast<uint8_t>(cm::web::RequestClass::Count); ++i) {
+      const auto stats = admission.stats(static_cast<cm::web::RequestClass>(i));
+      JsonObject entry = http[stats.name].to<JsonObject>();
+      entry["active"] = stats.active;
+      entry["peak"] = stats.peakActive;
+      entry["admitted"] = stats.admitted;
+      entry["busy"] = stats.rejectedBusy;
+      entry["lowHeap"] = stats.rejectedHeap;
+    }
+  }
+
+#if CM_ENABLE_LOOP_PROFILER
+  // Loop latency per subsystem (p50/p99/max in us); /perf.json adds the histograms.
+  cm::runtime::LoopProfiler::instance().toJSON(obj["perf"].to<JsonObject>(), false);
+#endif
+}
+
+bool ConfigManagerRuntime::enableRuntimeHistory(size_t maxFields) {
+  if (runtimeHistory) {
+    return true;
+  }
+  const uint16_t capacities[cm::runtime::RuntimeHistory::RESOLUTIONS] = {CM_RUNTIME_HISTORY_1S, CM_RUNTIME_HISTORY_1M, CM_RUNTIME_HISTORY_15M};
+  runtimeHistory.reset(new (std::nothrow) cm::runtime::RuntimeHistory(maxFields, capacities));
+  if (!runtimeHistory || runtimeHistory->maxFields() != maxFields) {
+    RUNTIME_LOG("[E] Runtime history unavailable (%u fields)", static_cast<unsigned>(maxFields));
+    runtimeHistory.reset();
+    return false;
+  }
+  RUNTIME_LOG("Runtime history enabled: %u fields, %u bytes", static_cast<unsigned>(maxFields), static_cast<unsigned>(runtimeHistory->memoryBytes()));
+  return true;
+}
+
+bool ConfigManagerRuntime::addRuntimeHistory(const String& group, const String& key, std::function<float()> source, float scale) {
+  if (!enableRuntimeHistory()) {
+    return false;
+  }
+  if (!runtimeHistory->addField(group, key, scale, std::move(source))) {
+    RUNTIME_LOG("[W] History not recorded for %s.%s (%u of %u fields used)",
+                group.c_str(),
+                key.c_str(),
+                static_cast<unsigned>(runtimeHistory->fieldCount()),
+                static_cast<unsigned>(runtimeHistory->maxFields()));
+    return false;
+  }
+  updateRuntimeMeta(group, key, [](RuntimeFieldMeta& meta) { meta.hasHistory = true; });
+  return true;
+}
+
+void ConfigManagerRuntime::updateHistory() {
+  if (runtimeHistory) {
+    runtimeHistory->sample(millis());
+  }
+}
+
 void ConfigManagerRuntime::addRuntimeAlarm(const String& name, std::function<bool()> checkFunction) {
   RuntimeAlarm alarm;
   alarm.name = name;
@@ -1146,6 +1487,12 @@ void ConfigManagerRuntime::setRuntimeMetaOverride(const std::vector<RuntimeField
   std::lock_guard<std::mutex> dataLock(runtimeDataMutex);
   runtimeMetaOverride = override;
   runtimeMetaOverrideActive = true;
+  runtimeMetaOverrideEntries.clear();
+  runtimeMetaOverrideEntries.reserve(override.size());
+  for (const auto& meta : override) {
+    runtimeMetaOverrideEntries.push_back(RuntimeMetaEntry{meta, String()});
+  }
+  runtimeMetaSortDirty = true;
   markRuntimeMetaJsonCacheDirtyLocked();
   RUNTIME_LOG("Meta override set (%d entries)", override.size());
 }
@@ -1154,7 +1501,9 @@ void ConfigManagerRuntime::clearRuntimeMetaOverride() {
   std::lock_guard<std::mutex> cacheLock(runtimeMetaCacheMutex);
   std::lock_guard<std::mutex> dataLock(runtimeDataMutex);
   runtimeMetaOverride.clear();
+  runtimeMetaOverrideEntries.clear();
   runtimeMetaOverrideActive = false;
+  runtimeMetaSortDirty = true;
   markRuntimeMetaJsonCacheDirtyLocked();
   RUNTIME_LOG("Meta override cleared");
 }
@@ -1173,15 +1522,13 @@ void ConfigManagerRuntime::defineRuntimeButton(const String& group, const String
   meta.card = card;
   addRuntimeMeta(meta);
 
-  {
-    std::lock_guard<std::mutex> lock(runtimeDataMutex);
-    runtimeButtons.emplace_back(group, key, onPress);
-  }
+  updateRegistry([&](RuntimeControlRegistry& registry) { registry.buttons.emplace_back(group, key, onPress); });
   RUNTIME_LOG("Added button: %s.%s", group.c_str(), key.c_str());
 }
 
 void ConfigManagerRuntime::handleButtonPress(const String& group, const String& key) {
-  for (auto& button : runtimeButtons) {
+  const auto registry = getControlRegistry();
+  for (const auto& button : registry->buttons) {
     // Cppcheck rationale: Keep the allocation-free, early-exit loop on the embedded target.
     // cppcheck-suppress useStlAlgorithm
     if (button.group == group && button.key == key) {
@@ -1205,15 +1552,16 @@ void ConfigManagerRuntime::defineRuntimeCheckbox(const String& group, const Stri
   meta.card = card;
   addRuntimeMeta(meta);
 
-  {
-    std::lock_guard<std::mutex> lock(runtimeDataMutex);
-    runtimeCheckboxes.emplace_back(group, key, getter, setter);
-  }
+  updateRegistry([&](RuntimeControlRegistry& registry) {
+    registry.checkboxes.emplace_back(group, key, getter, setter);
+    registry.indexControl(RuntimeControlRef::Kind::Checkbox, group, registry.checkboxes.size() - 1);
+  });
   RUNTIME_LOG("Added checkbox: %s.%s", group.c_str(), key.c_str());
 }
 
 void ConfigManagerRuntime::handleCheckboxChange(const String& group, const String& key, bool value) {
-  for (auto& checkbox : runtimeCheckboxes) {
+  const auto registry = getControlRegistry();
+  for (const auto& checkbox : registry->checkboxes) {
     // Cppcheck rationale: Keep the allocation-free, early-exit loop on the embedded target.
     // cppcheck-suppress useStlAlgorithm
     if (checkbox.group == group && checkbox.key == key) {
@@ -1240,10 +1588,10 @@ void ConfigManagerRuntime::defineRuntimeStateButton(const String& group, const S
   meta.offLabel = offLabel;
   addRuntimeMeta(meta);
 
-  {
-    std::lock_guard<std::mutex> lock(runtimeDataMutex);
-    runtimeStateButtons.emplace_back(group, key, getter, setter);
-  }
+  updateRegistry([&](RuntimeControlRegistry& registry) {
+    registry.stateButtons.emplace_back(group, key, getter, setter);
+    registry.indexControl(RuntimeControlRef::Kind::StateButton, group, registry.stateButtons.size() - 1);
+  });
   RUNTIME_LOG("Added state button: %s.%s", group.c_str(), key.c_str());
 }
 
@@ -1259,15 +1607,16 @@ void ConfigManagerRuntime::defineRuntimeMomentaryButton(const String& group, con
   meta.offLabel = offLabel;
   addRuntimeMeta(meta);
 
-  {
-    std::lock_guard<std::mutex> lock(runtimeDataMutex);
-    runtimeStateButtons.emplace_back(group, key, getter, setter);
-  }
+  updateRegistry([&](RuntimeControlRegistry& registry) {
+    registry.stateButtons.emplace_back(group, key, getter, setter);
+    registry.indexControl(RuntimeControlRef::Kind::StateButton, group, registry.stateButtons.size() - 1);
+  });
   RUNTIME_LOG("Added momentary button: %s.%s", group.c_str(), key.c_str());
 }
 
 void ConfigManagerRuntime::handleStateButtonToggle(const String& group, const String& key) {
-  for (auto& button : runtimeStateButtons) {
+  const auto registry = getControlRegistry();
+  for (const auto& button : registry->stateButtons) {
     // Cppcheck rationale: Keep the allocation-free, early-exit loop on the embedded target.
     // cppcheck-suppress useStlAlgorithm
     if (button.group == group && button.key == key) {
@@ -1284,7 +1633,8 @@ void ConfigManagerRuntime::handleStateButtonToggle(const String& group, const St
 }
 
 void ConfigManagerRuntime::handleStateButtonSet(const String& group, const String& key, bool value) {
-  for (auto& button : runtimeStateButtons) {
+  const auto registry = getControlRegistry();
+  for (const auto& button : registry->stateButtons) {
     // Cppcheck rationale: Keep the allocation-free, early-exit loop on the embedded target.
     // cppcheck-suppress useStlAlgorithm
     if (button.group == group && button.key == key) {
@@ -1312,15 +1662,16 @@ void ConfigManagerRuntime::defineRuntimeIntSlider(const String& group, const Str
   meta.card = card;
   addRuntimeMeta(meta);
 
-  {
-    std::lock_guard<std::mutex> lock(runtimeDataMutex);
-    runtimeIntSliders.emplace_back(group, key, getter, setter, minValue, maxValue);
-  }
+  updateRegistry([&](RuntimeControlRegistry& registry) {
+    registry.intSliders.emplace_back(group, key, getter, setter, minValue, maxValue);
+    registry.indexControl(RuntimeControlRef::Kind::IntSlider, group, registry.intSliders.size() - 1);
+  });
   RUNTIME_LOG("Added int slider: %s.%s [%d-%d]", group.c_str(), key.c_str(), minValue, maxValue);
 }
 
 void ConfigManagerRuntime::handleIntSliderChange(const String& group, const String& key, int value) {
-  for (auto& slider : runtimeIntSliders) {
+  const auto registry = getControlRegistry();
+  for (const auto& slider : registry->intSliders) {
     // Cppcheck rationale: Keep the allocation-free, early-exit loop on the embedded target.
     // cppcheck-suppress useStlAlgorithm
     if (slider.group == group && slider.key == key) {
@@ -1352,15 +1703,16 @@ void ConfigManagerRuntime::defineRuntimeFloatSlider(const String& group, const S
   meta.card = card;
   addRuntimeMeta(meta);
 
-  {
-    std::lock_guard<std::mutex> lock(runtimeDataMutex);
-    runtimeFloatSliders.emplace_back(group, key, getter, setter, minValue, maxValue);
-  }
+  updateRegistry([&](RuntimeControlRegistry& registry) {
+    registry.floatSliders.emplace_back(group, key, getter, setter, minValue, maxValue);
+    registry.indexControl(RuntimeControlRef::Kind::FloatSlider, group, registry.floatSliders.size() - 1);
+  });
   RUNTIME_LOG("Added float slider: %s.%s [%.2f-%.2f]", group.c_str(), key.c_str(), minValue, maxValue);
 }
 
 void ConfigManagerRuntime::handleFloatSliderChange(const String& group, const String& key, float value) {
-  for (auto& slider : runtimeFloatSliders) {
+  const auto registry = getControlRegistry();
+  for (const auto& slider : registry->floatSliders) {
     // Cppcheck rationale: Keep the allocation-free, early-exit loop on the embedded target.
     // cppcheck-suppress useStlAlgorithm
     if (slider.group == group && slider.key == key) {
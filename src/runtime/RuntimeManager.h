@@ -7,6 +7,9 @@
 #include <mutex>
 #include <vector>
 #include "../ConfigManagerConfig.h"
+#include "RuntimeDelta.h"
+#include "RuntimeFrameArena.h"
+#include "RuntimeHistory.h"
 
 // Forward declaration
 class ConfigManagerClass;
@@ -16,9 +19,22 @@ struct RuntimeValueProvider {
   String name;
   std::function<void(JsonObject&)> fill;
   int order = 100;
+  // Minimum time between fill() calls; frames in between reuse the last fragment.
+  // 0 calls fill() for every frame. See ConfigManagerRuntime::markRuntimeProviderDirty().
+  uint32_t refreshIntervalMs = 0;
 
-  RuntimeValueProvider(const String& n, std::function<void(JsonObject&)> f, int o = 100)
-      : name(n), fill(f), order(o) {}
+  RuntimeValueProvider(const String& n, std::function<void(JsonObject&)> f, int o = 100, uint32_t refreshMs = 0)
+      : name(n), fill(f), order(o), refreshIntervalMs(refreshMs) {}
+};
+
+// Fill statistics of one provider (ConfigManagerRuntime::getRuntimeProviderStats()).
+struct RuntimeProviderStats {
+  String name;
+  uint32_t refreshIntervalMs = 0;
+  uint32_t hits = 0;   // Frames served from the cached fragment
+  uint32_t misses = 0; // fill() calls
+  uint32_t lastFillUs = 0;
+  uint32_t maxFillUs = 0;
 };
 
 struct RuntimeStyleProperty {
@@ -154,6 +170,7 @@ struct RuntimeFieldMeta {
   bool isFloatSlider = false;
   bool isIntInput = false;
   bool isFloatInput = false;
+  bool hasHistory = false; // Recorded by the runtime history (/runtime_history.json)
   bool hasAlarm = false;
   bool alarmWhenTrue = false;
   bool boolAlarmValue = false;
@@ -262,6 +279,100 @@ struct RuntimeAlarm {
   std::function<void()> onClear = nullptr;
 };
 
+// Reference to one value-carrying control in RuntimeControlRegistry.
+struct RuntimeControlRef {
+  enum class Kind : uint8_t {
+    Checkbox,
+    StateButton,
+    IntSlider,
+    FloatSlider,
+    IntInput,
+    FloatInput
+  };
+
+  Kind kind = Kind::Checkbox;
+  uint16_t index = 0; // Position in the vector of that kind
+};
+
+// Runtime group (top-level /runtime.json object) and the controls that report into it.
+struct RuntimeControlGroup {
+  String name;
+  bool hasProvider = false;
+  std::vector<RuntimeControlRef> controls; // Ordered by kind, then registration
+};
+
+// Last fragment and fill statistics of one provider. Shared by all registry
+// snapshots, so it survives copy-on-write registrations.
+struct RuntimeProviderCache {
+  std::mutex mutex; // Serializes fill() and fragment access for cached providers
+  JsonDocument fragment;
+  unsigned long lastFillMs = 0;
+  bool valid = false;
+  std::atomic<bool> dirty{false};
+  std::atomic<uint32_t> hits{0};
+  std::atomic<uint32_t> misses{0};
+  std::atomic<uint32_t> lastFillUs{0};
+  std::atomic<uint32_t> maxFillUs{0};
+};
+
+// Per provider (parallel to RuntimeControlRegistry::providers).
+struct RuntimeProviderLink {
+  uint16_t group = 0;
+  bool lastInGroup = true; // Group controls are written after the group's last provider
+  std::shared_ptr<RuntimeProviderCache> cache;
+};
+
+// Registered runtime providers and interactive controls. Readers share an immutable
+// snapshot; registration copies it only while a reader still holds it (copy-on-write).
+// The group index is maintained on registration, so serialization is one linear walk.
+struct RuntimeControlRegistry {
+  std::vector<RuntimeValueProvider> providers; // Kept sorted by order (stable)
+  std::vector<RuntimeProviderLink> providerLinks;
+  std::vector<RuntimeControlGroup> groups;     // In order of first registration
+  std::vector<RuntimeButton> buttons;
+  std::vector<RuntimeCheckbox> checkboxes;
+  std::vector<RuntimeStateButton> stateButtons;
+  std::vector<RuntimeIntSlider> intSliders;
+  std::vector<RuntimeFloatSlider> floatSliders;
+  std::vector<RuntimeIntInput> intInputs;
+  std::vector<RuntimeFloatInput> floatInputs;
+
+  size_t controlCount() const {
+    return buttons.size() + checkboxes.size() + stateButtons.size() + intSliders.size() + floatSliders.size() + intInputs.size() + floatInputs.size();
+  }
+
+  void addProvider(const RuntimeValueProvider& provider);
+  // Call after appending to the vector of `kind`.
+  void indexControl(RuntimeControlRef::Kind kind, const String& group, size_t index);
+  // Writes the current value of every control in `group` into `slot`.
+  void writeControls(JsonObject& slot, const RuntimeControlGroup& group) const;
+
+private:
+  size_t groupIndex(const String& name);
+};
+
+enum class RuntimeFrameEncoding : uint8_t {
+  Json,
+  MsgPack,
+  CompactJson,
+  CompactMsgPack
+};
+
+// Serialized runtime frame per client encoding; null targets are skipped. Compact
+// frames replace field keys with the numeric IDs from runtime_meta.json.
+struct RuntimeFrameTargets {
+  String* json = nullptr;
+  std::vector<uint8_t>* msgpack = nullptr;
+  String* compactJson = nullptr;
+  std::vector<uint8_t>* compactMsgpack = nullptr;
+
+  // Alternative for a frame that every client receives in the same encoding:
+  // `reserveShared` gets the exact serialized size and returns a buffer of at least
+  // that many bytes (e.g. one WebSocket message buffer for all clients), or nullptr.
+  RuntimeFrameEncoding sharedEncoding = RuntimeFrameEncoding::Json;
+  std::function<uint8_t*(size_t size)> reserveShared;
+};
+
 class ConfigManagerRuntime {
 public:
   typedef std::function<void(const char*)> LogCallback;
@@ -278,30 +389,38 @@ private:
   bool runtimeMetaJsonCacheDirty = true;
   bool runtimeMetaJsonCacheBuildInProgress = false;
   std::atomic<uint32_t> runtimeMetaRevision{0};
+  std::shared_ptr<const cm::runtime::RuntimeFieldIds> runtimeFieldIds; // Matches runtimeMetaJsonCache
 
 #ifdef CM_RUNTIME_META_TEST_INSTRUMENTATION
   bool runtimeMetaSerializationFailureForTest = false;
   std::atomic<size_t> runtimeMetaSerializationBuildCount{0};
+  std::atomic<size_t> runtimeMetaFragmentBuildCount{0};
 #endif
 
-  // Runtime data
-  std::vector<RuntimeValueProvider> runtimeProviders;
-  std::vector<RuntimeFieldMeta> runtimeMeta;
-
-  std::vector<RuntimeButton> runtimeButtons;
+  // One /runtime_meta.json entry with its serialized members (everything after "id",
+  // which is the entry's position). An empty fragment is serialized on the next build.
+  struct RuntimeMetaEntry {
+    RuntimeFieldMeta meta;
+    String fragment;
+  };
 
-  std::vector<RuntimeCheckbox> runtimeCheckboxes;
-
-  std::vector<RuntimeStateButton> runtimeStateButtons;
+  // Runtime data
+  std::shared_ptr<RuntimeControlRegistry> runtimeRegistry; // Guarded by runtimeDataMutex
+  std::vector<RuntimeMetaEntry> runtimeMeta;
+  bool runtimeMetaSortDirty = false; // Guarded by runtimeDataMutex
+#ifdef development
+  std::vector<RuntimeMetaEntry> runtimeMetaOverrideEntries; // Serialized copy of runtimeMetaOverride
+#endif
 
-  std::vector<RuntimeIntSlider> runtimeIntSliders;
+  std::vector<RuntimeAlarm> runtimeAlarms;
 
-  std::vector<RuntimeFloatSlider> runtimeFloatSliders;
+  std::unique_ptr<cm::runtime::RuntimeHistory> runtimeHistory;
 
-  std::vector<RuntimeIntInput> runtimeIntInputs;
-  std::vector<RuntimeFloatInput> runtimeFloatInputs;
+  cm::runtime::RuntimeDeltaEncoder runtimeDeltaEncoder;
+  cm::runtime::RuntimeFrameArenaPool frameArenas{CM_RUNTIME_FRAME_ARENA_BYTES};
 
-  std::vector<RuntimeAlarm> runtimeAlarms;
+  bool diagnosticsProviderRegistered = false;
+  void fillDiagnostics(JsonObject& obj);
 
   // System provider data
 #if CM_ENABLE_SYSTEM_PROVIDER
@@ -314,7 +433,11 @@ private:
 #endif
 
   // Helper methods
-  String buildRuntimeMetaJsonLocked();
+  void updateRegistry(const std::function<void(RuntimeControlRegistry&)>& mutate);
+  // Writes the /runtime.json members into root; returns a serialized size estimate.
+  size_t fillRuntimeValues(JsonObject root);
+  String buildRuntimeMetaJsonLocked(cm::runtime::RuntimeFieldIds& ids);
+  bool serializeRuntimeMetaFragmentLocked(RuntimeMetaEntry& entry);
   void markRuntimeMetaJsonCacheDirtyLocked();
   RuntimeAlarm* findAlarm(const String& name);
   const RuntimeAlarm* findAlarm(const String& name) const;
@@ -330,19 +453,48 @@ public:
   // Runtime value providers
   // Thread-safe registration: may be called while runtime JSON is generated.
   void addRuntimeProvider(const RuntimeValueProvider& provider);
-  void addRuntimeProvider(const String& name, std::function<void(JsonObject&)> fillFunc, int order = 100);
+  void addRuntimeProvider(const String& name, std::function<void(JsonObject&)> fillFunc, int order = 100, uint32_t refreshIntervalMs = 0);
+  // Makes every provider registered under `name` refill on the next frame, even if its
+  // refresh interval has not elapsed. Cheap and thread-safe; returns false if unknown.
+  bool markRuntimeProviderDirty(const String& name);
+  std::vector<RuntimeProviderStats> getRuntimeProviderStats() const;
+  void resetRuntimeProviderStats();
+  // Registers the "diagnostics" group with the library's internal counters (provider
+  // fill cost, ...). Off by default: every enabled group is part of each runtime frame.
+  void enableDiagnosticsProvider();
 
   // Runtime metadata
   // Thread-safe registration: may be called while runtime JSON is generated.
   void addRuntimeMeta(const RuntimeFieldMeta& meta);
   bool updateRuntimeMeta(const String& group, const String& key, const std::function<void(RuntimeFieldMeta&)>& updater);
-  // Note: returned pointer is only stable until the next runtime meta mutation.
-  RuntimeFieldMeta* findRuntimeMeta(const String& group, const String& key);
+  // Read-only lookup; change entries through updateRuntimeMeta() so the cached JSON
+  // fragment is rebuilt. The pointer is only stable until the next runtime meta mutation.
+  const RuntimeFieldMeta* findRuntimeMeta(const String& group, const String& key) const;
+
+  // Current providers and controls. Holding the pointer keeps that snapshot alive;
+  // later registrations publish a new one.
+  std::shared_ptr<const RuntimeControlRegistry> getControlRegistry() const;
 
   // JSON generation
   String runtimeValuesToJSON();
+  // Same object as MessagePack (/runtime.msgpack, binary WebSocket frames).
+  std::vector<uint8_t> runtimeValuesToMsgPack();
+  // Builds the runtime values once and serializes them into each requested target.
+  // With `delta` the frame comes from the delta encoder (see RuntimeDelta.h), which
+  // keeps per-field state, so call it from the push loop only. Returns false when a
+  // delta frame would be empty.
+  bool runtimeFrame(bool delta, bool keyframe, const RuntimeFrameTargets& targets);
+  bool runtimeDeltaFrame(bool keyframe, String& out);
+  const cm::runtime::RuntimeDeltaEncoder& getRuntimeDeltaEncoder() const {
+    return runtimeDeltaEncoder;
+  }
+  cm::runtime::RuntimeFrameArenaStats getFrameArenaStats() const {
+    return frameArenas.stats();
+  }
   String runtimeMetaToJSON();
   std::shared_ptr<const String> runtimeMetaJsonPayload();
+  // Field IDs of the current runtime_meta.json payload (null before the first build).
+  std::shared_ptr<const cm::runtime::RuntimeFieldIds> getRuntimeFieldIds() const;
 
 #ifdef CM_RUNTIME_META_TEST_INSTRUMENTATION
   void setRuntimeMetaSerializationFailureForTest(bool fail) {
@@ -356,6 +508,11 @@ public:
     std::lock_guard<std::mutex> cacheLock(runtimeMetaCacheMutex);
     return runtimeMetaSerializationBuildCount.load();
   }
+
+  // Entries serialized since construction; unchanged entries reuse their fragment.
+  size_t getRuntimeMetaFragmentBuildCountForTest() const {
+    return runtimeMetaFragmentBuildCount.load();
+  }
 #endif
 
   // System provider
@@ -376,6 +533,16 @@ public:
   void refreshSketchInfoCache() {}
 #endif
 
+  // History (see RuntimeHistory.h). enableRuntimeHistory() reserves the storage for
+  // maxFields fields; addRuntimeHistory() calls it with the default when needed.
+  // Register during setup, before the loop samples.
+  bool enableRuntimeHistory(size_t maxFields = CM_RUNTIME_HISTORY_FIELDS);
+  bool addRuntimeHistory(const String& group, const String& key, std::function<float()> source, float scale = 1.0f);
+  void updateHistory();
+  const cm::runtime::RuntimeHistory* getRuntimeHistory() const {
+    return runtimeHistory.get();
+  }
+
   // Alarms
   void addRuntimeAlarm(const String& name, std::function<bool()> checkFunction);
   void addRuntimeAlarm(const String& name, std::function<bool()> checkFunction, std::function<void()> onTrigger, std::function<void()> onClear = nullptr);
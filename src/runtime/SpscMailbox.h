@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace cm::runtime {
+
+// Bounded single-producer/single-consumer ring of T, without locks.
+//
+// Exactly one task may call push() and exactly one (other) task pop(); size() may be
+// called from either. The producer publishes a slot with a release store of head_, the
+// consumer frees it with a release store of tail_, so an item is never read while it
+// is being written. All slots are allocated once, up front; T must be default
+// constructible and movable. The capacity is rounded up to a power of two.
+template <typename T>
+class SpscMailbox {
+public:
+  explicit SpscMailbox(size_t capacity) {
+    size_t rounded = 1;
+    while (rounded < capacity) {
+      rounded <<= 1;
+    }
+    slots_.reset(new (std::nothrow) T[rounded]);
+    mask_ = slots_ ? rounded - 1 : 0;
+    capacity_ = slots_ ? rounded : 0;
+  }
+
+  SpscMailbox(const SpscMailbox&) = delete;
+  SpscMailbox& operator=(const SpscMailbox&) = delete;
+
+  // Producer only. Returns false (and leaves item untouched) when the mailbox is full.
+  bool push(T&& item) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) >= capacity_) {
+      return false;
+    }
+    slots_[head & mask_] = std::move(item);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer only. The slot is reset to T() so its resources are released on this task.
+  bool pop(T& out) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    T& slot = slots_[tail & mask_];
+    out = std::move(slot);
+    slot = T();
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // A snapshot; exact only on a task that is not concurrently pushing or popping.
+  // tail_ is read first so the difference cannot underflow.
+  size_t size() const {
+    const size_t tail = tail_.load(std::memory_order_acquire);
+    return head_.load(std::memory_order_acquire) - tail;
+  }
+  size_t capacity() const {
+    return capacity_;
+  }
+
+private:
+  std::unique_ptr<T[]> slots_;
+  size_t mask_ = 0;
+  size_t capacity_ = 0;
+  std::atomic<size_t> head_{0}; // Next slot to write; advanced by the producer
+  std::atomic<size_t> tail_{0}; // Next slot to read; advanced by the consumer
+};
+
+} // namespace cm::runtime
@@ -0,0 +1,51 @@
+#include "SettingsBlob.h"
+
+uint32_t cm::storage::crc32(const uint8_t* data, size_t len, uint32_t crc) {
+  // Bitwise CRC-32 (IEEE 802.3). Only runs on boot and commit, so no lookup table.
+  crc = ~crc;
+  for (size_t i = 0; i < len; ++i) {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+  }
+  return ~crc;
+}
+
+namespace {
+void storeLe(uint8_t* dst, uint32_t value, size_t bytes) {
+  for (size_t i = 0; i < bytes; ++i) {
+    dst[i] = static_cast<uint8_t>(value >> (8 * i));
+  }
+}
+} // namespace
+
+void cm::storage::writeHeader(uint8_t* dst, const BlobHeader& header) {
+  storeLe(dst, header.magic, 4);
+  storeLe(dst + 4, header.version, 2);
+  storeLe(dst + 6, header.count, 2);
+  storeLe(dst + 8, header.schemaHash, 4);
+  storeLe(dst + 12, header.payloadLen, 4);
+  storeLe(dst + 16, header.crc, 4);
+}
+
+bool cm::storage::readHeader(const uint8_t* blob, size_t len, BlobHeader& header, const uint8_t*& payload) {
+  if (!blob || len < BLOB_HEADER_SIZE) {
+    return false;
+  }
+  BlobReader reader(blob, BLOB_HEADER_SIZE);
+  reader.u32(header.magic);
+  reader.u16(header.version);
+  reader.u16(header.count);
+  reader.u32(header.schemaHash);
+  reader.u32(header.payloadLen);
+  reader.u32(header.crc);
+  if (!reader.ok() || header.magic != BLOB_MAGIC || header.version != BLOB_VERSION) {
+    return false;
+  }
+  if (header.payloadLen != len - BLOB_HEADER_SIZE) {
+    return false;
+  }
+  payload = blob + BLOB_HEADER_SIZE;
+  return crc32(payload, header.payloadLen) == header.crc;
+}
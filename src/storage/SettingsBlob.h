@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Binary snapshot format used by SettingsStorageMode::Blob.
+//
+// Layout (little endian):
+//   header: magic u32 | version u16 | count u16 | schemaHash u32 | payloadLen u32 | crc32 u32
+//   payload, per persisted setting in registration order:
+//     keyHash u32 | type u8 | value (bool: u8, int/float: 4 bytes, string: u16 length + bytes)
+//
+// The schema hash covers (storage key, type) of every persisted setting. When it matches,
+// entries are decoded positionally; otherwise entries are matched by key hash so values
+// survive added, removed or reordered settings.
+
+namespace cm::storage {
+
+static constexpr const char* BLOB_PREFS_KEY = "cm_snapshot";
+static constexpr uint32_t BLOB_MAGIC = 0x42534D43; // "CMSB"
+static constexpr uint16_t BLOB_VERSION = 1;
+static constexpr size_t BLOB_HEADER_SIZE = 20;
+
+uint32_t crc32(const uint8_t* data, size_t len, uint32_t crc = 0);
+
+class BlobWriter {
+public:
+  explicit BlobWriter(std::vector<uint8_t>& target) : out_(target) {}
+
+  void u8(uint8_t value) {
+    out_.push_back(value);
+  }
+  void u16(uint16_t value) {
+    u8(static_cast<uint8_t>(value));
+    u8(static_cast<uint8_t>(value >> 8));
+  }
+  void u32(uint32_t value) {
+    u16(static_cast<uint16_t>(value));
+    u16(static_cast<uint16_t>(value >> 16));
+  }
+  void bytes(const char* data, size_t len) {
+    out_.insert(out_.end(), data, data + len);
+  }
+  size_t size() const {
+    return out_.size();
+  }
+
+private:
+  std::vector<uint8_t>& out_;
+};
+
+class BlobReader {
+public:
+  BlobReader(const uint8_t* data, size_t len) : data_(data), len_(len) {}
+
+  bool u8(uint8_t& value) {
+    if (remaining() < 1) {
+      return fail();
+    }
+    value = data_[pos_++];
+    return true;
+  }
+  bool u16(uint16_t& value) {
+    if (remaining() < 2) {
+      return fail();
+    }
+    value = static_cast<uint16_t>(data_[pos_] | (data_[pos_ + 1] << 8));
+    pos_ += 2;
+    return true;
+  }
+  bool u32(uint32_t& value) {
+    uint16_t lo = 0;
+    uint16_t hi = 0;
+    if (!u16(lo) || !u16(hi)) {
+      return false;
+    }
+    value = static_cast<uint32_t>(lo) | (static_cast<uint32_t>(hi) << 16);
+    return true;
+  }
+  // Returns a pointer into the blob; the bytes are not NUL-terminated.
+  const char* bytes(size_t len) {
+    if (remaining() < len) {
+      fail();
+      return nullptr;
+    }
+    const char* ptr = reinterpret_cast<const char*>(data_ + pos_);
+    pos_ += len;
+    return ptr;
+  }
+  bool skip(size_t len) {
+    return bytes(len) != nullptr;
+  }
+  size_t remaining() const {
+    return len_ - pos_;
+  }
+  bool ok() const {
+    return !failed_;
+  }
+
+private:
+  const uint8_t* data_;
+  size_t len_;
+  size_t pos_ = 0;
+  bool failed_ = false;
+
+  bool fail() {
+    failed_ = true;
+    return false;
+  }
+};
+
+struct BlobHeader {
+  uint32_t magic = BLOB_MAGIC;
+  uint16_t version = BLOB_VERSION;
+  uint16_t count = 0;
+  uint32_t schemaHash = 0;
+  uint32_t payloadLen = 0;
+  uint32_t crc = 0;
+};
+
+// Writes BLOB_HEADER_SIZE bytes to dst.
+void writeHeader(uint8_t* dst, const BlobHeader& header);
+
+// Validates magic, version, length and CRC. On success `header` is filled and
+// `payload` points at the first entry.
+bool readHeader(const uint8_t* blob, size_t len, BlobHeader& header, const uint8_t*& payload);
+
+} // namespace cm::storage
@@ -0,0 +1,94 @@
+#include "AdmissionControl.h"
+
+#include "../ConfigManagerConfig.h"
+
+namespace {
+
+constexpr const char* CLASS_NAMES[] = {"critical", "interactive", "bulk"};
+
+size_t indexOf(cm::web::RequestClass cls) {
+  const size_t index = static_cast<size_t>(cls);
+  return index < static_cast<size_t>(cm::web::RequestClass::Count) ? index : static_cast<size_t>(cm::web::RequestClass::Bulk);
+}
+
+} // namespace
+
+cm::web::AdmissionController::AdmissionController() {
+  AdmissionLimits critical;
+  critical.maxActive = CM_HTTP_MAX_CRITICAL;
+  setLimits(RequestClass::Critical, critical);
+
+  AdmissionLimits interactive;
+  interactive.maxActive = CM_HTTP_MAX_INTERACTIVE;
+  interactive.minFreeHeap = CM_HTTP_MIN_FREE_HEAP / 2;
+  interactive.minLargestBlock = CM_HTTP_MIN_LARGEST_BLOCK / 2;
+  setLimits(RequestClass::Interactive, interactive);
+
+  AdmissionLimits bulk;
+  bulk.maxActive = CM_HTTP_MAX_BULK;
+  bulk.minFreeHeap = CM_HTTP_MIN_FREE_HEAP;
+  bulk.minLargestBlock = CM_HTTP_MIN_LARGEST_BLOCK;
+  setLimits(RequestClass::Bulk, bulk);
+}
+
+void cm::web::AdmissionController::setLimits(RequestClass cls, const AdmissionLimits& limits) {
+  classes_[indexOf(cls)].limits = limits;
+}
+
+cm::web::AdmissionLimits cm::web::AdmissionController::limits(RequestClass cls) const {
+  return classes_[indexOf(cls)].limits;
+}
+
+// Only the web server task acquires and releases, so check-then-increment is not racy.
+cm::web::AdmissionController::Decision cm::web::AdmissionController::tryAcquire(RequestClass cls, uint32_t freeHeap, uint32_t largestBlock) {
+  ClassState& state = classes_[indexOf(cls)];
+  const uint32_t active = state.active.load(std::memory_order_relaxed);
+  if (state.limits.maxActive && active >= state.limits.maxActive) {
+    state.rejectedBusy.fetch_add(1, std::memory_order_relaxed);
+    return Decision::Busy;
+  }
+  if (freeHeap < state.limits.minFreeHeap || largestBlock < state.limits.minLargestBlock) {
+    state.rejectedHeap.fetch_add(1, std::memory_order_relaxed);
+    return Decision::LowHeap;
+  }
+  state.active.store(active + 1, std::memory_order_relaxed);
+  if (active + 1 > state.peakActive.load(std::memory_order_relaxed)) {
+    state.peakActive.store(active + 1, std::memory_order_relaxed);
+  }
+  state.admitted.fetch_add(1, std::memory_order_relaxed);
+  return Decision::Admitted;
+}
+
+void cm::web::AdmissionController::release(RequestClass cls) {
+  ClassState& state = classes_[indexOf(cls)];
+  const uint32_t active = state.active.load(std::memory_order_relaxed);
+  if (active > 0) {
+    state.active.store(active - 1, std::memory_order_relaxed);
+  }
+}
+
+cm::web::AdmissionClassStats cm::web::AdmissionController::stats(RequestClass cls) const {
+  const ClassState& state = classes_[indexOf(cls)];
+  AdmissionClassStats stats;
+  stats.name = className(cls);
+  stats.active = state.active.load(std::memory_order_relaxed);
+  stats.peakActive = state.peakActive.load(std::memory_order_relaxed);
+  stats.admitted = state.admitted.load(std::memory_order_relaxed);
+  stats.rejectedBusy = state.rejectedBusy.load(std::memory_order_relaxed);
+  stats.rejectedHeap = state.rejectedHeap.load(std::memory_order_relaxed);
+  return stats;
+}
+
+// Active requests keep their slots; only the counters restart.
+void cm::web::AdmissionController::resetStats() {
+  for (ClassState& state : classes_) {
+    state.peakActive.store(state.active.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    state.admitted.store(0, std::memory_order_relaxed);
+    state.rejectedBusy.store(0, std::memory_order_relaxed);
+    state.rejectedHeap.store(0, std::memory_order_relaxed);
+  }
+}
+
+const char* cm::web::AdmissionController::className(RequestClass cls) {
+  return CLASS_NAMES[indexOf(cls)];
+}
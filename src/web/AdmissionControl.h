@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace cm::web {
+
+// Admission classes for HTTP routes, highest priority first.
+enum class RequestClass : uint8_t {
+  Critical,    // OTA upload, save, reset, reboot
+  Interactive, // Apply, runtime and GUI actions
+  Bulk,        // config/runtime documents and polling
+  Count,
+};
+
+struct AdmissionLimits {
+  uint32_t maxActive = 0;       // Requests of the class in flight at once; 0 = unlimited
+  uint32_t minFreeHeap = 0;     // Free heap needed to admit; 0 = no floor
+  uint32_t minLargestBlock = 0; // Largest free block needed to admit; 0 = no floor
+};
+
+struct AdmissionClassStats {
+  const char* name = "";
+  uint32_t active = 0;
+  uint32_t peakActive = 0;
+  uint32_t admitted = 0;
+  uint32_t rejectedBusy = 0; // maxActive reached
+  uint32_t rejectedHeap = 0; // Below the heap floor
+};
+
+// Per-class concurrency limits and heap floors for the web server. The caller passes
+// the current heap figures so the policy stays independent of the platform. A request
+// holds its slot from tryAcquire() until release(), normally when the request object
+// is destroyed. Counters are atomics so they can be read from the loop task.
+class AdmissionController {
+public:
+  enum class Decision : uint8_t {
+    Admitted,
+    Busy,
+    LowHeap,
+  };
+
+  AdmissionController();
+
+  void setLimits(RequestClass cls, const AdmissionLimits& limits);
+  AdmissionLimits limits(RequestClass cls) const;
+
+  Decision tryAcquire(RequestClass cls, uint32_t freeHeap, uint32_t largestBlock);
+  void release(RequestClass cls);
+
+  AdmissionClassStats stats(RequestClass cls) const;
+  void resetStats();
+
+  static const char* className(RequestClass cls);
+
+private:
+  struct ClassState {
+    AdmissionLimits limits;
+    std::atomic<uint32_t> active{0};
+    std::atomic<uint32_t> peakActive{0};
+    std::atomic<uint32_t> admitted{0};
+    std::atomic<uint32_t> rejectedBusy{0};
+    std::atomic<uint32_t> rejectedHeap{0};
+  };
+
+  ClassState classes_[static_cast<size_t>(RequestClass::Count)];
+};
+
+} // namespace cm::web
@@ -0,0 +1,346 @@
+#include "ConfigJsonStream.h"
+#include "../ConfigManager.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+bool sameText(const char* a, const char* b) {
+  if (a == b) {
+    return true;
+  }
+  return a && b && strcmp(a, b) == 0;
+}
+
+bool hasCard(const BaseSetting* setting) {
+  const char* card = setting->getCard();
+  return card && card[0];
+}
+
+} // namespace
+
+void cm::web::writeJsonString(Print& out, const char* value) {
+  writeJsonString(out, value, value ? strlen(value) : 0);
+}
+
+void cm::web::writeJsonString(Print& out, const char* value, size_t len) {
+  out.write('"');
+  size_t runStart = 0;
+  for (size_t i = 0; i < len; ++i) {
+    const unsigned char c = static_cast<unsigned char>(value[i]);
+    char escape = 0;
+    switch (c) {
+      case '"':
+        escape = '"';
+        break;
+      case '\\':
+        escape = '\\';
+        break;
+      case '\b':
+        escape = 'b';
+        break;
+      case '\f':
+        escape = 'f';
+        break;
+      case '\n':
+        escape = 'n';
+        break;
+      case '\r':
+        escape = 'r';
+        break;
+      case '\t':
+        escape = 't';
+        break;
+      default:
+        if (c >= 0x20) {
+          continue;
+        }
+        break;
+    }
+
+    out.write(reinterpret_cast<const uint8_t*>(value + runStart), i - runStart);
+    runStart = i + 1;
+    if (escape) {
+      const char pair[2] = {'\\', escape};
+      out.write(reinterpret_cast<const uint8_t*>(pair), sizeof(pair));
+    } else {
+      char unicode[8];
+      snprintf(unicode, sizeof(unicode), "\\u%04x", static_cast<unsigned>(c));
+      out.print(unicode);
+    }
+  }
+  out.write(reinterpret_cast<const uint8_t*>(value + runStart), len - runStart);
+  out.write('"');
+}
+
+void cm::web::writeJsonNumber(Print& out, int value) {
+  char scratch[16];
+  snprintf(scratch, sizeof(scratch), "%d", value);
+  out.print(scratch);
+}
+
+void cm::web::writeJsonNumber(Print& out, float value) {
+  if (std::isnan(value) || std::isinf(value)) {
+    out.print("null");
+    return;
+  }
+  char scratch[24];
+  snprintf(scratch, sizeof(scratch), "%.7g", static_cast<double>(value));
+  out.print(scratch);
+}
+
+void cm::web::writeJsonBool(Print& out, bool value) {
+  out.print(value ? "true" : "false");
+}
+
+size_t cm::web::WindowPrint::write(const uint8_t* data, size_t size) {
+  const size_t take = std::min(capacity_ - emitted_, size);
+  if (take > 0) {
+    memcpy(buffer_ + emitted_, data, take);
+    emitted_ += take;
+  }
+  if (take < size) {
+    overflow_.concat(reinterpret_cast<const char*>(data + take), size - take);
+  }
+  return size;
+}
+
+size_t cm::web::drainPending(String& pending, size_t& offset, uint8_t* buffer, size_t maxLen) {
+  if (pending.length() == 0) {
+    return 0;
+  }
+  const size_t take = std::min(maxLen, pending.length() - offset);
+  memcpy(buffer, pending.c_str() + offset, take);
+  offset += take;
+  if (offset >= pending.length()) {
+    pending = String();
+    offset = 0;
+  }
+  return take;
+}
+
+size_t cm::web::StringPrint::write(uint8_t c) {
+  target_ += static_cast<char>(c);
+  return 1;
+}
+
+size_t cm::web::StringPrint::write(const uint8_t* buffer, size_t size) {
+  target_.concat(reinterpret_cast<const char*>(buffer), size);
+  return size;
+}
+
+cm::web::ConfigJsonStream::ConfigJsonStream(const std::vector<BaseSetting*>& settings, bool includeSecrets, uint32_t changedSince)
+    : settings_(settings), includeSecrets_(includeSecrets), changedSince_(changedSince), categoryDone_(settings.size()), cardDone_(settings.size()) {
+}
+
+size_t cm::web::ConfigJsonStream::read(uint8_t* buffer, size_t maxLen) {
+  size_t written = drainPending(pending_, pendingOffset_, buffer, maxLen);
+  while (written < maxLen && step_ != Step::Done) {
+    WindowPrint window(buffer + written, maxLen - written, pending_);
+    renderFragment(window);
+    written += window.emitted();
+    advance();
+  }
+  return written;
+}
+
+void cm::web::ConfigJsonStream::writeTo(Print& out) {
+  while (step_ != Step::Done) {
+    renderFragment(out);
+    advance();
+  }
+}
+
+void cm::web::ConfigJsonStream::renderFragment(Print& out) const {
+  switch (step_) {
+    case Step::RootOpen:
+      out.write('{');
+      break;
+    case Step::CategoryOpen: {
+      const BaseSetting* s = settings_[category_];
+      if (!firstCategory_) {
+        out.write(',');
+      }
+      writeJsonString(out, s->getCategory());
+      out.print(":{\"categoryPretty\":"); // Used by frontend Category.vue
+      writeJsonString(out, s->getCategoryPretty());
+      break;
+    }
+    case Step::PlainSetting:
+      out.write(',');
+      settings_[item_]->writeJSON(out);
+      break;
+    case Step::CardsOpen:
+      out.print(",\"cards\":{");
+      break;
+    case Step::CardOpen: {
+      const BaseSetting* s = settings_[card_];
+      if (!firstCard_) {
+        out.write(',');
+      }
+      writeJsonString(out, s->getCard());
+      out.print(":{");
+      const char* cardPretty = s->getCardPretty();
+      if (cardPretty && cardPretty[0]) {
+        out.print("\"cardPretty\":");
+        writeJsonString(out, cardPretty);
+        out.write(',');
+      }
+      out.print("\"cardOrder\":");
+      writeJsonNumber(out, s->getCardOrder());
+      out.print(",\"settings\":{");
+      break;
+    }
+    case Step::CardSetting:
+      if (!firstCardSetting_) {
+        out.write(',');
+      }
+      settings_[item_]->writeJSON(out);
+      break;
+    case Step::CardClose:
+      out.print("}}");
+      break;
+    case Step::CardsClose:
+    case Step::CategoryClose:
+    case Step::RootClose:
+      out.write('}');
+      break;
+    case Step::Done:
+      break;
+  }
+}
+
+void cm::web::ConfigJsonStream::advance() {
+  const size_t count = settings_.size();
+  switch (step_) {
+    case Step::RootOpen:
+      category_ = nextCategory(0);
+      markCategory(category_);
+      step_ = category_ < count ? Step::CategoryOpen : Step::RootClose;
+      break;
+    case Step::CategoryOpen:
+    case Step::PlainSetting:
+      item_ = nextPlainSetting(step_ == Step::CategoryOpen ? category_ : item_ + 1);
+      if (item_ < count) {
+        step_ = Step::PlainSetting;
+        break;
+      }
+      card_ = nextCard(category_);
+      step_ = card_ < count ? Step::CardsOpen : Step::CategoryClose;
+      break;
+    case Step::CardsOpen:
+      firstCard_ = true;
+      markCard(card_);
+      step_ = Step::CardOpen;
+      break;
+    case Step::CardOpen:
+    case Step::CardSetting:
+      firstCardSetting_ = step_ == Step::CardOpen;
+      item_ = nextCardSetting(step_ == Step::CardOpen ? card_ : item_ + 1);
+      step_ = item_ < count ? Step::CardSetting : Step::CardClose;
+      break;
+    case Step::CardClose:
+      card_ = nextCard(card_ + 1);
+      markCard(card_);
+      firstCard_ = false;
+      step_ = card_ < count ? Step::CardOpen : Step::CardsClose;
+      break;
+    case Step::CardsClose:
+      step_ = Step::CategoryClose;
+      break;
+    case Step::CategoryClose:
+      category_ = nextCategory(category_ + 1);
+      markCategory(category_);
+      firstCategory_ = false;
+      step_ = category_ < count ? Step::CategoryOpen : Step::RootClose;
+      break;
+    case Step::RootClose:
+    case Step::Done:
+      step_ = Step::Done;
+      break;
+  }
+}
+
+bool cm::web::ConfigJsonStream::isVisible(size_t index) const {
+  // Do not pre-filter dynamic visibility here; include all web-visible
+  // settings and let the UI honor the resolved showIf boolean.
+  const BaseSetting* s = settings_[index];
+  if (!s || !s->shouldShowInWeb()) {
+    return false;
+  }
+  if (changedSince_ == 0 || s->hasDynamicVisibility()) {
+    return true;
+  }
+  // Wrap-safe "generation > changedSince".
+  return static_cast<int32_t>(s->getGeneration() - changedSince_) > 0;
+}
+
+bool cm::web::ConfigJsonStream::isEmitted(size_t index) const {
+  return isVisible(index) && (includeSecrets_ || !settings_[index]->isSecret());
+}
+
+// Categories and cards are opened in order of first appearance; marking the rest of
+// their settings once keeps the next*() scans linear instead of rescanning from the start.
+void cm::web::ConfigJsonStream::markCategory(size_t head) {
+  if (head >= settings_.size()) {
+    return;
+  }
+  const char* category = settings_[head]->getCategory();
+  for (size_t i = head; i < settings_.size(); ++i) {
+    if (!categoryDone_[i] && sameText(settings_[i]->getCategory(), category)) {
+      categoryDone_[i] = true;
+    }
+  }
+}
+
+void cm::web::ConfigJsonStream::markCard(size_t head) {
+  if (head >= settings_.size()) {
+    return;
+  }
+  const BaseSetting* s = settings_[head];
+  for (size_t i = head; i < settings_.size(); ++i) {
+    if (!cardDone_[i] && hasCard(settings_[i]) && sameText(settings_[i]->getCategory(), s->getCategory()) && sameText(settings_[i]->getCard(), s->getCard())) {
+      cardDone_[i] = true;
+    }
+  }
+}
+
+size_t cm::web::ConfigJsonStream::nextCategory(size_t from) const {
+  for (size_t i = from; i < settings_.size(); ++i) {
+    if (!categoryDone_[i] && isVisible(i)) {
+      return i;
+    }
+  }
+  return settings_.size();
+}
+
+size_t cm::web::ConfigJsonStream::nextPlainSetting(size_t from) const {
+  const char* category = settings_[category_]->getCategory();
+  for (size_t i = from; i < settings_.size(); ++i) {
+    if (isEmitted(i) && !hasCard(settings_[i]) && sameText(settings_[i]->getCategory(), category)) {
+      return i;
+    }
+  }
+  return settings_.size();
+}
+
+size_t cm::web::ConfigJsonStream::nextCard(size_t from) const {
+  const char* category = settings_[category_]->getCategory();
+  for (size_t i = from; i < settings_.size(); ++i) {
+    if (!cardDone_[i] && isVisible(i) && hasCard(settings_[i]) && sameText(settings_[i]->getCategory(), category)) {
+      return i;
+    }
+  }
+  return settings_.size();
+}
+
+size_t cm::web::ConfigJsonStream::nextCardSetting(size_t from) const {
+  const BaseSetting* head = settings_[card_];
+  for (size_t i = from; i < settings_.size(); ++i) {
+    if (isEmitted(i) && hasCard(settings_[i]) && sameText(settings_[i]->getCategory(), head->getCategory()) && sameText(settings_[i]->getCard(), head->getCard())) {
+      return i;
+    }
+  }
+  return settings_.size();
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class BaseSetting;
+
+namespace cm::web {
+
+// Compact JSON primitives shared by the streaming writers.
+// Escaping matches ArduinoJson so streamed and document-built payloads agree.
+void writeJsonString(Print& out, const char* value);
+void writeJsonString(Print& out, const char* value, size_t len);
+void writeJsonNumber(Print& out, int value);
+void writeJsonNumber(Print& out, float value);
+void writeJsonBool(Print& out, bool value);
+
+// Appends everything written to a String (used by the String-returning toJSON()).
+class StringPrint final : public Print {
+public:
+  explicit StringPrint(String& target) : target_(target) {}
+
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+
+private:
+  String& target_;
+};
+
+// Print sink over a caller buffer; what does not fit is appended to `overflow`.
+// A fragment is rendered once: the streams hand out the overflow on the next read()
+// instead of rendering it again, so a value that changes between chunks cannot
+// tear the document.
+class WindowPrint final : public Print {
+public:
+  WindowPrint(uint8_t* buffer, size_t capacity, String& overflow)
+      : buffer_(buffer), capacity_(capacity), overflow_(overflow) {}
+
+  size_t write(uint8_t c) override {
+    return write(&c, 1);
+  }
+  size_t write(const uint8_t* data, size_t size) override;
+
+  size_t emitted() const {
+    return emitted_;
+  }
+
+private:
+  uint8_t* buffer_;
+  size_t capacity_;
+  String& overflow_;
+  size_t emitted_ = 0;
+};
+
+// Copies what is left of `pending` (from `offset`) into the buffer; releases it once drained.
+size_t drainPending(String& pending, size_t& offset, uint8_t* buffer, size_t maxLen);
+
+// Streams /config.json one fragment at a time (category header, setting, card, ...).
+// Bytes are written straight into the caller's buffer; the tail of a fragment that
+// does not fit is held until the next read(). Besides two bits per setting that
+// mark the categories and cards already written, memory use does not depend on
+// the number of settings or categories.
+//
+// With changedSince != 0 only settings whose generation is newer than that settings
+// epoch are emitted (plus settings with a showIf predicate, whose resolved visibility
+// can change with other settings); categories and cards without such settings are
+// omitted. The result has the same shape as the full document and merges into it.
+class ConfigJsonStream {
+public:
+  ConfigJsonStream(const std::vector<BaseSetting*>& settings, bool includeSecrets, uint32_t changedSince = 0);
+
+  // Fills up to maxLen bytes; returns 0 once the document is complete.
+  size_t read(uint8_t* buffer, size_t maxLen);
+  void writeTo(Print& out);
+  bool done() const {
+    return step_ == Step::Done && pending_.length() == 0;
+  }
+
+private:
+  enum class Step : uint8_t {
+    RootOpen,
+    CategoryOpen,
+    PlainSetting,
+    CardsOpen,
+    CardOpen,
+    CardSetting,
+    CardClose,
+    CardsClose,
+    CategoryClose,
+    RootClose,
+    Done
+  };
+
+  const std::vector<BaseSetting*>& settings_;
+  bool includeSecrets_;
+  uint32_t changedSince_;
+  Step step_ = Step::RootOpen;
+  size_t category_ = 0;
+  size_t card_ = 0;
+  size_t item_ = 0;
+  bool firstCategory_ = true;
+  bool firstCard_ = true;
+  bool firstCardSetting_ = true;
+  String pending_;
+  size_t pendingOffset_ = 0;
+  std::vector<bool> categoryDone_; // Setting belongs to a category already opened
+  std::vector<bool> cardDone_;     // Setting belongs to a card already opened
+
+  void renderFragment(Print& out) const;
+  void advance();
+
+  bool isVisible(size_t index) const;
+  bool isEmitted(size_t index) const;
+  void markCategory(size_t head);
+  void markCard(size_t head);
+  size_t nextCategory(size_t from) const;
+  size_t nextPlainSetting(size_t from) const;
+  size_t nextCard(size_t from) const;
+  size_t nextCardSetting(size_t from) const;
+};
+
+} // namespace cm::web
@@ -0,0 +1,54 @@
+#include "HttpCache.h"
+
+#include <cstring>
+
+namespace {
+
+bool isListSpace(char c) {
+  return c == ' ' || c == '\t';
+}
+
+const char* stripWeakPrefix(const char* tag, size_t& len) {
+  if (len >= 2 && tag[0] == 'W' && tag[1] == '/') {
+    len -= 2;
+    return tag + 2;
+  }
+  return tag;
+}
+
+} // namespace
+
+bool cm::web::etagListMatches(const char* header, const char* etag) {
+  if (!header || !etag) {
+    return false;
+  }
+  size_t etagLen = strlen(etag);
+  etag = stripWeakPrefix(etag, etagLen);
+  if (etagLen == 0) {
+    return false;
+  }
+
+  const char* cursor = header;
+  while (*cursor) {
+    while (isListSpace(*cursor) || *cursor == ',') {
+      ++cursor;
+    }
+    const char* start = cursor;
+    while (*cursor && *cursor != ',') {
+      ++cursor;
+    }
+    const char* end = cursor;
+    while (end > start && isListSpace(end[-1])) {
+      --end;
+    }
+    size_t len = static_cast<size_t>(end - start);
+    if (len == 1 && *start == '*') {
+      return true;
+    }
+    const char* tag = stripWeakPrefix(start, len);
+    if (len == etagLen && strncmp(tag, etag, len) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+namespace cm::web {
+
+// If-None-Match check (RFC 9110 weak comparison): header is a comma-separated list of
+// entity tags, optionally W/-prefixed, or "*". etag is the quoted tag we would send.
+bool etagListMatches(const char* header, const char* etag);
+
+} // namespace cm::web
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <cstdint>
+
+class ConfigManagerClass;
+
+namespace cm::web {
+
+// Runtime control actions, shared by the /runtime_action/* routes and the /ws command channel.
+enum class RuntimeActionKind : uint8_t {
+  Button,
+  Checkbox,
+  StateButton,
+  IntSlider,
+  FloatSlider,
+  IntInput,
+  FloatInput,
+};
+
+// Reads the action value from JSON; hasValue tells whether one was sent at all.
+// Returns false when the kind needs a value and none was sent, or takes none and one was.
+bool parseRuntimeActionValue(RuntimeActionKind kind, bool hasValue, JsonVariantConst value, bool& boolValue, int& intValue, float& floatValue);
+
+// Runs the action on the runtime manager; false when a required value is missing.
+bool dispatchRuntimeAction(ConfigManagerClass* configManager, RuntimeActionKind kind, const String& group, const String& key, bool hasValue, bool boolValue, int intValue, float floatValue);
+
+} // namespace cm::web
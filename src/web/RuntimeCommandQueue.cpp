@@ -0,0 +1,110 @@
+#include "RuntimeCommandQueue.h"
+
+#include <ArduinoJson.h>
+#include <cstring>
+#include <esp_timer.h>
+#include <utility>
+
+namespace {
+
+struct KindName {
+  const char* name;
+  cm::web::RuntimeActionKind kind;
+};
+
+constexpr KindName KIND_NAMES[] = {
+  {"b", cm::web::RuntimeActionKind::Button},
+  {"cb", cm::web::RuntimeActionKind::Checkbox},
+  {"sb", cm::web::RuntimeActionKind::StateButton},
+  {"is", cm::web::RuntimeActionKind::IntSlider},
+  {"fs", cm::web::RuntimeActionKind::FloatSlider},
+  {"ii", cm::web::RuntimeActionKind::IntInput},
+  {"fi", cm::web::RuntimeActionKind::FloatInput},
+};
+
+bool kindFromName(const char* name, cm::web::RuntimeActionKind& out) {
+  if (!name) {
+    return false;
+  }
+  for (const KindName& entry : KIND_NAMES) {
+    // Cppcheck rationale: Keep the allocation-free, early-exit loop on the embedded target.
+    // cppcheck-suppress useStlAlgorithm
+    if (strcmp(entry.name, name) == 0) {
+      out = entry.kind;
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+cm::web::RuntimeCommandQueue::RuntimeCommandQueue(size_t capacity)
+    : capacity_(capacity > 0 ? capacity : 1) {
+  pending_.reserve(capacity_);
+}
+
+bool cm::web::RuntimeCommandQueue::parse(const uint8_t* data, size_t len, RuntimeCommand& out) {
+  JsonDocument doc;
+  if (!data || deserializeJson(doc, data, len) != DeserializationError::Ok) {
+    return false;
+  }
+  JsonArrayConst command = doc.as<JsonArrayConst>();
+  if (command.isNull() || !command[0].is<uint32_t>()) {
+    return false;
+  }
+  out.seq = command[0].as<uint32_t>();
+  if (command.size() < 4 || command.size() > 5 || !command[2].is<const char*>() || !command[3].is<const char*>() ||
+      !kindFromName(command[1].as<const char*>(), out.kind)) {
+    return false;
+  }
+  out.group = command[2].as<const char*>();
+  out.key = command[3].as<const char*>();
+  out.hasValue = command.size() == 5;
+  out.receivedUs = esp_timer_get_time();
+  return parseRuntimeActionValue(out.kind, out.hasValue, command[4], out.boolValue, out.intValue, out.floatValue);
+}
+
+const char* cm::web::RuntimeCommandQueue::kindName(RuntimeActionKind kind) {
+  for (const KindName& entry : KIND_NAMES) {
+    // Cppcheck rationale: Keep the allocation-free, early-exit loop on the embedded target.
+    // cppcheck-suppress useStlAlgorithm
+    if (entry.kind == kind) {
+      return entry.name;
+    }
+  }
+  return "";
+}
+
+bool cm::web::RuntimeCommandQueue::coalesces(const RuntimeCommand& command) {
+  return command.hasValue && command.kind != RuntimeActionKind::Button;
+}
+
+cm::web::RuntimeCommandQueue::PushResult cm::web::RuntimeCommandQueue::push(RuntimeCommand&& command) {
+  if (coalesces(command)) {
+    for (RuntimeCommand& pending : pending_) {
+      if (pending.clientId != command.clientId || pending.kind != command.kind || !coalesces(pending) ||
+          pending.key != command.key || pending.group != command.group) {
+        continue;
+      }
+      // Latest wins; latency is still measured from the first value that waited.
+      const int64_t receivedUs = pending.receivedUs;
+      pending = std::move(command);
+      pending.receivedUs = receivedUs;
+      return PushResult::Coalesced;
+    }
+  }
+  if (pending_.size() >= capacity_) {
+    return PushResult::Full;
+  }
+  pending_.push_back(std::move(command));
+  return PushResult::Queued;
+}
+
+void cm::web::RuntimeCommandQueue::drain(std::vector<RuntimeCommand>& out) {
+  out.clear();
+  std::swap(out, pending_);
+  if (pending_.capacity() < capacity_) {
+    pending_.reserve(capacity_);
+  }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "RuntimeActionDispatch.h"
+
+namespace cm::web {
+
+// One runtime action received over /ws or a /runtime_action/* route.
+struct RuntimeCommand {
+  uint32_t clientId = 0; // WebSocket client to acknowledge; 0 for HTTP requests
+  uint32_t seq = 0;
+  RuntimeActionKind kind = RuntimeActionKind::Button;
+  String group;
+  String key;
+  bool hasValue = false;
+  bool boolValue = false;
+  int intValue = 0;
+  float floatValue = 0.0f;
+  int64_t receivedUs = 0; // esp_timer time of receipt; kept from the oldest command it replaced
+};
+
+// Runtime actions waiting for dispatch on the loop task. They arrive through the
+// loop mailbox (see ConfigManagerClass::postToLoop()), so the queue itself is only
+// touched by the loop task and needs no lock.
+//
+// A command that sets a value (slider, input, checkbox, state button with a value)
+// replaces the pending one of the same client for the same control: only the latest
+// value is dispatched and only its sequence number is acknowledged. Button presses
+// and toggles are never merged. At most `capacity` commands are pending.
+class RuntimeCommandQueue {
+public:
+  enum class PushResult : uint8_t {
+    Queued,
+    Coalesced, // Replaced a pending command
+    Full,
+  };
+
+  explicit RuntimeCommandQueue(size_t capacity);
+
+  // Wire format: [seq,"kind","group","key",value] with kind one of b (button),
+  // cb (checkbox), sb (state button), is/fs (int/float slider), ii/fi (int/float
+  // input). The value is left out for buttons and state button toggles.
+  // seq is filled in whenever it could be read, also when false is returned.
+  static bool parse(const uint8_t* data, size_t len, RuntimeCommand& out);
+  static const char* kindName(RuntimeActionKind kind);
+
+  PushResult push(RuntimeCommand&& command);
+  // Moves all pending commands, oldest first, into out (cleared first). Keep `out`
+  // around between calls: the two vectors swap their storage, so draining does not
+  // allocate once both have reached capacity.
+  void drain(std::vector<RuntimeCommand>& out);
+  size_t size() const {
+    return pending_.size();
+  }
+  size_t capacity() const {
+    return capacity_;
+  }
+
+private:
+  std::vector<RuntimeCommand> pending_;
+  size_t capacity_;
+
+  static bool coalesces(const RuntimeCommand& command);
+};
+
+} // namespace cm::web
@@ -0,0 +1,79 @@
+#include "RuntimeHistoryJsonStream.h"
+#include "ConfigJsonStream.h"
+
+#include <utility>
+
+cm::web::RuntimeHistoryJsonStream::RuntimeHistoryJsonStream(const String& field, const char* resolution, cm::runtime::RuntimeHistorySeries series)
+    : field_(field), resolution_(resolution), series_(std::move(series)) {
+}
+
+size_t cm::web::RuntimeHistoryJsonStream::read(uint8_t* buffer, size_t maxLen) {
+  size_t written = drainPending(pending_, pendingOffset_, buffer, maxLen);
+  while (written < maxLen && step_ != Step::Done) {
+    WindowPrint window(buffer + written, maxLen - written, pending_);
+    renderFragment(window);
+    written += window.emitted();
+    advance();
+  }
+  return written;
+}
+
+void cm::web::RuntimeHistoryJsonStream::renderFragment(Print& out) const {
+  switch (step_) {
+    case Step::Header:
+      out.print("{\"field\":");
+      writeJsonString(out, field_.c_str(), field_.length());
+      out.print(",\"res\":");
+      writeJsonString(out, resolution_);
+      out.print(",\"intervalMs\":");
+      out.print(series_.intervalMs);
+      out.print(",\"startMs\":");
+      out.print(series_.startMs);
+      out.print(",\"scale\":");
+      writeJsonNumber(out, series_.scale);
+      out.print(",\"buckets\":[");
+      break;
+    case Step::Bucket: {
+      const cm::runtime::RuntimeHistoryBucket& b = series_.buckets[bucket_];
+      if (bucket_ > 0) {
+        out.write(',');
+      }
+      if (b.min == cm::runtime::RuntimeHistory::GAP) {
+        out.print("null");
+        break;
+      }
+      out.write('[');
+      writeJsonNumber(out, static_cast<int>(b.min));
+      out.write(',');
+      writeJsonNumber(out, static_cast<int>(b.avg));
+      out.write(',');
+      writeJsonNumber(out, static_cast<int>(b.max));
+      out.write(']');
+      break;
+    }
+    case Step::Close:
+      out.print("]}");
+      break;
+    case Step::Done:
+      break;
+  }
+}
+
+void cm::web::RuntimeHistoryJsonStream::advance() {
+  switch (step_) {
+    case Step::Header:
+      bucket_ = 0;
+      step_ = series_.buckets.empty() ? Step::Close : Step::Bucket;
+      break;
+    case Step::Bucket:
+      ++bucket_;
+      if (bucket_ >= series_.buckets.size()) {
+        step_ = Step::Close;
+      }
+      break;
+    case Step::Close:
+    case Step::Done:
+      step_ = Step::Done;
+      break;
+  }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+
+#include "../runtime/RuntimeHistory.h"
+
+namespace cm::web {
+
+// Streams one /runtime_history.json series from a snapshot, one bucket per fragment:
+//   {"field":"<group>.<key>","res":"1m","intervalMs":60000,"startMs":<uptime>,
+//    "scale":0.01,"buckets":[[min,avg,max],null,...]}
+// Bucket values are multiples of `scale`, oldest first; null marks a bucket without
+// samples. The last bucket is still being filled.
+class RuntimeHistoryJsonStream {
+public:
+  RuntimeHistoryJsonStream(const String& field, const char* resolution, cm::runtime::RuntimeHistorySeries series);
+
+  // Fills up to maxLen bytes; returns 0 once the document is complete.
+  size_t read(uint8_t* buffer, size_t maxLen);
+
+private:
+  enum class Step : uint8_t {
+    Header,
+    Bucket,
+    Close,
+    Done
+  };
+
+  String field_;
+  const char* resolution_;
+  cm::runtime::RuntimeHistorySeries series_;
+  Step step_ = Step::Header;
+  size_t bucket_ = 0;
+  String pending_;
+  size_t pendingOffset_ = 0;
+
+  void renderFragment(Print& out) const;
+  void advance();
+};
+
+} // namespace cm::web
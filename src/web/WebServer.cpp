@@ -2,9 +2,14 @@
 #include "../ConfigManager.h"
 #include "../settings.h"
 #include "WebRequestBodyBuffer.h"
+#include "ConfigJsonStream.h"
+#include "HttpCache.h"
+#include "RuntimeHistoryJsonStream.h"
 
 #include <AsyncJson.h>
+#include <algorithm>
 #include <cstring>
+#include <memory>
 #include <esp_heap_caps.h>
 #include <new>
 #include <utility>
@@ -213,6 +218,64 @@ bool parseForceFlag(AsyncWebServerRequest* request) {
   return value == "1" || value == "true" || value == "yes";
 }
 
+// Revision format: "<bootId>-<settingsEpoch>", both as 8 hex digits.
+static constexpr size_t CONFIG_REVISION_BUFFER_SIZE = 18;
+
+void formatConfigRevision(uint32_t bootId, uint32_t epoch, char (&out)[CONFIG_REVISION_BUFFER_SIZE]) {
+  snprintf(out, sizeof(out), "%08lx-%08lx", static_cast<unsigned long>(bootId), static_cast<unsigned long>(epoch));
+}
+
+// Returns the epoch of a revision issued during this boot; revisions from a previous
+// boot (or malformed ones) yield false so the caller falls back to the full document.
+bool parseConfigRevision(const String& revision, uint32_t bootId, uint32_t& epoch) {
+  if (revision.length() != CONFIG_REVISION_BUFFER_SIZE - 1 || revision[8] != '-') {
+    return false;
+  }
+  char* end = nullptr;
+  const unsigned long parsedBootId = strtoul(revision.c_str(), &end, 16);
+  if (end != revision.c_str() + 8 || parsedBootId != bootId) {
+    return false;
+  }
+  const unsigned long parsedEpoch = strtoul(revision.c_str() + 9, &end, 16);
+  if (*end != '\0') {
+    return false;
+  }
+  epoch = static_cast<uint32_t>(parsedEpoch);
+  return true;
+}
+
+bool etagMatches(AsyncWebServerRequest* request, const char* etag) {
+  if (!request->hasHeader("If-None-Match")) {
+    return false;
+  }
+  return cm::web::etagListMatches(request->getHeader("If-None-Match")->value().c_str(), etag);
+}
+
+// Serves a gzipped document from flash, or 304 when the client already holds this ETag.
+// The browser revalidates on every load, which costs one round trip instead of the body.
+void sendGzipDocument(AsyncWebServerRequest* request, const uint8_t* data, size_t len, const char* etag) {
+  const char* cacheControl = "no-cache";
+  if (etagMatches(request, etag)) {
+    AsyncWebServerResponse* response = request->beginResponse(304);
+    response->addHeader("ETag", etag);
+    response->addHeader("Cache-Control", cacheControl);
+    request->send(response);
+    return;
+  }
+  AsyncWebServerResponse* response = request->beginResponse_P(200, "text/html", data, len);
+  response->addHeader("Content-Encoding", "gzip");
+  response->addHeader("ETag", etag);
+  response->addHeader("Cache-Control", cacheControl);
+  request->send(response);
+}
+
+#if CM_EMBED_WEBUI
+void formatBundleEtag(char* out, size_t size) {
+  WebHTML webhtml;
+  snprintf(out, size, "\"%s\"", webhtml.getWebHTMLGzHash());
+}
+#endif
+
 class RequestContextScope {
 public:
   RequestContextScope(ConfigManagerClass* manager, const ConfigRequestContext& ctx)
@@ -236,6 +299,7 @@ private:
 void ConfigManagerWeb::begin(ConfigManagerClass* cm) {
   configManager = cm;
   initialized = true;
+  configBootId = esp_random();
   WEB_LOG("Web server module initialized");
 }
 
@@ -287,6 +351,12 @@ void ConfigManagerWeb::setEmbedWebUI(bool embed) {
 void ConfigManagerWeb::setCustomHTML(const char* html, size_t length) {
   customHTML = html;
   customHTMLLen = length;
+  // FNV-1a over the gzipped bytes, once, so page loads can be answered with 304.
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; html && i < length; ++i) {
+    hash = (hash ^ static_cast<uint8_t>(pgm_read_byte(html + i))) * 16777619u;
+  }
+  snprintf(customHTMLEtag, sizeof(customHTMLEtag), "\"c%08lx\"", static_cast<unsigned long>(hash));
 }
 
 bool ConfigManagerWeb::isStarted() const {
@@ -354,10 +424,24 @@ void ConfigManagerWeb::setupStaticRoutes() {
     }
 #endif
 
+    // setCustomCss() bumps the revision; the boot id covers a firmware with other CSS.
+    char etag[32];
+    snprintf(etag,
+             sizeof(etag),
+             "\"%08lx-css%lu\"",
+             static_cast<unsigned long>(configBootId),
+             static_cast<unsigned long>(configManager ? configManager->getCustomCssRevision() : 0));
+    if (etagMatches(request, etag)) {
+      AsyncWebServerResponse* notModified = request->beginResponse(304);
+      notModified->addHeader("ETag", etag);
+      notModified->addHeader("Cache-Control", "no-cache");
+      request->send(notModified);
+      return;
+    }
+
     auto* response = request->beginResponseStream("text/css");
-    response->addHeader("Cache-Control", "no-cache, no-store, must-revalidate");
-    response->addHeader("Pragma", "no-cache");
-    response->addHeader("Expires", "0");
+    response->addHeader("ETag", etag);
+    response->addHeader("Cache-Control", "no-cache");
     if (css && (len > 0 || (usingBuiltin && css[0] != '\0'))) {
       if (len) {
         response->write(reinterpret_cast<const uint8_t*>(css), len);
@@ -423,6 +507,13 @@ void ConfigManagerWeb::setupAPIRoutes() {
     out["appTitle"] = (configManager && configManager->getAppTitle().length()) ? configManager->getAppTitle() : String("");
     out["version"] = (configManager && configManager->getVersion().length()) ? configManager->getVersion() : String("");
     out["guiLogging"] = (configManager && configManager->isGuiLoggingEnabled()) ? true : false;
+    // Content hash of the embedded WebUI, also used as the ETag of /.
+#if CM_EMBED_WEBUI
+    WebHTML webhtml;
+    out["webuiHash"] = webhtml.getWebHTMLGzHash();
+#else
+    out["webuiHash"] = "";
+#endif
     String resp;
     serializeJson(out, resp);
 
@@ -444,6 +535,11 @@ void ConfigManagerWeb::setupAPIRoutes() {
             }
 
             if (index + len == total) {
+                // Saves like /config/save, so it takes the same admission slot.
+                if (!admit(request, cm::web::RequestClass::Critical)) {
+                    cm::web::clearRequestBodyBuffer(request);
+                    return;
+                }
                 WEB_LOG_VERBOSE("config_raw done: params=%d bodyLen=%u",
                                 request->params(), static_cast<unsigned>(body->length()));
 
@@ -497,66 +593,26 @@ void ConfigManagerWeb::setupAPIRoutes() {
 
   // Configuration endpoints
   server->on("/config.json", HTTP_GET, [this](AsyncWebServerRequest* request) {
-    if (configJsonProvider) {
-      try {
-        String json = configJsonProvider();
-        size_t jsonSize = json.length();
-
-        // Log the JSON size for debugging
-        WEB_LOG_VERBOSE("config.json size=%u", (unsigned)jsonSize);
-
-        // Check if JSON is empty or too large
-        if (jsonSize == 0) {
-          WEB_LOG("Error: Generated JSON is empty!");
-          request->send(500, "application/json", "{\"error\":\"empty_json\"}");
-          return;
-        }
-
-        if (jsonSize > 4096) { // Prefer chunked mode early to reduce heap pressure/fragmentation.
-          WEB_LOG_VERBOSE("config.json chunked response (%u)", (unsigned)jsonSize);
-          auto jsonShared = std::make_shared<String>(std::move(json));
-
-          AsyncWebServerResponse* response = request->beginChunkedResponse("application/json",
-                                                                           [jsonShared](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
-                                                                             if (!jsonShared || index >= jsonShared->length()) {
-                                                                               return 0;
-                                                                             }
-
-                                                                             size_t remaining = jsonShared->length() - index;
-                                                                             if (remaining == 0)
-                                                                               return 0; // End of data
-
-                                                                             size_t chunkSize = min(maxLen, remaining);
-                                                                             memcpy(buffer, jsonShared->c_str() + index, chunkSize);
-                                                                             return chunkSize;
-                                                                           });
-          if (!response) {
-            WEB_LOG("Error: beginChunkedResponse failed for config.json");
-            request->send(500, "application/json", "{\"error\":\"response_alloc_failed\"}");
-            return;
-          }
-          enableCORS(response);
-          request->send(response);
-        } else {
-          // Normal response for smaller JSON
-          AsyncWebServerResponse* response = request->beginResponse(200, "application/json", json);
-          if (!response) {
-            WEB_LOG("Error: beginResponse failed for config.json");
-            request->send(500, "application/json", "{\"error\":\"response_alloc_failed\"}");
-            return;
-          }
-          enableCORS(response);
-          request->send(response);
-        }
-
-        WEB_LOG_VERBOSE("config.json sent (%u)", (unsigned)jsonSize);
-      } catch (const std::exception& e) {
-        WEB_LOG("Exception in config.json: %s", e.what());
-        request->send(500, "application/json", "{\"error\":\"json_generation_failed\"}");
-      } catch (...) {
-        WEB_LOG("Unknown exception in config.json generation");
-        request->send(500, "application/json", "{\"error\":\"unknown_error\"}");
+    if (!admit(request, cm::web::RequestClass::Bulk)) {
+      return;
+    }
+    if (configManager) {
+      handleConfigJsonRequest(request);
+    } else if (configJsonProvider) {
+      const String json = configJsonProvider();
+      if (json.isEmpty()) {
+        WEB_LOG("Error: Generated JSON is empty!");
+        request->send(500, "application/json", "{\"error\":\"empty_json\"}");
+        return;
       }
+      AsyncWebServerResponse* response = request->beginResponse(200, "application/json", json);
+      if (!response) {
+        WEB_LOG("Error: beginResponse failed for config.json");
+        request->send(500, "application/json", "{\"error\":\"response_alloc_failed\"}");
+        return;
+      }
+      enableCORS(response);
+      request->send(response);
     } else {
       request->send(500, "application/json", "{\"error\":\"no_provider\"}");
     }
@@ -577,6 +633,9 @@ void ConfigManagerWeb::setupAPIRoutes() {
   // Use AsyncCallbackJsonWebHandler to avoid edge cases with raw body accumulation.
   {
     auto* handler = new AsyncCallbackJsonWebHandler("/config/apply", [this](AsyncWebServerRequest* request, JsonVariant& json) {
+      if (!admit(request, cm::web::RequestClass::Interactive)) {
+        return;
+      }
       WEB_LOG_VERBOSE("/config/apply request");
 
       const String category = request->hasParam("category") ? request->getParam("category")->value() : "";
@@ -653,6 +712,9 @@ void ConfigManagerWeb::setupAPIRoutes() {
   }
 
   server->on("/gui/action", HTTP_POST, [this](AsyncWebServerRequest* request) {
+    if (!admit(request, cm::web::RequestClass::Interactive)) {
+      return;
+    }
     auto readParam = [request](const char* name) -> String {
       AsyncWebParameter* param = request->getParam(name, false);
       if (!param) {
@@ -661,14 +723,19 @@ void ConfigManagerWeb::setupAPIRoutes() {
       return param ? param->value() : String();
     };
 
-    const String actionId = readParam("actionId");
-    const String messageId = readParam("messageId");
-    bool handled = false;
-    if (configManager) {
-      handled = configManager->handleGuiAction(messageId, actionId);
+    // The callback runs on the loop task; an unknown message id is only logged there.
+    ConfigManagerClass::LoopMutation mutation;
+    mutation.kind = ConfigManagerClass::LoopMutation::Kind::GuiAction;
+    mutation.actionId = readParam("actionId");
+    mutation.messageId = readParam("messageId");
+    int status = 400;
+    const char* body = "{\"status\":\"error\"}";
+    if (configManager && !mutation.messageId.isEmpty()) {
+      const bool posted = configManager->postToLoop(std::move(mutation));
+      status = posted ? 200 : 503;
+      body = posted ? "{\"status\":\"ok\"}" : "{\"status\":\"error\",\"reason\":\"busy\"}";
     }
-    const String body = String("{\"status\":\"") + (handled ? "ok" : "error") + "\"}";
-    AsyncWebServerResponse* response = request->beginResponse(handled ? 200 : 400, "application/json", body);
+    AsyncWebServerResponse* response = request->beginResponse(status, "application/json", body);
     enableCORS(response);
     request->send(response);
   });
@@ -677,6 +744,9 @@ void ConfigManagerWeb::setupAPIRoutes() {
   // Use AsyncCallbackJsonWebHandler to avoid edge cases with chunked/unknown body sizes.
   {
     auto* handler = new AsyncCallbackJsonWebHandler("/config/save", [this](AsyncWebServerRequest* request, JsonVariant& json) {
+      if (!admit(request, cm::web::RequestClass::Critical)) {
+        return;
+      }
       WEB_LOG_VERBOSE("/config/save request");
 
       const String category = request->hasParam("category") ? request->getParam("category")->value() : "";
@@ -869,84 +939,11 @@ void ConfigManagerWeb::setupAPIRoutes() {
   // Use AsyncCallbackJsonWebHandler to avoid edge cases with chunked/unknown body sizes.
   {
     auto* handler = new AsyncCallbackJsonWebHandler("/config/apply_all", [this](AsyncWebServerRequest* request, JsonVariant& json) {
-      WEB_LOG_VERBOSE("/config/apply_all request");
-
-      if (!json.is<JsonObject>()) {
-        AsyncWebServerResponse* response = request->beginResponse(400, "application/json", "{\"status\":\"error\",\"reason\":\"invalid_json\"}");
-        enableCORS(response);
-        request->send(response);
+      if (!admit(request, cm::web::RequestClass::Interactive)) {
         return;
       }
-
-      bool allSuccess = true;
-      int totalApplied = 0;
-
-      const bool forceFlag = parseForceFlag(request);
-      JsonObject root = json.as<JsonObject>();
-      for (JsonPair categoryPair : root) {
-        const String category = categoryPair.key().c_str();
-        if (!categoryPair.value().is<JsonObject>()) {
-          allSuccess = false;
-          continue;
-        }
-
-        JsonObject categoryObj = categoryPair.value().as<JsonObject>();
-        for (JsonPair settingPair : categoryObj) {
-          const String key = settingPair.key().c_str();
-          const JsonVariant v = settingPair.value();
-
-          String value;
-          if (v.is<const char*>()) {
-            value = v.as<String>();
-          } else if (v.is<bool>()) {
-            value = v.as<bool>() ? "true" : "false";
-          } else if (v.is<int>()) {
-            value = String(v.as<int>());
-          } else if (v.is<float>()) {
-            value = String(v.as<float>(), 6);
-          } else {
-            serializeJson(v, value);
-          }
-
-          String requestPayload;
-          {
-            StaticJsonDocument<128> payloadDoc;
-            payloadDoc["value"] = v;
-            serializeJson(payloadDoc, requestPayload);
-          }
-
-          bool callResult = false;
-          if (settingApplyCallback) {
-            ConfigRequestContext ctx;
-            ctx.origin = ConfigRequestContext::Origin::ApplyAll;
-            ctx.endpoint = request->url();
-            ctx.payload = requestPayload;
-            ctx.force = forceFlag;
-            RequestContextScope scope(configManager, ctx);
-            callResult = settingApplyCallback(category, key, value);
-          }
-
-          if (callResult) {
-            totalApplied++;
-            WEB_LOG("Applied %s.%s = %s", category.c_str(), key.c_str(), value.c_str());
-          } else {
-            allSuccess = false;
-            WEB_LOG("Failed to apply %s.%s = %s", category.c_str(), key.c_str(), value.c_str());
-          }
-        }
-      }
-
-      if (allSuccess && totalApplied > 0) {
-        const String payload = String("{\"status\":\"ok\",\"action\":\"apply_all\",\"applied\":") + String(totalApplied) + "}";
-        AsyncWebServerResponse* response = request->beginResponse(200, "application/json", payload);
-        enableCORS(response);
-        request->send(response);
-      } else {
-        const String payload = String("{\"status\":\"error\",\"action\":\"apply_all\",\"applied\":") + String(totalApplied) + "}";
-        AsyncWebServerResponse* response = request->beginResponse(400, "application/json", payload);
-        enableCORS(response);
-        request->send(response);
-      }
+      WEB_LOG_VERBOSE("/config/apply_all request");
+      handleBulkSettingsRequest(request, json, false);
     });
     handler->setMethod(HTTP_POST);
     server->addHandler(handler);
@@ -956,84 +953,11 @@ void ConfigManagerWeb::setupAPIRoutes() {
   // Use AsyncCallbackJsonWebHandler to avoid edge cases with chunked/unknown body sizes.
   {
     auto* handler = new AsyncCallbackJsonWebHandler("/config/save_all", [this](AsyncWebServerRequest* request, JsonVariant& json) {
-      WEB_LOG("Processing /config/save_all");
-
-      if (!json.is<JsonObject>()) {
-        AsyncWebServerResponse* response = request->beginResponse(400, "application/json", "{\"status\":\"error\",\"reason\":\"invalid_json\"}");
-        enableCORS(response);
-        request->send(response);
+      if (!admit(request, cm::web::RequestClass::Critical)) {
         return;
       }
-
-      bool allSuccess = true;
-      int totalSaved = 0;
-
-      const bool forceFlag = parseForceFlag(request);
-      JsonObject root = json.as<JsonObject>();
-      for (JsonPair categoryPair : root) {
-        const String category = categoryPair.key().c_str();
-        if (!categoryPair.value().is<JsonObject>()) {
-          allSuccess = false;
-          continue;
-        }
-
-        JsonObject categoryObj = categoryPair.value().as<JsonObject>();
-        for (JsonPair settingPair : categoryObj) {
-          const String key = settingPair.key().c_str();
-          const JsonVariant v = settingPair.value();
-
-          String value;
-          if (v.is<const char*>()) {
-            value = v.as<String>();
-          } else if (v.is<bool>()) {
-            value = v.as<bool>() ? "true" : "false";
-          } else if (v.is<int>()) {
-            value = String(v.as<int>());
-          } else if (v.is<float>()) {
-            value = String(v.as<float>(), 6);
-          } else {
-            serializeJson(v, value);
-          }
-
-          String requestPayload;
-          {
-            StaticJsonDocument<128> payloadDoc;
-            payloadDoc["value"] = v;
-            serializeJson(payloadDoc, requestPayload);
-          }
-
-          bool callResult = false;
-          if (settingUpdateCallback) {
-            ConfigRequestContext ctx;
-            ctx.origin = ConfigRequestContext::Origin::SaveAll;
-            ctx.endpoint = request->url();
-            ctx.payload = requestPayload;
-            ctx.force = forceFlag;
-            RequestContextScope scope(configManager, ctx);
-            callResult = settingUpdateCallback(category, key, value);
-          }
-
-          if (callResult) {
-            totalSaved++;
-            WEB_LOG("Saved %s.%s = %s", category.c_str(), key.c_str(), value.c_str());
-          } else {
-            allSuccess = false;
-            WEB_LOG("Failed to save %s.%s = %s", category.c_str(), key.c_str(), value.c_str());
-          }
-        }
-      }
-
-      if (allSuccess && totalSaved > 0) {
-        const String payload = String("{\"status\":\"ok\",\"action\":\"save_all\",\"saved\":") + String(totalSaved) + "}";
-        AsyncWebServerResponse* response = request->beginResponse(200, "application/json", payload);
-        enableCORS(response);
-        request->send(response);
-      } else {
-        const String payload = String("{\"status\":\"error\",\"action\":\"save_all\",\"saved\":") + String(totalSaved) + "}";
-        AsyncWebServerResponse* response = request->beginResponse(400, "application/json", payload);
-        enableCORS(response);
-        request->send(response);
-      }
+      WEB_LOG("Processing /config/save_all");
+      handleBulkSettingsRequest(request, json, true);
     });
     handler->setMethod(HTTP_POST);
     server->addHandler(handler);
@@ -1041,6 +965,9 @@ void ConfigManagerWeb::setupAPIRoutes() {
 
   // Reset to defaults
   server->on("/config/reset", HTTP_POST, [this](AsyncWebServerRequest* request) {
+    if (!admit(request, cm::web::RequestClass::Critical)) {
+      return;
+    }
     if (resetCallback) {
       resetCallback();
       request->send(200, "application/json", "{\"status\":\"reset\"}");
@@ -1051,6 +978,9 @@ void ConfigManagerWeb::setupAPIRoutes() {
 
   // Reboot endpoint
   server->on("/reboot", HTTP_POST, [this](AsyncWebServerRequest* request) {
+    if (!admit(request, cm::web::RequestClass::Critical)) {
+      return;
+    }
     AsyncWebServerResponse* response = request->beginResponse(200, "application/json", "{\"status\":\"rebooting\"}");
     response->addHeader("Connection", "close");
     request->send(response);
@@ -1065,18 +995,15 @@ void ConfigManagerWeb::setupAPIRoutes() {
 void ConfigManagerWeb::handleRootRequest(AsyncWebServerRequest* request) {
   if (customHTML && customHTMLLen > 0) {
     // Use custom HTML
-    AsyncWebServerResponse* response = request->beginResponse_P(200, "text/html", reinterpret_cast<const uint8_t*>(customHTML), customHTMLLen);
-    response->addHeader("Content-Encoding", "gzip");
-    request->send(response);
+    sendGzipDocument(request, reinterpret_cast<const uint8_t*>(customHTML), customHTMLLen, customHTMLEtag);
   } else if (embedWebUI) {
 #if CM_EMBED_WEBUI
-    // Use embedded WebUI
+    // Use embedded WebUI; "/" must pick up a firmware update, so it is revalidated
+    // (304 while the build hash is unchanged) rather than cached as immutable.
     WebHTML webhtml;
-    const uint8_t* html = webhtml.getWebHTMLGz();
-    size_t len = webhtml.getWebHTMLGzLen();
-    AsyncWebServerResponse* response = request->beginResponse_P(200, "text/html", html, len);
-    response->addHeader("Content-Encoding", "gzip");
-    request->send(response);
+    char etag[24];
+    formatBundleEtag(etag, sizeof(etag));
+    sendGzipDocument(request, webhtml.getWebHTMLGz(), webhtml.getWebHTMLGzLen(), etag);
 #else
     request->send(404, "text/html", "<h1>WebUI not embedded</h1><p>This firmware was built with CM_EMBED_WEBUI=0</p>");
 #endif
@@ -1208,7 +1135,171 @@ void ConfigManagerWeb::enableCORS(AsyncWebServerResponse* response) {
   }
   response->addHeader("Access-Control-Allow-Origin", "*");
   response->addHeader("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
-  response->addHeader("Access-Control-Allow-Headers", "Content-Type, Authorization, X-Settings-Token");
+  response->addHeader("Access-Control-Allow-Headers", "Content-Type, Authorization, X-Settings-Token, If-None-Match");
+}
+
+// The slot is released when the request object is destroyed (connection closed).
+cm::web::AdmissionController::Decision ConfigManagerWeb::acquireRequestSlot(AsyncWebServerRequest* request, cm::web::RequestClass cls) {
+  const auto decision = admission.tryAcquire(cls, ESP.getFreeHeap(), heap_caps_get_largest_free_block(MALLOC_CAP_8BIT));
+  if (decision == cm::web::AdmissionController::Decision::Admitted) {
+    request->onDisconnect([this, cls]() { admission.release(cls); });
+  }
+  return decision;
+}
+
+bool ConfigManagerWeb::admit(AsyncWebServerRequest* request, cm::web::RequestClass cls) {
+  const auto decision = acquireRequestSlot(request, cls);
+  if (decision == cm::web::AdmissionController::Decision::Admitted) {
+    return true;
+  }
+  const bool busy = decision == cm::web::AdmissionController::Decision::Busy;
+  WEB_LOG_VERBOSE("[W] %s refused (%s, %s): free=%u largest=%u",
+                  request->url().c_str(),
+                  cm::web::AdmissionController::className(cls),
+                  busy ? "busy" : "low_heap",
+                  static_cast<unsigned>(ESP.getFreeHeap()),
+                  static_cast<unsigned>(heap_caps_get_largest_free_block(MALLOC_CAP_8BIT)));
+  char body[80];
+  snprintf(body,
+           sizeof(body),
+           "{\"status\":\"error\",\"reason\":\"%s\",\"class\":\"%s\"}",
+           busy ? "busy" : "low_heap",
+           cm::web::AdmissionController::className(cls));
+  AsyncWebServerResponse* response = request->beginResponse(503, "application/json", body);
+  response->addHeader("Retry-After", String(CM_HTTP_RETRY_AFTER_S));
+  response->addHeader("Cache-Control", "no-store");
+  enableCORS(response);
+  request->send(response);
+  return false;
+}
+
+// Stages every {category: {key: value}} pair in one transaction: either all values are
+// applied (and, for save_all, persisted in one NVS session) or none are. Values are
+// validated here; the transaction is committed by the loop task (postTransactionToLoop()).
+void ConfigManagerWeb::handleBulkSettingsRequest(AsyncWebServerRequest* request, JsonVariant& json, bool persist) {
+  const char* action = persist ? "save_all" : "apply_all";
+  const char* countKey = persist ? "saved" : "applied";
+
+  if (!json.is<JsonObject>()) {
+    AsyncWebServerResponse* response = request->beginResponse(400, "application/json", "{\"status\":\"error\",\"reason\":\"invalid_json\"}");
+    enableCORS(response);
+    request->send(response);
+    return;
+  }
+
+  size_t committed = 0;
+  size_t rejected = 0;
+  bool busy = false;
+  if (configManager) {
+    // One context for the whole batch; the payload is the full body so a
+    // "Force anyway" from the pin validation popup resubmits the complete transaction.
+    ConfigRequestContext ctx;
+    ctx.origin = persist ? ConfigRequestContext::Origin::SaveAll : ConfigRequestContext::Origin::ApplyAll;
+    ctx.endpoint = request->url();
+    serializeJson(json, ctx.payload);
+    ctx.force = parseForceFlag(request);
+    RequestContextScope scope(configManager, ctx);
+
+    auto tx = std::make_unique<ConfigManagerClass::Transaction>(*configManager, persist);
+    for (JsonPair categoryPair : json.as<JsonObject>()) {
+      const String category = categoryPair.key().c_str();
+      if (!categoryPair.value().is<JsonObject>()) {
+        ++rejected;
+        continue;
+      }
+      for (JsonPair settingPair : categoryPair.value().as<JsonObject>()) {
+        const String key = settingPair.key().c_str();
+        const JsonVariantConst value = settingPair.value();
+        if (!tx->stage(category, key, value)) {
+          ++rejected;
+          WEB_LOG("Rejected %s.%s", category.c_str(), key.c_str());
+        }
+      }
+    }
+    rejected += tx->validateIOPins();
+
+    const size_t staged = tx->stagedCount();
+    if (rejected == 0 && staged > 0) {
+      if (configManager->postTransactionToLoop(std::move(tx))) {
+        committed = staged;
+      } else {
+        busy = true;
+      }
+    }
+  }
+
+  const bool ok = committed > 0;
+  WEB_LOG("%s: %u committed, %u rejected%s", action, static_cast<unsigned>(committed), static_cast<unsigned>(rejected), busy ? ", busy" : "");
+  char payload[112];
+  snprintf(payload,
+           sizeof(payload),
+           "{\"status\":\"%s\",\"action\":\"%s\",\"%s\":%u,\"rejected\":%u%s}",
+           ok ? "ok" : "error",
+           action,
+           countKey,
+           static_cast<unsigned>(committed),
+           static_cast<unsigned>(rejected),
+           busy ? ",\"reason\":\"busy\"" : "");
+  AsyncWebServerResponse* response = request->beginResponse(ok ? 200 : (busy ? 503 : 400), "application/json", payload);
+  enableCORS(response);
+  request->send(response);
+}
+
+void ConfigManagerWeb::handleConfigJsonRequest(AsyncWebServerRequest* request) {
+  // The revision only moves when a setting's generation is bumped, so an unchanged
+  // epoch means the document is byte-identical to the one the client already holds.
+  char revision[CONFIG_REVISION_BUFFER_SIZE];
+  formatConfigRevision(configBootId, ConfigManagerClass::getSettingsEpoch(), revision);
+  char etag[CONFIG_REVISION_BUFFER_SIZE + 2];
+  snprintf(etag, sizeof(etag), "\"%s\"", revision);
+
+  uint32_t since = 0;
+  if (request->hasParam("since")) {
+    if (!parseConfigRevision(request->getParam("since")->value(), configBootId, since)) {
+      WEB_LOG_VERBOSE("config.json: stale or invalid since revision, sending full document");
+    }
+  }
+  const bool delta = since != 0;
+
+  if (!delta && etagMatches(request, etag)) {
+    AsyncWebServerResponse* response = request->beginResponse(304);
+    if (!response) {
+      request->send(500, "application/json", "{\"error\":\"response_alloc_failed\"}");
+      return;
+    }
+    response->addHeader("ETag", etag);
+    response->addHeader("X-Config-Revision", revision);
+    response->addHeader("Access-Control-Expose-Headers", "ETag, X-Config-Revision, X-Config-Delta");
+    enableCORS(response);
+    request->send(response);
+    return;
+  }
+
+  // Stream the document fragment by fragment into the chunk buffer instead of
+  // building a JsonDocument and a String copy; peak heap is the stream object only.
+  auto stream = std::make_shared<cm::web::ConfigJsonStream>(configManager->getSettings(), true, since);
+  AsyncWebServerResponse* response = request->beginChunkedResponse("application/json",
+                                                                   [stream](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+                                                                     (void)index;
+                                                                     return stream->read(buffer, maxLen);
+                                                                   });
+  if (!response) {
+    WEB_LOG("Error: beginChunkedResponse failed for config.json");
+    request->send(500, "application/json", "{\"error\":\"response_alloc_failed\"}");
+    return;
+  }
+  // A delta is not a representation of the full resource, so it carries no ETag.
+  if (delta) {
+    response->addHeader("X-Config-Delta", "1");
+  } else {
+    response->addHeader("ETag", etag);
+  }
+  response->addHeader("X-Config-Revision", revision);
+  response->addHeader("Cache-Control", "no-cache");
+  response->addHeader("Access-Control-Expose-Headers", "ETag, X-Config-Revision, X-Config-Delta");
+  enableCORS(response);
+  request->send(response);
+  WEB_LOG_VERBOSE("config.json streaming (%u settings, %s)", (unsigned)configManager->getSettingsCount(), delta ? "delta" : "full");
 }
 
 void ConfigManagerWeb::enableCORSForAll(bool enable) {
@@ -1249,6 +1340,9 @@ void ConfigManagerWeb::setupRuntimeRoutes() {
 
   // Runtime JSON endpoint
   server->on("/runtime.json", HTTP_GET, [this](AsyncWebServerRequest* request) {
+    if (!admit(request, cm::web::RequestClass::Bulk)) {
+      return;
+    }
     if (runtimeJsonProvider) {
       String json = runtimeJsonProvider();
       AsyncWebServerResponse* response = new (std::nothrow) ClosingBasicResponse(200, "application/json", json);
@@ -1267,8 +1361,107 @@ void ConfigManagerWeb::setupRuntimeRoutes() {
     }
   });
 
+  // Same values as MessagePack; smaller and cheaper to encode than JSON
+  server->on("/runtime.msgpack", HTTP_GET, [this](AsyncWebServerRequest* request) {
+    if (!admit(request, cm::web::RequestClass::Bulk)) {
+      return;
+    }
+    auto payload = std::make_shared<std::vector<uint8_t>>(configManager->getRuntime().runtimeValuesToMsgPack());
+    if (payload->empty()) {
+      request->send(503, "application/json", "{\"error\":\"runtime_unavailable\"}");
+      return;
+    }
+    AsyncWebServerResponse* response = request->beginResponse("application/msgpack",
+                                                              payload->size(),
+                                                              [payload](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+                                                                const size_t take = std::min(maxLen, payload->size() - index);
+                                                                memcpy(buffer, payload->data() + index, take);
+                                                                return take;
+                                                              });
+    if (!response) {
+      request->send(503, "application/json", "{\"error\":\"runtime_unavailable\"}");
+      return;
+    }
+    enableCORS(response);
+    response->addHeader("Cache-Control", "no-cache, no-store, must-revalidate");
+    request->send(response);
+  });
+
+  // Recorded history of one field: ?field=<group>.<key>&res=1s|1m|15m (see RuntimeHistory.h)
+  server->on("/runtime_history.json", HTTP_GET, [this](AsyncWebServerRequest* request) {
+    if (!admit(request, cm::web::RequestClass::Bulk)) {
+      return;
+    }
+    if (!request->hasParam("field")) {
+      request->send(400, "application/json", "{\"status\":\"error\",\"reason\":\"missing_params\"}");
+      return;
+    }
+    const String field = request->getParam("field")->value();
+    const int resolution = cm::runtime::RuntimeHistory::resolutionIndex(request->hasParam("res") ? request->getParam("res")->value().c_str() : "1s");
+    if (resolution < 0) {
+      request->send(400, "application/json", "{\"status\":\"error\",\"reason\":\"invalid_res\"}");
+      return;
+    }
+    const int dot = field.indexOf('.');
+    const String group = dot >= 0 ? field.substring(0, dot) : String();
+    const String key = dot >= 0 ? field.substring(dot + 1) : field;
+
+    // The snapshot is copied under the history lock; streaming then runs without it.
+    cm::runtime::RuntimeHistorySeries series;
+    const cm::runtime::RuntimeHistory* history = configManager->getRuntime().getRuntimeHistory();
+    if (!history || !history->read(group, key, static_cast<size_t>(resolution), series)) {
+      request->send(404, "application/json", "{\"status\":\"error\",\"reason\":\"unknown_field\"}");
+      return;
+    }
+    auto stream = std::make_shared<cm::web::RuntimeHistoryJsonStream>(field, cm::runtime::RuntimeHistory::resolutionName(resolution), std::move(series));
+    AsyncWebServerResponse* response = request->beginChunkedResponse("application/json",
+                                                                     [stream](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+                                                                       (void)index;
+                                                                       return stream->read(buffer, maxLen);
+                                                                     });
+    if (!response) {
+      request->send(503, "application/json", "{\"error\":\"runtime_unavailable\"}");
+      return;
+    }
+    enableCORS(response);
+    response->addHeader("Cache-Control", "no-cache, no-store, must-revalidate");
+    request->send(response);
+  });
+
+#if CM_ENABLE_LOOP_PROFILER
+  // Loop latency histograms per subsystem (see LoopProfiler.h)
+  server->on("/perf.json", HTTP_GET, [this](AsyncWebServerRequest* request) {
+    if (!admit(request, cm::web::RequestClass::Bulk)) {
+      return;
+    }
+    JsonDocument doc;
+    doc["enabled"] = true;
+    doc["uptimeMs"] = millis();
+    cm::runtime::LoopProfiler::instance().toJSON(doc["sections"].to<JsonObject>(), true);
+    String json;
+    serializeJson(doc, json);
+    AsyncWebServerResponse* response = request->beginResponse(200, "application/json", json);
+    enableCORS(response);
+    response->addHeader("Cache-Control", "no-cache, no-store, must-revalidate");
+    request->send(response);
+  });
+
+  // Clearing the histograms requires a valid auth token returned by /config/auth.
+  server->on("/perf/reset", HTTP_POST, [this](AsyncWebServerRequest* request) {
+    if (!isSettingsAuthValid(request)) {
+      request->send(403, "application/json", "{\"status\":\"error\",\"reason\":\"unauthorized\"}");
+      return;
+    }
+    cm::runtime::LoopProfiler::instance().reset();
+    request->send(200, "application/json", "{\"status\":\"ok\"}");
+  });
+#endif
+
   // Runtime metadata endpoint
   server->on("/runtime_meta.json", HTTP_GET, [this](AsyncWebServerRequest* request) {
+    if (!admit(request, cm::web::RequestClass::Bulk)) {
+      return;
+    }
     if (runtimeMetaJsonProvider) {
       const uint32_t activeRequests = ++runtimeMetaActiveRequests;
       std::shared_ptr<const String> payload = runtimeMetaJsonProvider();
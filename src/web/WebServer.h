@@ -7,6 +7,7 @@
 #include <memory>
 #include <esp_system.h>
 #include "../ConfigManagerConfig.h"
+#include "AdmissionControl.h"
 
 #if CM_EMBED_WEBUI
 #include "../html_content.h"
@@ -35,6 +36,7 @@ private:
   JsonProvider runtimeJsonProvider;
   RuntimeMetaProvider runtimeMetaJsonProvider;
   std::atomic<uint32_t> runtimeMetaActiveRequests{0};
+  cm::web::AdmissionController admission;
   SimpleCallback rebootCallback;
   SimpleCallback resetCallback;
   SettingUpdateCallback settingUpdateCallback;
@@ -44,6 +46,7 @@ private:
   bool embedWebUI;
   const char* customHTML;
   size_t customHTMLLen;
+  char customHTMLEtag[12] = "";
 
   // Settings security
   String settingsPassword;
@@ -53,6 +56,10 @@ private:
   uint32_t settingsAuthIssuedAtMs = 0;
   static constexpr uint32_t SETTINGS_AUTH_TTL_MS = 5UL * 60UL * 1000UL; // 5 minutes
 
+  // Random per-boot id mixed into the /config.json revision; the settings epoch
+  // restarts on reboot, so the epoch alone could repeat an ETag from a previous boot.
+  uint32_t configBootId = 0;
+
   // Helper methods
   void setupStaticRoutes();
   void setupAPIRoutes();
@@ -76,6 +83,10 @@ private:
   void sendWebUI(AsyncWebServerRequest* request);
   void redirectToPortalRoot(AsyncWebServerRequest* request);
   void enableCORS(AsyncWebServerResponse* response);
+  void handleConfigJsonRequest(AsyncWebServerRequest* request);
+  void handleBulkSettingsRequest(AsyncWebServerRequest* request, JsonVariant& json, bool persist);
+  // Takes a slot of the class or answers 503 with Retry-After; false means the request was answered.
+  bool admit(AsyncWebServerRequest* request, cm::web::RequestClass cls);
   void log(const char* format, ...) const;
 
 public:
@@ -117,6 +128,16 @@ public:
   void defineAllRoutes();
   void addCustomRoute(const char* path, WebRequestMethodComposite method, RequestHandler handler);
 
+  // Admission control: per-class concurrency limits and heap floors (see AdmissionControl.h)
+  cm::web::AdmissionController& getAdmission() {
+    return admission;
+  }
+  const cm::web::AdmissionController& getAdmission() const {
+    return admission;
+  }
+  // Like admit() but leaves the refusal to the caller (e.g. an upload in progress).
+  cm::web::AdmissionController::Decision acquireRequestSlot(AsyncWebServerRequest* request, cm::web::RequestClass cls);
+
   // CORS and security
   void enableCORSForAll(bool enable = true);
   void setSettingsPassword(const String& password);
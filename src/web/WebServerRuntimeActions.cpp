@@ -1,21 +1,21 @@
 #include "WebServer.h"
 #include "../ConfigManager.h"
+#include "RuntimeActionDispatch.h"
+#include "RuntimeCommandQueue.h"
 #include "WebRequestBodyBuffer.h"
 
+#include <esp_timer.h>
+#include <utility>
+#include <vector>
+
 namespace {
 constexpr const char* kJsonOk = "{\"status\":\"ok\"}";
 constexpr const char* kJsonNoManager = "{\"status\":\"error\",\"reason\":\"no_manager\"}";
 constexpr const char* kJsonInvalid = "{\"status\":\"error\",\"reason\":\"invalid_json\"}";
+constexpr const char* kJsonBusy = "{\"status\":\"error\",\"reason\":\"busy\"}";
+constexpr const char* kJsonUnknownControl = "{\"status\":\"error\",\"reason\":\"unknown_control\"}";
 
-enum class RuntimeActionKind {
-  Button,
-  Checkbox,
-  StateButton,
-  IntSlider,
-  FloatSlider,
-  IntInput,
-  FloatInput,
-};
+using cm::web::RuntimeActionKind;
 
 bool parseFloatFromString(String valueStr, float& outValue) {
   valueStr.replace(",", ".");
@@ -53,6 +53,61 @@ bool parseQueryValue(RuntimeActionKind kind, AsyncWebServerRequest* request, boo
 
 bool parseBodyValue(RuntimeActionKind kind, JsonObject doc, bool& hasValue, bool& boolValue, int& intValue, float& floatValue) {
   hasValue = doc.containsKey("value");
+  return cm::web::parseRuntimeActionValue(kind, hasValue, doc["value"], boolValue, intValue, floatValue);
+}
+
+template <typename Control>
+bool containsControl(const std::vector<Control>& controls, const String& group, const String& key) {
+  for (const auto& control : controls) {
+    // Cppcheck rationale: Keep the allocation-free, early-exit loop on the embedded target.
+    // cppcheck-suppress useStlAlgorithm
+    if (control.group == group && control.key == key) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Checked before posting so an unknown control is answered with 400, not a queued 200.
+bool runtimeControlExists(ConfigManagerClass* configManager, RuntimeActionKind kind, const String& group, const String& key) {
+  const auto registry = configManager->getRuntimeManager().getControlRegistry();
+  switch (kind) {
+    case RuntimeActionKind::Button:
+      return containsControl(registry->buttons, group, key);
+    case RuntimeActionKind::Checkbox:
+      return containsControl(registry->checkboxes, group, key);
+    case RuntimeActionKind::StateButton:
+      return containsControl(registry->stateButtons, group, key);
+    case RuntimeActionKind::IntSlider:
+      return containsControl(registry->intSliders, group, key);
+    case RuntimeActionKind::FloatSlider:
+      return containsControl(registry->floatSliders, group, key);
+    case RuntimeActionKind::IntInput:
+      return containsControl(registry->intInputs, group, key);
+    case RuntimeActionKind::FloatInput:
+      return containsControl(registry->floatInputs, group, key);
+  }
+  return false;
+}
+
+// The action is dispatched by the loop task; the value was validated by the caller.
+bool postRuntimeAction(ConfigManagerClass* configManager, RuntimeActionKind kind, const String& group, const String& key, bool hasValue, bool boolValue, int intValue, float floatValue) {
+  ConfigManagerClass::LoopMutation mutation;
+  mutation.kind = ConfigManagerClass::LoopMutation::Kind::RuntimeAction;
+  cm::web::RuntimeCommand& command = mutation.action;
+  command.kind = kind;
+  command.group = group;
+  command.key = key;
+  command.hasValue = hasValue;
+  command.boolValue = boolValue;
+  command.intValue = intValue;
+  command.floatValue = floatValue;
+  command.receivedUs = esp_timer_get_time();
+  return configManager->postToLoop(std::move(mutation));
+}
+} // namespace
+
+bool cm::web::parseRuntimeActionValue(RuntimeActionKind kind, bool hasValue, JsonVariantConst value, bool& boolValue, int& intValue, float& floatValue) {
   if (!hasValue) {
     return kind == RuntimeActionKind::Button || kind == RuntimeActionKind::StateButton;
   }
@@ -62,21 +117,21 @@ bool parseBodyValue(RuntimeActionKind kind, JsonObject doc, bool& hasValue, bool
       return false;
     case RuntimeActionKind::Checkbox:
     case RuntimeActionKind::StateButton:
-      boolValue = doc["value"].as<bool>();
+      boolValue = value.as<bool>();
       return true;
     case RuntimeActionKind::IntSlider:
     case RuntimeActionKind::IntInput:
-      intValue = doc["value"].as<int>();
+      intValue = value.as<int>();
       return true;
     case RuntimeActionKind::FloatSlider:
     case RuntimeActionKind::FloatInput:
-      floatValue = doc["value"].as<float>();
+      floatValue = value.as<float>();
       return true;
   }
   return false;
 }
 
-bool dispatchRuntimeAction(ConfigManagerClass* configManager, RuntimeActionKind kind, const String& group, const String& key, bool hasValue, bool boolValue, int intValue, float floatValue) {
+bool cm::web::dispatchRuntimeAction(ConfigManagerClass* configManager, RuntimeActionKind kind, const String& group, const String& key, bool hasValue, bool boolValue, int intValue, float floatValue) {
   if (!configManager) {
     return false;
   }
@@ -126,7 +181,6 @@ bool dispatchRuntimeAction(ConfigManagerClass* configManager, RuntimeActionKind
   }
   return false;
 }
-} // namespace
 
 void ConfigManagerWeb::setupRuntimeActionRoutes() {
   auto registerRoute = [this](const char* path, RuntimeActionKind kind) {
@@ -139,6 +193,10 @@ void ConfigManagerWeb::setupRuntimeActionRoutes() {
 
                        if (request->hasParam("group") && request->hasParam("key"))
                        {
+                           if (!admit(request, cm::web::RequestClass::Interactive))
+                           {
+                               return;
+                           }
                            const String group = request->getParam("group")->value();
                            const String key = request->getParam("key")->value();
                            bool hasValue = false;
@@ -152,9 +210,15 @@ void ConfigManagerWeb::setupRuntimeActionRoutes() {
                                return;
                            }
 
-                           if (!dispatchRuntimeAction(configManager, kind, group, key, hasValue, boolValue, intValue, floatValue))
+                           if (!runtimeControlExists(configManager, kind, group, key))
                            {
-                               request->send(400, "application/json", kJsonInvalid);
+                               request->send(400, "application/json", kJsonUnknownControl);
+                               return;
+                           }
+
+                           if (!postRuntimeAction(configManager, kind, group, key, hasValue, boolValue, intValue, floatValue))
+                           {
+                               request->send(503, "application/json", kJsonBusy);
                                return;
                            }
 
@@ -186,6 +250,12 @@ void ConfigManagerWeb::setupRuntimeActionRoutes() {
                            return;
                        }
 
+                       if (!admit(request, cm::web::RequestClass::Interactive))
+                       {
+                           cm::web::clearRequestBodyBuffer(request);
+                           return;
+                       }
+
                        DynamicJsonDocument doc(256);
                        DeserializationError error = deserializeJson(doc, *body);
                        if (error || !doc.containsKey("group") || !doc.containsKey("key"))
@@ -202,14 +272,27 @@ void ConfigManagerWeb::setupRuntimeActionRoutes() {
                        int intValue = 0;
                        float floatValue = 0.0f;
 
-                       if (!parseBodyValue(kind, doc.as<JsonObject>(), hasValue, boolValue, intValue, floatValue) ||
-                           !dispatchRuntimeAction(configManager, kind, group, key, hasValue, boolValue, intValue, floatValue))
+                       if (!parseBodyValue(kind, doc.as<JsonObject>(), hasValue, boolValue, intValue, floatValue))
                        {
                            request->send(400, "application/json", kJsonInvalid);
                            cm::web::clearRequestBodyBuffer(request);
                            return;
                        }
 
+                       if (!runtimeControlExists(configManager, kind, group, key))
+                       {
+                           request->send(400, "application/json", kJsonUnknownControl);
+                           cm::web::clearRequestBodyBuffer(request);
+                           return;
+                       }
+
+                       if (!postRuntimeAction(configManager, kind, group, key, hasValue, boolValue, intValue, floatValue))
+                       {
+                           request->send(503, "application/json", kJsonBusy);
+                           cm::web::clearRequestBodyBuffer(request);
+                           return;
+                       }
+
                        request->send(200, "application/json", kJsonOk);
                        cm::web::clearRequestBodyBuffer(request); });
   };
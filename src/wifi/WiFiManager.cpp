@@ -702,6 +702,7 @@ void ConfigManagerWiFi::checkAutoReboot() {
     // Time for auto-reboot
     WIFI_LOG("Auto-reboot triggered after %lu ms without connection", timeSinceLastConnection);
     markRestartCause(kRestartCauseWiFiAutoReboot);
+    ConfigManager.flush();
     delay(50); // allow log to flush
     ESP.restart();
   }
@@ -879,6 +880,7 @@ void ConfigManagerWiFi::attemptConnect() {
                timeSinceLastGood,
                static_cast<unsigned int>(phase) + 1U);
       markRestartCause(kRestartCauseWiFiAutoReboot);
+      ConfigManager.flush();
       delay(50); // allow log to flush
       ESP.restart();
       return;
@@ -1,8 +1,19 @@
 // Updated tests for new ConfigOptions-based interface
 #include <Arduino.h>
 #include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include <deque>
+#include <thread>
 #include <unity.h>
 #include <ConfigManager.h>
+#include "alarm/AlarmManager.h"
+#include "core/CoreSettings.h"
+#include "io/IOManager.h"
+#include "runtime/SpscMailbox.h"
+#include "web/AdmissionControl.h"
+#include "web/HttpCache.h"
+#include "web/RuntimeCommandQueue.h"
+#include "web/RuntimeHistoryJsonStream.h"
 
 ConfigManagerClass testManager;
 
@@ -30,6 +41,16 @@ Config<int> hiddenUnlessFeature(ConfigOptions<int>{.key = "hid", .name = "Hidden
 // Setting without explicit key: verify auto-generated key length
 Config<int> autoKey(ConfigOptions<int>{.key = nullptr, .name = "No Key Setting", .category = "verylongcategoryname", .defaultValue = 7});
 
+// Storage key derived at compile time; duplicate hints in the registry fail the build
+CM_STORAGE_KEY_REGISTRY(testKeyHints, "tInt", "tBool", "tStr", "tFlt", "pwd", "cb", "cbl", "feat", "hid", "tConst");
+Config<int> constKey(ConfigOptions<int>{.key = "tConst", .name = "Const Key", .category = "cfg", .defaultValue = 5, .storageKey = CM_STORAGE_KEY("tConst")});
+
+// Metadata and defaults in a constexpr descriptor table (flash)
+constexpr ConfigDescriptor<int> descIntDescriptor{{.key = "tDescInt", .name = "Descriptor Int", .category = "desc", .sortOrder = 7}, 1883};
+constexpr ConfigDescriptor<String> descSecretDescriptor{{.key = "tDescPwd", .category = "desc", .isPassword = true}, "broker"};
+Config<int> descInt(descIntDescriptor);
+Config<String> descSecret(descSecretDescriptor);
+
 // ----------------------------------------------------------------------------
 // Helper to parse JSON produced by manager
 // ----------------------------------------------------------------------------
@@ -182,6 +203,2069 @@ void test_runtime_string_divider_and_order() {
   TEST_ASSERT_TRUE(alphaPos != -1 && betaPos != -1 && alphaPos < betaPos);
 }
 
+void test_runtime_registry_copy_on_write() {
+  ConfigManagerRuntime rt;
+  rt.addRuntimeProvider("late", [](JsonObject& o) { o["x"] = 1; }, 20);
+  rt.addRuntimeProvider("early", [](JsonObject& o) { o["y"] = 2; }, 10);
+  rt.registerRuntimeCheckbox("early", "flag", []() { return true; }, [](bool) {});
+
+  const std::shared_ptr<const RuntimeControlRegistry> held = rt.getControlRegistry();
+  TEST_ASSERT_EQUAL_STRING("early", held->providers[0].name.c_str());
+  TEST_ASSERT_EQUAL_UINT32(1, held->controlCount());
+
+  // Registration while a snapshot is held publishes a new registry and leaves the old one intact.
+  rt.registerRuntimeIntSlider("late", "level", []() { return 3; }, [](int) {}, 0, 10);
+  TEST_ASSERT_EQUAL_UINT32(1, held->controlCount());
+  TEST_ASSERT_EQUAL_UINT32(2, rt.getControlRegistry()->controlCount());
+  TEST_ASSERT_TRUE(held != rt.getControlRegistry());
+
+  const String values = rt.runtimeValuesToJSON();
+  TEST_ASSERT_NOT_EQUAL(-1, values.indexOf("\"flag\":true"));
+  TEST_ASSERT_NOT_EQUAL(-1, values.indexOf("\"level\":3"));
+  TEST_ASSERT_TRUE(values.indexOf("\"early\"") < values.indexOf("\"late\""));
+}
+
+void test_runtime_group_index() {
+  ConfigManagerRuntime rt;
+  // Controls registered before their group's provider are still attached to it.
+  rt.registerRuntimeCheckbox("shared", "flag", []() { return true; }, [](bool) {});
+  rt.addRuntimeProvider("shared", [](JsonObject& o) { o["a"] = 1; }, 10);
+  rt.addRuntimeProvider("other", [](JsonObject& o) { o["c"] = 3; }, 20);
+  rt.addRuntimeProvider("shared", [](JsonObject& o) { o["b"] = 2; }, 30);
+  rt.registerRuntimeIntSlider("orphan", "level", []() { return 7; }, [](int) {}, 0, 10);
+  rt.registerRuntimeFloatInput("orphan", "gain", []() { return 1.5f; }, [](float) {}, 0.0f, 2.0f);
+
+  const std::shared_ptr<const RuntimeControlRegistry> registry = rt.getControlRegistry();
+  TEST_ASSERT_EQUAL_UINT32(3, registry->groups.size());
+  TEST_ASSERT_EQUAL_UINT32(3, registry->controlCount());
+
+  const String values = rt.runtimeValuesToJSON();
+  JsonDocument doc;
+  TEST_ASSERT_TRUE(deserializeJson(doc, values) == DeserializationError::Ok);
+  // Both providers of "shared" fill one object; its controls follow the last one.
+  TEST_ASSERT_EQUAL_INT(1, doc["shared"]["a"].as<int>());
+  TEST_ASSERT_EQUAL_INT(2, doc["shared"]["b"].as<int>());
+  TEST_ASSERT_TRUE(doc["shared"]["flag"].as<bool>());
+  TEST_ASSERT_EQUAL_UINT32(3, doc["shared"].as<JsonObject>().size());
+  TEST_ASSERT_EQUAL_INT(3, doc["other"]["c"].as<int>());
+  TEST_ASSERT_EQUAL_UINT32(1, doc["other"].as<JsonObject>().size());
+  // A group with controls but no provider is still reported, after the provider groups.
+  TEST_ASSERT_EQUAL_INT(7, doc["orphan"]["level"].as<int>());
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.5f, doc["orphan"]["gain"].as<float>());
+  TEST_ASSERT_TRUE(values.indexOf("\"other\"") < values.indexOf("\"orphan\""));
+}
+
+void test_runtime_delta_frames() {
+  cm::runtime::RuntimeDeltaEncoder encoder;
+  JsonDocument full;
+  full["uptime"] = 1000;
+  full["sensors"]["temp"] = 21.5;
+  full["sensors"]["hum"] = 40;
+  full["relays"]["pump"] = true;
+
+  String frame;
+  TEST_ASSERT_TRUE(encoder.encode(full.as<JsonObjectConst>(), true, frame));
+  TEST_ASSERT_EQUAL_STRING("{\"uptime\":1000,\"sensors\":{\"temp\":21.5,\"hum\":40},\"relays\":{\"pump\":true}}", frame.c_str());
+  TEST_ASSERT_EQUAL_UINT32(3, encoder.trackedFields());
+  TEST_ASSERT_EQUAL_UINT32(frame.length(), encoder.lastKeyframeBytes());
+
+  // Unchanged state produces no frame, even though uptime moved on.
+  TEST_ASSERT_FALSE(encoder.encode(full.as<JsonObjectConst>(), false, frame));
+  TEST_ASSERT_EQUAL_UINT32(0, frame.length());
+  full["uptime"] = 1500;
+  TEST_ASSERT_FALSE(encoder.encode(full.as<JsonObjectConst>(), false, frame));
+  TEST_ASSERT_EQUAL_UINT32(0, encoder.sequence());
+
+  full["uptime"] = 2000;
+  full["sensors"]["hum"] = 41;
+  full["alarms"]["overheat"] = true;
+  TEST_ASSERT_TRUE(encoder.encode(full.as<JsonObjectConst>(), false, frame));
+  TEST_ASSERT_EQUAL_STRING("{\"type\":\"runtimeDelta\",\"seq\":1,\"values\":{\"uptime\":2000,\"sensors\":{\"hum\":41},\"alarms\":{\"overheat\":true}}}", frame.c_str());
+  TEST_ASSERT_EQUAL_UINT32(2, encoder.lastChangedFields());
+
+  full["relays"]["pump"] = false;
+  TEST_ASSERT_TRUE(encoder.encode(full.as<JsonObjectConst>(), false, frame));
+  TEST_ASSERT_EQUAL_STRING("{\"type\":\"runtimeDelta\",\"seq\":2,\"values\":{\"uptime\":2000,\"relays\":{\"pump\":false}}}", frame.c_str());
+
+  // A keyframe restarts the sequence.
+  TEST_ASSERT_TRUE(encoder.encode(full.as<JsonObjectConst>(), true, frame));
+  TEST_ASSERT_EQUAL_UINT32(0, encoder.sequence());
+  full["relays"]["pump"] = true;
+  TEST_ASSERT_TRUE(encoder.encode(full.as<JsonObjectConst>(), false, frame));
+  TEST_ASSERT_NOT_EQUAL(-1, frame.indexOf("\"seq\":1"));
+}
+
+void test_runtime_msgpack_frame() {
+  ConfigManagerRuntime rt;
+  rt.addRuntimeProvider("sensors", [](JsonObject& o) {
+    o["temp"] = 21.5f;
+    o["label"] = "ok";
+  });
+  rt.registerRuntimeCheckbox("sensors", "fan", []() { return true; }, [](bool) {});
+
+  const std::vector<uint8_t> packed = rt.runtimeValuesToMsgPack();
+  JsonDocument decoded;
+  TEST_ASSERT_TRUE(deserializeMsgPack(decoded, packed.data(), packed.size()) == DeserializationError::Ok);
+  TEST_ASSERT_EQUAL_FLOAT(21.5f, decoded["sensors"]["temp"].as<float>());
+  TEST_ASSERT_EQUAL_STRING("ok", decoded["sensors"]["label"]);
+  TEST_ASSERT_TRUE(decoded["sensors"]["fan"].as<bool>());
+  TEST_ASSERT_TRUE(packed.size() < rt.runtimeValuesToJSON().length());
+
+  // One frame, both encodings of the same delta.
+  String json;
+  std::vector<uint8_t> msgpack;
+  RuntimeFrameTargets targets;
+  targets.json = &json;
+  targets.msgpack = &msgpack;
+  TEST_ASSERT_TRUE(rt.runtimeFrame(true, true, targets));
+  delay(2); // uptime changes, so the delta is never empty
+  TEST_ASSERT_TRUE(rt.runtimeFrame(true, false, targets));
+  TEST_ASSERT_TRUE(deserializeMsgPack(decoded, msgpack.data(), msgpack.size()) == DeserializationError::Ok);
+  String reencoded;
+  serializeJson(decoded, reencoded);
+  TEST_ASSERT_EQUAL_STRING(json.c_str(), reencoded.c_str());
+}
+
+void test_runtime_compact_frames() {
+  // Same list as webui/test/runtimeCompact.test.mjs, so both sides agree on the hash.
+  cm::runtime::RuntimeFieldIds ids;
+  ids.add("sensors", "temp");
+  ids.add("sensors", "hum");
+  ids.add("relays", "pump");
+  ids.add("sensors", "temp"); // Listed twice: the first ID wins
+  ids.finish();
+  TEST_ASSERT_EQUAL_HEX32(0x9f000086, [] {
+    cm::runtime::RuntimeFieldIds three;
+    three.add("sensors", "temp");
+    three.add("sensors", "hum");
+    three.add("relays", "pump");
+    three.finish();
+    return three.tableHash();
+  }());
+  TEST_ASSERT_EQUAL(1, ids.find(cm::runtime::runtimeFieldHash("sensors", 7, "hum", 3)));
+  TEST_ASSERT_EQUAL(0, ids.find(cm::runtime::runtimeFieldHash("sensors", 7, "temp", 4)));
+  TEST_ASSERT_EQUAL(-1, ids.find(cm::runtime::runtimeFieldHash("sensors", 7, "dew", 3)));
+
+  JsonDocument values;
+  values["uptime"] = 5;
+  values["sensors"]["temp"] = 21.5;
+  values["sensors"]["extra"] = "n/a";
+  values["relays"]["pump"] = true;
+  JsonDocument compact;
+  cm::runtime::writeCompactValues(values.as<JsonObjectConst>(), ids, compact.to<JsonObject>());
+  String out;
+  serializeJson(compact, out);
+  const String expected = String("{\"ids\":") + ids.tableHash() + ",\"f\":[0,21.5,2,true],\"x\":{\"uptime\":5,\"sensors\":{\"extra\":\"n/a\"}}}";
+  TEST_ASSERT_EQUAL_STRING(expected.c_str(), out.c_str());
+
+  // runtime_meta.json publishes the IDs, compact frames use them.
+  ConfigManagerRuntime rt;
+  rt.addRuntimeProvider("sensors", [](JsonObject& o) { o["temp"] = 20; });
+  RuntimeFieldMeta temp;
+  temp.group = "sensors";
+  temp.key = "temp";
+  temp.label = "Temperature";
+  rt.addRuntimeMeta(temp);
+  TEST_ASSERT_NOT_EQUAL(-1, rt.runtimeMetaToJSON().indexOf("\"id\":0"));
+  TEST_ASSERT_EQUAL_UINT32(1, rt.getRuntimeFieldIds()->size());
+
+  String compactJson;
+  RuntimeFrameTargets targets;
+  targets.compactJson = &compactJson;
+  TEST_ASSERT_TRUE(rt.runtimeFrame(false, true, targets));
+  TEST_ASSERT_NOT_EQUAL(-1, compactJson.indexOf("\"type\":\"runtimeCompact\""));
+  TEST_ASSERT_NOT_EQUAL(-1, compactJson.indexOf("\"f\":[0,20]"));
+}
+
+void test_runtime_provider_refresh_interval() {
+  ConfigManagerRuntime rt;
+  int slowFills = 0;
+  int fastFills = 0;
+  rt.addRuntimeProvider("slow", [&slowFills](JsonObject& o) {
+    ++slowFills;
+    o["fills"] = slowFills;
+    o["ip"] = "192.168.0.10";
+  }, 100, 60000);
+  rt.addRuntimeProvider("fast", [&fastFills](JsonObject& o) { o["fills"] = ++fastFills; });
+  rt.registerRuntimeCheckbox("slow", "enabled", []() { return true; }, [](bool) {});
+
+  JsonDocument doc;
+  for (int i = 0; i < 3; ++i) {
+    TEST_ASSERT_TRUE(deserializeJson(doc, rt.runtimeValuesToJSON()) == DeserializationError::Ok);
+    // Cached values are spliced in next to the live control values.
+    TEST_ASSERT_EQUAL_INT(1, doc["slow"]["fills"].as<int>());
+    TEST_ASSERT_EQUAL_STRING("192.168.0.10", doc["slow"]["ip"]);
+    TEST_ASSERT_TRUE(doc["slow"]["enabled"].as<bool>());
+  }
+  TEST_ASSERT_EQUAL_INT(1, slowFills);
+  TEST_ASSERT_EQUAL_INT(3, fastFills);
+
+  TEST_ASSERT_TRUE(rt.markRuntimeProviderDirty("slow"));
+  TEST_ASSERT_FALSE(rt.markRuntimeProviderDirty("missing"));
+  TEST_ASSERT_TRUE(deserializeJson(doc, rt.runtimeValuesToJSON()) == DeserializationError::Ok);
+  TEST_ASSERT_EQUAL_INT(2, doc["slow"]["fills"].as<int>());
+
+  const std::vector<RuntimeProviderStats> stats = rt.getRuntimeProviderStats();
+  TEST_ASSERT_EQUAL_UINT32(2, stats.size());
+  TEST_ASSERT_EQUAL_STRING("slow", stats[0].name.c_str());
+  TEST_ASSERT_EQUAL_UINT32(60000, stats[0].refreshIntervalMs);
+  TEST_ASSERT_EQUAL_UINT32(2, stats[0].hits);
+  TEST_ASSERT_EQUAL_UINT32(2, stats[0].misses);
+  TEST_ASSERT_EQUAL_UINT32(0, stats[1].hits);
+  TEST_ASSERT_EQUAL_UINT32(4, stats[1].misses);
+
+  rt.resetRuntimeProviderStats();
+  TEST_ASSERT_EQUAL_UINT32(0, rt.getRuntimeProviderStats()[0].misses);
+}
+
+void test_runtime_frame_arena() {
+  cm::runtime::RuntimeFrameArena arena;
+  TEST_ASSERT_TRUE(arena.reserve(4096));
+  size_t firstHighWater = 0;
+  for (int round = 0; round < 3; ++round) {
+    JsonDocument doc(&arena);
+    for (int i = 0; i < 8; ++i) {
+      doc[String("group_") + i]["value"] = String("reading ") + i;
+    }
+    String out;
+    serializeJson(doc, out);
+    TEST_ASSERT_NOT_EQUAL(-1, out.indexOf("\"group_7\":{\"value\":\"reading 7\"}"));
+    if (round == 0) {
+      firstHighWater = arena.highWaterBytes();
+    }
+  }
+  // The arena rewinds after each document, so identical frames reuse the same bytes.
+  TEST_ASSERT_TRUE(firstHighWater > 0);
+  TEST_ASSERT_EQUAL_UINT32(firstHighWater, arena.highWaterBytes());
+  TEST_ASSERT_EQUAL_UINT32(0, arena.overflows());
+
+  {
+    JsonDocument big(&arena);
+    for (int i = 0; i < 64; ++i) {
+      big[String("field_with_a_long_name_") + i] = String("value that does not fit ") + i;
+    }
+    TEST_ASSERT_TRUE(arena.overflows() > 0);
+    TEST_ASSERT_EQUAL_STRING("value that does not fit 63", big["field_with_a_long_name_63"]);
+  }
+
+  cm::runtime::RuntimeFrameArenaPool pool(1024);
+  {
+    cm::runtime::RuntimeFrameArenaPool::Lease a = pool.acquire();
+    cm::runtime::RuntimeFrameArenaPool::Lease b = pool.acquire();
+    cm::runtime::RuntimeFrameArenaPool::Lease c = pool.acquire();
+    TEST_ASSERT_TRUE(a.allocator() != b.allocator());
+    TEST_ASSERT_EQUAL_UINT32(1, pool.stats().busyFallbacks);
+  }
+  TEST_ASSERT_EQUAL_UINT32(2, pool.stats().leases);
+}
+
+void test_runtime_frame_shared_target() {
+  ConfigManagerRuntime rt;
+  rt.addRuntimeProvider("sensors", [](JsonObject& o) {
+    o["temp"] = 21.5f;
+    o["label"] = "ok";
+  });
+  RuntimeFieldMeta meta;
+  meta.group = "sensors";
+  meta.key = "temp";
+  meta.label = "Temperature";
+  rt.addRuntimeMeta(meta);
+  rt.runtimeMetaJsonPayload();
+
+  for (RuntimeFrameEncoding encoding : {RuntimeFrameEncoding::Json, RuntimeFrameEncoding::MsgPack, RuntimeFrameEncoding::CompactJson, RuntimeFrameEncoding::CompactMsgPack}) {
+    String json;
+    String compactJson;
+    std::vector<uint8_t> msgpack;
+    std::vector<uint8_t> compactMsgpack;
+    std::vector<uint8_t> shared;
+    RuntimeFrameTargets targets;
+    targets.json = &json;
+    targets.msgpack = &msgpack;
+    targets.compactJson = &compactJson;
+    targets.compactMsgpack = &compactMsgpack;
+    targets.sharedEncoding = encoding;
+    targets.reserveShared = [&shared](size_t size) {
+      shared.assign(size, 0);
+      return shared.data();
+    };
+    TEST_ASSERT_TRUE(rt.runtimeFrame(false, true, targets));
+
+    // The shared buffer holds exactly the bytes of the matching per-encoding payload.
+    switch (encoding) {
+      case RuntimeFrameEncoding::Json:
+        TEST_ASSERT_EQUAL_STRING(json.c_str(), String(reinterpret_cast<const char*>(shared.data()), shared.size()).c_str());
+        break;
+      case RuntimeFrameEncoding::CompactJson:
+        TEST_ASSERT_EQUAL_STRING(compactJson.c_str(), String(reinterpret_cast<const char*>(shared.data()), shared.size()).c_str());
+        break;
+      case RuntimeFrameEncoding::MsgPack:
+        TEST_ASSERT_TRUE(shared == msgpack);
+        break;
+      case RuntimeFrameEncoding::CompactMsgPack:
+        TEST_ASSERT_TRUE(shared == compactMsgpack);
+        break;
+    }
+  }
+  TEST_ASSERT_TRUE(rt.getFrameArenaStats().leases >= 4);
+}
+
+void test_runtime_history_buckets() {
+  const uint16_t capacities[cm::runtime::RuntimeHistory::RESOLUTIONS] = {4, 3, 2};
+  cm::runtime::RuntimeHistory history(2, capacities);
+  TEST_ASSERT_EQUAL_UINT32(2 * 9 * sizeof(cm::runtime::RuntimeHistoryBucket), history.memoryBytes());
+
+  float value = 1.0f;
+  TEST_ASSERT_TRUE(history.addField("sensors", "temp", 0.1f, [&value]() { return value; }));
+  TEST_ASSERT_FALSE(history.addField("sensors", "temp", 0.1f, [&value]() { return value; }));
+  TEST_ASSERT_TRUE(history.addField("sensors", "hum", 1.0f, []() { return 1.0e6f; }));
+  TEST_ASSERT_FALSE(history.addField("sensors", "extra", 1.0f, []() { return 0.0f; }));
+
+  history.sample(0);
+  value = 2.0f;
+  history.sample(500); // Same second: ignored
+  history.sample(1000);
+  value = 3.0f;
+  history.sample(2000);
+  value = 4.0f;
+  history.sample(5000); // Seconds 3 and 4 were never sampled
+
+  // Four closed 1 s buckets (second 0 fell out of the ring) plus the open one.
+  cm::runtime::RuntimeHistorySeries series;
+  TEST_ASSERT_TRUE(history.read("sensors", "temp", 0, series));
+  TEST_ASSERT_EQUAL_FLOAT(0.1f, series.scale);
+  TEST_ASSERT_EQUAL_UINT32(1000, series.intervalMs);
+  TEST_ASSERT_EQUAL_UINT32(1000, series.startMs);
+  TEST_ASSERT_EQUAL_UINT32(5, series.buckets.size());
+  TEST_ASSERT_EQUAL_INT16(20, series.buckets[0].avg);
+  TEST_ASSERT_EQUAL_INT16(30, series.buckets[1].avg);
+  TEST_ASSERT_EQUAL_INT16(cm::runtime::RuntimeHistory::GAP, series.buckets[2].min);
+  TEST_ASSERT_EQUAL_INT16(cm::runtime::RuntimeHistory::GAP, series.buckets[3].min);
+  TEST_ASSERT_EQUAL_INT16(40, series.buckets[4].max);
+
+  // The JSON stream resumes mid-fragment, so tiny chunks produce the same document.
+  String whole;
+  String pieces;
+  uint8_t buffer[512];
+  cm::web::RuntimeHistoryJsonStream big("sensors.temp", "1s", series);
+  for (size_t n; (n = big.read(buffer, sizeof(buffer))) > 0;) {
+    whole.concat(reinterpret_cast<const char*>(buffer), n);
+  }
+  cm::web::RuntimeHistoryJsonStream small("sensors.temp", "1s", series);
+  for (size_t n; (n = small.read(buffer, 5)) > 0;) {
+    pieces.concat(reinterpret_cast<const char*>(buffer), n);
+  }
+  TEST_ASSERT_EQUAL_STRING("{\"field\":\"sensors.temp\",\"res\":\"1s\",\"intervalMs\":1000,\"startMs\":1000,\"scale\":0.1,"
+                           "\"buckets\":[[20,20,20],[30,30,30],null,null,[40,40,40]]}",
+                           whole.c_str());
+  TEST_ASSERT_EQUAL_STRING(whole.c_str(), pieces.c_str());
+
+  TEST_ASSERT_TRUE(history.read("", "temp", 1, series));
+  TEST_ASSERT_EQUAL_UINT32(1, series.buckets.size());
+  TEST_ASSERT_EQUAL_INT16(10, series.buckets[0].min);
+  TEST_ASSERT_EQUAL_INT16(25, series.buckets[0].avg);
+  TEST_ASSERT_EQUAL_INT16(40, series.buckets[0].max);
+
+  value = NAN;
+  history.sample(60000);
+  TEST_ASSERT_TRUE(history.read("sensors", "temp", 1, series));
+  TEST_ASSERT_EQUAL_UINT32(2, series.buckets.size());
+  TEST_ASSERT_EQUAL_INT16(25, series.buckets[0].avg);
+  TEST_ASSERT_EQUAL_INT16(cm::runtime::RuntimeHistory::GAP, series.buckets[1].min); // NaN is not a sample
+
+  TEST_ASSERT_TRUE(history.read("sensors", "hum", 2, series));
+  TEST_ASSERT_EQUAL_INT16(INT16_MAX, series.buckets[0].max); // Clamped to the int16 range
+  TEST_ASSERT_FALSE(history.read("sensors", "missing", 0, series));
+  TEST_ASSERT_EQUAL_INT(2, cm::runtime::RuntimeHistory::resolutionIndex("15m"));
+  TEST_ASSERT_EQUAL_INT(-1, cm::runtime::RuntimeHistory::resolutionIndex("5m"));
+}
+
+void test_ws_client_queued_bytes_estimate() {
+  ConfigManagerClass::WsClientInfo client{7, 0};
+  TEST_ASSERT_EQUAL_UINT32(0, client.queuedBytes(2));
+  client.recordFrame(100);
+  client.recordFrame(200);
+  client.recordFrame(300);
+  TEST_ASSERT_EQUAL_UINT32(300, client.queuedBytes(1));
+  TEST_ASSERT_EQUAL_UINT32(500, client.queuedBytes(2));
+  TEST_ASSERT_EQUAL_UINT32(600, client.queuedBytes(8)); // Only the last frames are known
+  for (uint32_t i = 0; i < 5; ++i) {
+    client.recordFrame(10);
+  }
+  TEST_ASSERT_EQUAL_UINT32(40, client.queuedBytes(8));
+}
+
+static int commandSliderValue = 0;
+
+static cm::web::RuntimeCommandQueue::PushResult pushCommand(cm::web::RuntimeCommandQueue& queue, uint32_t clientId, const char* message) {
+  cm::web::RuntimeCommand command;
+  TEST_ASSERT_TRUE_MESSAGE(cm::web::RuntimeCommandQueue::parse(reinterpret_cast<const uint8_t*>(message), strlen(message), command), message);
+  command.clientId = clientId;
+  return queue.push(std::move(command));
+}
+
+void test_ws_command_queue_coalescing() {
+  using PushResult = cm::web::RuntimeCommandQueue::PushResult;
+  testManager.getRuntimeManager().registerRuntimeIntSlider("wsCmd", "level", []() { return commandSliderValue; }, [](int v) { commandSliderValue = v; }, 0, 100);
+
+  cm::web::RuntimeCommandQueue queue(4);
+  TEST_ASSERT_EQUAL(PushResult::Queued, pushCommand(queue, 1, "[1,\"is\",\"wsCmd\",\"level\",10]"));
+  TEST_ASSERT_EQUAL(PushResult::Queued, pushCommand(queue, 1, "[2,\"b\",\"wsCmd\",\"go\"]"));
+  TEST_ASSERT_EQUAL(PushResult::Coalesced, pushCommand(queue, 1, "[3,\"is\",\"wsCmd\",\"level\",20]"));
+  TEST_ASSERT_EQUAL(PushResult::Queued, pushCommand(queue, 1, "[4,\"b\",\"wsCmd\",\"go\"]")); // Presses are never merged
+  TEST_ASSERT_EQUAL(PushResult::Coalesced, pushCommand(queue, 1, "[5,\"is\",\"wsCmd\",\"level\",30]"));
+  TEST_ASSERT_EQUAL(PushResult::Queued, pushCommand(queue, 2, "[1,\"is\",\"wsCmd\",\"level\",40]")); // Other client
+  TEST_ASSERT_EQUAL(PushResult::Full, pushCommand(queue, 1, "[6,\"sb\",\"wsCmd\",\"power\"]"));
+  TEST_ASSERT_EQUAL(PushResult::Coalesced, pushCommand(queue, 1, "[7,\"is\",\"wsCmd\",\"level\",50]")); // Still fits
+  TEST_ASSERT_EQUAL_UINT32(4, queue.size());
+
+  cm::web::RuntimeCommand invalid;
+  const char* unknownKind = "[9,\"xx\",\"wsCmd\",\"level\",1]";
+  TEST_ASSERT_FALSE(cm::web::RuntimeCommandQueue::parse(reinterpret_cast<const uint8_t*>(unknownKind), strlen(unknownKind), invalid));
+  TEST_ASSERT_EQUAL_UINT32(9, invalid.seq); // Still acknowledged, with ok:false
+  const char* missingValue = "[10,\"is\",\"wsCmd\",\"level\"]";
+  TEST_ASSERT_FALSE(cm::web::RuntimeCommandQueue::parse(reinterpret_cast<const uint8_t*>(missingValue), strlen(missingValue), invalid));
+  const char* buttonValue = "[11,\"b\",\"wsCmd\",\"go\",1]";
+  TEST_ASSERT_FALSE(cm::web::RuntimeCommandQueue::parse(reinterpret_cast<const uint8_t*>(buttonValue), strlen(buttonValue), invalid));
+
+  std::vector<cm::web::RuntimeCommand> batch;
+  queue.drain(batch);
+  TEST_ASSERT_EQUAL_UINT32(0, queue.size());
+  TEST_ASSERT_EQUAL_UINT32(4, batch.size());
+  TEST_ASSERT_EQUAL_UINT32(7, batch[0].seq); // Keeps the slot of the first update
+  TEST_ASSERT_EQUAL_INT(50, batch[0].intValue);
+  TEST_ASSERT_EQUAL_UINT32(2, batch[1].seq);
+  TEST_ASSERT_EQUAL_UINT32(4, batch[2].seq);
+  TEST_ASSERT_EQUAL_UINT32(2, batch[3].clientId);
+  TEST_ASSERT_EQUAL_STRING("is", cm::web::RuntimeCommandQueue::kindName(batch[0].kind));
+
+  const cm::web::RuntimeCommand& slider = batch[0];
+  TEST_ASSERT_TRUE(cm::web::dispatchRuntimeAction(&testManager, slider.kind, slider.group, slider.key, slider.hasValue, slider.boolValue, slider.intValue, slider.floatValue));
+  TEST_ASSERT_EQUAL_INT(50, commandSliderValue);
+}
+
+struct MailboxRecord {
+  uint32_t seq = 0;
+  uint32_t check = 0;
+  String text;
+};
+
+void test_spsc_mailbox_two_tasks() {
+  cm::runtime::SpscMailbox<MailboxRecord> mailbox(6);
+  TEST_ASSERT_EQUAL_UINT32(8, mailbox.capacity());
+
+  // Producer and consumer on separate threads: every record arrives once, in order and whole.
+  constexpr uint32_t COUNT = 20000;
+  std::thread producer([&mailbox]() {
+    for (uint32_t i = 0; i < COUNT;) {
+      MailboxRecord record;
+      record.seq = i;
+      record.check = ~i;
+      record.text = String(i);
+      if (mailbox.push(std::move(record))) {
+        ++i;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+  uint32_t expected = 0;
+  uint32_t torn = 0;
+  MailboxRecord record;
+  while (expected < COUNT) {
+    if (!mailbox.pop(record)) {
+      std::this_thread::yield();
+      continue;
+    }
+    if (record.seq != expected || record.check != ~expected || record.text != String(expected)) {
+      ++torn;
+    }
+    ++expected;
+  }
+  producer.join();
+  TEST_ASSERT_EQUAL_UINT32(0, torn);
+  TEST_ASSERT_EQUAL_UINT32(0, mailbox.size());
+
+  for (uint32_t i = 0; i < mailbox.capacity(); ++i) {
+    TEST_ASSERT_TRUE(mailbox.push(MailboxRecord{}));
+  }
+  TEST_ASSERT_FALSE(mailbox.push(MailboxRecord{}));
+}
+
+void test_loop_mailbox_applies_on_loop() {
+  ConfigManagerClass manager;
+  Config<int>* level = new Config<int>(ConfigOptions<int>{.key = "mbLevel", .name = "Level", .category = "mb", .defaultValue = 1});
+  manager.addSetting(std::unique_ptr<BaseSetting>(level));
+
+  // Validated when posted, applied only when the loop drains the mailbox.
+  TEST_ASSERT_FALSE(manager.postSettingToLoop("mb", level->getKey(), "abc", false));
+  TEST_ASSERT_FALSE(manager.postSettingToLoop("mb", "missing", "1", false));
+  TEST_ASSERT_TRUE(manager.postSettingToLoop("mb", level->getKey(), "77", false));
+  TEST_ASSERT_EQUAL(1, level->get());
+
+  manager.getRuntimeManager().registerRuntimeIntSlider("mb", "slider", []() { return commandSliderValue; }, [](int v) { commandSliderValue = v; }, 0, 100);
+  for (int value : {5, 6, 7}) {
+    ConfigManagerClass::LoopMutation mutation;
+    mutation.kind = ConfigManagerClass::LoopMutation::Kind::RuntimeAction;
+    mutation.action.kind = cm::web::RuntimeActionKind::IntSlider;
+    mutation.action.group = "mb";
+    mutation.action.key = "slider";
+    mutation.action.hasValue = true;
+    mutation.action.intValue = value;
+    TEST_ASSERT_TRUE(manager.postToLoop(std::move(mutation)));
+  }
+
+  manager.handleLoopMailbox();
+  TEST_ASSERT_EQUAL(77, level->get());
+  TEST_ASSERT_EQUAL_INT(7, commandSliderValue); // Merged: only the latest value ran
+
+  const ConfigManagerClass::LoopMailboxStats stats = manager.getLoopMailboxStats();
+  TEST_ASSERT_EQUAL_UINT32(4, stats.posted);
+  TEST_ASSERT_EQUAL_UINT32(4, stats.applied);
+  TEST_ASSERT_EQUAL_UINT32(4, stats.maxBatch);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.full);
+}
+
+void test_http_admission_classes() {
+  using Decision = cm::web::AdmissionController::Decision;
+  using cm::web::RequestClass;
+  cm::web::AdmissionController admission;
+  cm::web::AdmissionLimits bulk;
+  bulk.maxActive = 2;
+  bulk.minFreeHeap = 30000;
+  bulk.minLargestBlock = 8000;
+  admission.setLimits(RequestClass::Bulk, bulk);
+  cm::web::AdmissionLimits critical;
+  critical.maxActive = 1;
+  admission.setLimits(RequestClass::Critical, critical);
+
+  TEST_ASSERT_EQUAL(Decision::Admitted, admission.tryAcquire(RequestClass::Bulk, 60000, 20000));
+  TEST_ASSERT_EQUAL(Decision::Admitted, admission.tryAcquire(RequestClass::Bulk, 60000, 20000));
+  TEST_ASSERT_EQUAL(Decision::Busy, admission.tryAcquire(RequestClass::Bulk, 60000, 20000));
+  admission.release(RequestClass::Bulk);
+  // Heap floors: total free heap and the largest block are checked separately.
+  TEST_ASSERT_EQUAL(Decision::LowHeap, admission.tryAcquire(RequestClass::Bulk, 20000, 20000));
+  TEST_ASSERT_EQUAL(Decision::LowHeap, admission.tryAcquire(RequestClass::Bulk, 60000, 4000));
+  // Critical requests only need a slot, and other classes do not take it.
+  TEST_ASSERT_EQUAL(Decision::Admitted, admission.tryAcquire(RequestClass::Critical, 1000, 500));
+  TEST_ASSERT_EQUAL(Decision::Busy, admission.tryAcquire(RequestClass::Critical, 1000, 500));
+
+  const cm::web::AdmissionClassStats stats = admission.stats(RequestClass::Bulk);
+  TEST_ASSERT_EQUAL_STRING("bulk", stats.name);
+  TEST_ASSERT_EQUAL_UINT32(1, stats.active);
+  TEST_ASSERT_EQUAL_UINT32(2, stats.peakActive);
+  TEST_ASSERT_EQUAL_UINT32(2, stats.admitted);
+  TEST_ASSERT_EQUAL_UINT32(1, stats.rejectedBusy);
+  TEST_ASSERT_EQUAL_UINT32(2, stats.rejectedHeap);
+
+  admission.release(RequestClass::Bulk);
+  admission.release(RequestClass::Bulk); // Extra releases never underflow
+  admission.resetStats();
+  TEST_ASSERT_EQUAL_UINT32(0, admission.stats(RequestClass::Bulk).active);
+  TEST_ASSERT_EQUAL_UINT32(0, admission.stats(RequestClass::Bulk).admitted);
+  TEST_ASSERT_EQUAL_UINT32(1, admission.stats(RequestClass::Critical).peakActive);
+}
+
+void test_webui_cache_validators() {
+#if CM_EMBED_WEBUI
+  // Generated with the bundle by tools/webui_to_header.js; used as the ETag of /.
+  WebHTML webhtml;
+  const char* hash = webhtml.getWebHTMLGzHash();
+  TEST_ASSERT_EQUAL_UINT32(16, strlen(hash));
+  for (const char* c = hash; *c; ++c) {
+    TEST_ASSERT_TRUE(isxdigit(static_cast<unsigned char>(*c)));
+  }
+#endif
+  ConfigManagerClass manager;
+  const uint32_t revision = manager.getCustomCssRevision();
+  manager.setCustomCss("body{}", 6);
+  TEST_ASSERT_EQUAL_UINT32(revision + 1, manager.getCustomCssRevision());
+}
+
+void test_etag_list_matches() {
+  using cm::web::etagListMatches;
+  const char* etag = "\"0123456789abcdef\"";
+  TEST_ASSERT_TRUE(etagListMatches("\"0123456789abcdef\"", etag));
+  TEST_ASSERT_TRUE(etagListMatches("W/\"0123456789abcdef\"", etag));
+  TEST_ASSERT_TRUE(etagListMatches("\"old\", \"0123456789abcdef\"", etag));
+  TEST_ASSERT_TRUE(etagListMatches("\"old\",W/\"0123456789abcdef\" , \"other\"", etag));
+  TEST_ASSERT_TRUE(etagListMatches("*", etag));
+  TEST_ASSERT_TRUE(etagListMatches(" * ", etag));
+  TEST_ASSERT_FALSE(etagListMatches("", etag));
+  TEST_ASSERT_FALSE(etagListMatches("\"old\", \"other\"", etag));
+  // A tag that only contains ours, or a prefix of it, is a different tag.
+  TEST_ASSERT_FALSE(etagListMatches("\"x0123456789abcdef\"", etag));
+  TEST_ASSERT_FALSE(etagListMatches("\"0123456789abcdef\"x", etag));
+  TEST_ASSERT_FALSE(etagListMatches("\"0123456789abcde\"", etag));
+  TEST_ASSERT_FALSE(etagListMatches("\"*\"", etag));
+  TEST_ASSERT_FALSE(etagListMatches(nullptr, etag));
+}
+
+void test_loop_profiler_histogram() {
+  cm::runtime::LoopProfiler profiler;
+  for (int i = 0; i < 98; ++i) {
+    profiler.record(cm::runtime::LoopSection::MQTT, 10);
+  }
+  profiler.record(cm::runtime::LoopSection::MQTT, 1000);
+  profiler.record(cm::runtime::LoopSection::MQTT, 5000);
+
+  cm::runtime::LoopSectionStats mqtt = profiler.stats(cm::runtime::LoopSection::MQTT);
+  TEST_ASSERT_EQUAL_STRING("mqtt", mqtt.name);
+  TEST_ASSERT_EQUAL_UINT32(100, mqtt.count);
+  TEST_ASSERT_EQUAL_UINT32(15, mqtt.p50Us);   // [8, 16) us
+  TEST_ASSERT_EQUAL_UINT32(1023, mqtt.p99Us); // [512, 1024) us
+  TEST_ASSERT_EQUAL_UINT32(5000, mqtt.maxUs);
+
+  // The loop section measures the time between marks.
+  profiler.markLoop(1000000);
+  profiler.markLoop(1000300);
+  const cm::runtime::LoopSectionStats loop = profiler.stats(cm::runtime::LoopSection::Loop);
+  TEST_ASSERT_EQUAL_UINT32(1, loop.count);
+  TEST_ASSERT_EQUAL_UINT32(300, loop.p99Us); // Capped at the maximum
+  TEST_ASSERT_EQUAL_UINT32(300, loop.maxUs);
+
+  JsonDocument doc;
+  profiler.toJSON(doc.to<JsonObject>(), true);
+  TEST_ASSERT_EQUAL_UINT32(2, doc.as<JsonObject>().size()); // Sections without samples are left out
+  TEST_ASSERT_EQUAL_UINT32(1023, doc["mqtt"]["p99Us"].as<uint32_t>());
+  TEST_ASSERT_EQUAL_UINT32(14, doc["mqtt"]["buckets"].size()); // Up to [4096, 8192) us
+  TEST_ASSERT_EQUAL_UINT32(98, doc["mqtt"]["buckets"][4].as<uint32_t>());
+
+  profiler.reset();
+  mqtt = profiler.stats(cm::runtime::LoopSection::MQTT);
+  TEST_ASSERT_EQUAL_UINT32(0, mqtt.count);
+  TEST_ASSERT_EQUAL_UINT32(0, mqtt.maxUs);
+
+#if CM_ENABLE_LOOP_PROFILER
+  const uint32_t before = cm::runtime::LoopProfiler::instance().stats(cm::runtime::LoopSection::IO).count;
+  {
+    CM_LOOP_SCOPE(IO);
+    delayMicroseconds(200);
+  }
+  const cm::runtime::LoopSectionStats io = cm::runtime::LoopProfiler::instance().stats(cm::runtime::LoopSection::IO);
+  TEST_ASSERT_EQUAL_UINT32(before + 1, io.count);
+  TEST_ASSERT_TRUE(io.maxUs >= 200);
+#endif
+}
+
+void test_setting_index_lookup() {
+  TEST_ASSERT_EQUAL_PTR(&testInt, testManager.findSetting(String("cfg"), String(testInt.getKey())));
+  TEST_ASSERT_EQUAL_PTR(&testPassword, testManager.findSetting("auth", testPassword.getKey()));
+  TEST_ASSERT_EQUAL_PTR(&testFloat, testManager.findSettingByKeyHint("cfg", "tFlt"));
+  TEST_ASSERT_EQUAL_PTR(&autoKey, testManager.findSetting("verylongcategoryname", autoKey.getKey()));
+  // Category is part of the index key; a matching key in another category must miss.
+  TEST_ASSERT_NULL(testManager.findSetting("auth", testInt.getKey()));
+  TEST_ASSERT_NULL(testManager.findSettingByKeyHint("cfg", "missing"));
+  TEST_ASSERT_NULL(testManager.findSettingByKeyHint("cfg", ""));
+}
+
+void test_persist_write_behind_coalescing() {
+  testManager.flush();
+  testManager.resetPersistStats();
+  testManager.setPersistQuietPeriod(60000);
+
+  // 20 saves of one value inside the quiet period collapse into one queued write.
+  for (int i = 0; i < 20; ++i) {
+    TEST_ASSERT_TRUE(testManager.updateSetting("cfg", testInt.getKey(), String(100 + i)));
+  }
+  TEST_ASSERT_TRUE(testManager.updateSetting("cfg", testString.getKey(), "queued"));
+  TEST_ASSERT_TRUE(testManager.hasPendingWrites());
+  TEST_ASSERT_EQUAL_UINT32(21, testManager.getPersistStats().requested);
+  TEST_ASSERT_EQUAL_UINT32(19, testManager.getPersistStats().coalesced);
+  TEST_ASSERT_EQUAL_UINT32(0, testManager.getPersistStats().sessions);
+
+  // Still inside the quiet period: the loop must not commit yet.
+  testManager.handleClient();
+  TEST_ASSERT_EQUAL_UINT32(0, testManager.getPersistStats().sessions);
+
+  TEST_ASSERT_TRUE(testManager.flush());
+  TEST_ASSERT_FALSE(testManager.hasPendingWrites());
+  TEST_ASSERT_EQUAL_UINT32(1, testManager.getPersistStats().sessions);
+  TEST_ASSERT_EQUAL_UINT32(2, testManager.getPersistStats().written);
+
+  testInt.set(0);
+  testString.set("reset");
+  testManager.loadAll();
+  TEST_ASSERT_EQUAL(119, testInt.get());
+  TEST_ASSERT_EQUAL_STRING("queued", testString.get().c_str());
+
+  // Quiet period 0 keeps the immediate, one-session-per-save behavior.
+  testManager.setPersistQuietPeriod(0);
+  TEST_ASSERT_TRUE(testManager.updateSetting("cfg", testInt.getKey(), "1337"));
+  TEST_ASSERT_FALSE(testManager.hasPendingWrites());
+  TEST_ASSERT_EQUAL_UINT32(2, testManager.getPersistStats().sessions);
+}
+
+void test_settings_blob_roundtrip_and_migration() {
+  using Mode = ConfigManagerClass::SettingsStorageMode;
+  testManager.setPersistQuietPeriod(0);
+  testInt.set(4242);
+  testString.set("per-key");
+  testManager.saveAll();
+
+  // Switching modes migrates the per-key values into the snapshot.
+  testManager.setSettingsStorageMode(Mode::Blob);
+  testInt.set(0);
+  testString.set("reset");
+  testManager.loadAll();
+  TEST_ASSERT_EQUAL(4242, testInt.get());
+  TEST_ASSERT_EQUAL_STRING("per-key", testString.get().c_str());
+
+  Preferences raw;
+  TEST_ASSERT_TRUE(raw.begin("ConfigManager", false));
+  TEST_ASSERT_TRUE(raw.getBytesLength(cm::storage::BLOB_PREFS_KEY) > cm::storage::BLOB_HEADER_SIZE);
+  raw.end();
+
+  testFloat.set(1.5f);
+  testString.set("from blob");
+  testManager.saveAll();
+  testFloat.set(0.0f);
+  testString.set("reset");
+  testManager.loadAll();
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, 1.5f, testFloat.get());
+  TEST_ASSERT_EQUAL_STRING("from blob", testString.get().c_str());
+
+  // A corrupt snapshot falls back to the per-key values and is rewritten.
+  TEST_ASSERT_TRUE(raw.begin("ConfigManager", false));
+  const uint8_t junk[cm::storage::BLOB_HEADER_SIZE + 4] = {0x43, 0x4D};
+  raw.putBytes(cm::storage::BLOB_PREFS_KEY, junk, sizeof(junk));
+  raw.end();
+  testManager.loadAll();
+  TEST_ASSERT_EQUAL(4242, testInt.get());
+  TEST_ASSERT_EQUAL_STRING("per-key", testString.get().c_str());
+
+  testManager.setSettingsStorageMode(Mode::PerKey);
+  TEST_ASSERT_TRUE(raw.begin("ConfigManager", false));
+  raw.remove(cm::storage::BLOB_PREFS_KEY);
+  raw.end();
+}
+
+constexpr size_t CONFIG_STREAM_CATEGORY_COUNT = 24;
+char configStreamCategories[CONFIG_STREAM_CATEGORY_COUNT][12];
+
+void test_config_json_stream_categories_and_chunks() {
+  // More categories than the former fixed catNames[20] table.
+  ConfigManagerClass manager;
+  for (size_t i = 0; i < CONFIG_STREAM_CATEGORY_COUNT; ++i) {
+    snprintf(configStreamCategories[i], sizeof(configStreamCategories[i]), "cat%u", static_cast<unsigned>(i));
+    char hint[16];
+    snprintf(hint, sizeof(hint), "cs_%u", static_cast<unsigned>(i));
+    ConfigOptions<String> opts{.key = hint, .name = "Stream", .category = configStreamCategories[i], .defaultValue = "v\"q\n"};
+    opts.card = (i % 3 == 0) ? "main" : nullptr;
+    TEST_ASSERT_NOT_NULL(manager.addSetting(std::unique_ptr<BaseSetting>(new Config<String>(opts))));
+  }
+
+  const String json = manager.toJSON(true);
+  DynamicJsonDocument doc(16384);
+  TEST_ASSERT_FALSE(deserializeJson(doc, json));
+  TEST_ASSERT_EQUAL_UINT32(CONFIG_STREAM_CATEGORY_COUNT, doc.as<JsonObject>().size());
+  TEST_ASSERT_TRUE(doc["cat3"]["cards"]["main"]["settings"].is<JsonObject>());
+  TEST_ASSERT_EQUAL_STRING("v\"q\n", doc["cat23"].as<JsonObject>()[manager.getSettings().back()->getKey()]["value"].as<const char*>());
+
+  // Small chunks force fragments to resume mid-way; the bytes must match toJSON().
+  cm::web::ConfigJsonStream stream(manager.getSettings(), true);
+  String streamed;
+  uint8_t chunk[7];
+  size_t len = 0;
+  while ((len = stream.read(chunk, sizeof(chunk))) > 0) {
+    streamed.concat(reinterpret_cast<const char*>(chunk), len);
+  }
+  TEST_ASSERT_TRUE(stream.done());
+  TEST_ASSERT_EQUAL_STRING(json.c_str(), streamed.c_str());
+
+  // A value that changes between chunks must not tear the fragment being sent.
+  auto* last = static_cast<Config<String>*>(manager.getSettings().back());
+  cm::web::ConfigJsonStream live(manager.getSettings(), true);
+  String liveJson;
+  bool longValue = false;
+  while ((len = live.read(chunk, sizeof(chunk))) > 0) {
+    liveJson.concat(reinterpret_cast<const char*>(chunk), len);
+    longValue = !longValue;
+    last->set(longValue ? String("a considerably longer value") : String("x"));
+  }
+  TEST_ASSERT_FALSE(deserializeJson(doc, liveJson));
+  TEST_ASSERT_EQUAL_UINT32(CONFIG_STREAM_CATEGORY_COUNT, doc.as<JsonObject>().size());
+}
+
+void test_compile_time_storage_key() {
+  TEST_ASSERT_EQUAL_STRING(hashStringForStorage("tConst").c_str(), constKey.getKey());
+  TEST_ASSERT_EQUAL_STRING(hashStringForStorage(testKeyHints[0]).c_str(), testInt.getKey());
+  TEST_ASSERT_FALSE(constKey.hasError());
+  TEST_ASSERT_EQUAL_PTR(&constKey, testManager.findSettingByKeyHint("cfg", "tConst"));
+#ifndef NDEBUG
+  Config<int> mismatched(ConfigOptions<int>{.key = "tMismatch", .name = "Mismatch", .category = "cfg", .storageKey = CM_STORAGE_KEY("tOther")});
+  TEST_ASSERT_TRUE(mismatched.hasError());
+#endif
+}
+
+void test_config_descriptor_table() {
+  ConfigManagerClass manager;
+  TEST_ASSERT_NOT_NULL(manager.addSetting(&descInt));
+  TEST_ASSERT_NOT_NULL(manager.addSetting(&descSecret));
+
+  // Same storage key and fallbacks as a ConfigOptions setting with the same hint.
+  TEST_ASSERT_EQUAL_STRING(hashStringForStorage("tDescInt").c_str(), descInt.getKey());
+  TEST_ASSERT_EQUAL_STRING("Descriptor Int", descInt.getDisplayName());
+  TEST_ASSERT_EQUAL_STRING("tDescPwd", descSecret.getDisplayName());
+  TEST_ASSERT_EQUAL_STRING("desc", descInt.getCategoryPretty());
+  TEST_ASSERT_EQUAL(7, descInt.getSortOrder());
+  TEST_ASSERT_EQUAL_PTR(&descInt, manager.findSettingByKeyHint("desc", "tDescInt"));
+
+  manager.loadAll();
+  descInt.set(1);
+  descInt.setDefault();
+  TEST_ASSERT_EQUAL(1883, descInt.get());
+  TEST_ASSERT_EQUAL_STRING("broker", descSecret.getDefaultValue().c_str());
+
+  const String json = manager.toJSON(false);
+  TEST_ASSERT_TRUE(json.indexOf("***") >= 0);
+  TEST_ASSERT_TRUE(json.indexOf("1883") >= 0);
+
+  const SettingRamUsage table = descInt.getRamUsage();
+  const SettingRamUsage classic = testInt.getRamUsage();
+  TEST_ASSERT_TRUE(table.flashDescriptor);
+  TEST_ASSERT_FALSE(classic.flashDescriptor);
+  TEST_ASSERT_EQUAL_UINT32(0, table.heapBytes);
+  // ConfigOptions settings keep their metadata in the object, not on the heap.
+  TEST_ASSERT_EQUAL_UINT32(0, classic.heapBytes);
+
+  const ConfigManagerClass::SettingsRamReport report = manager.getSettingsRamReport();
+  TEST_ASSERT_EQUAL_UINT32(2, report.settings);
+  TEST_ASSERT_EQUAL_UINT32(2, report.flashDescriptors);
+}
+
+void test_setting_from_string_typed() {
+  // Values are parsed by the declared type: numeric-looking and empty text is valid for strings.
+  TEST_ASSERT_TRUE(testManager.applySetting("cfg", testString.getKey(), "123"));
+  TEST_ASSERT_EQUAL_STRING("123", testString.get().c_str());
+  TEST_ASSERT_TRUE(testManager.applySetting("cfg", testString.getKey(), ""));
+  TEST_ASSERT_EQUAL_STRING("", testString.get().c_str());
+
+  TEST_ASSERT_TRUE(testManager.applySetting("cfg", testInt.getKey(), "-17"));
+  TEST_ASSERT_EQUAL(-17, testInt.get());
+  TEST_ASSERT_FALSE(testManager.applySetting("cfg", testInt.getKey(), "3.5"));
+  TEST_ASSERT_FALSE(testManager.applySetting("cfg", testInt.getKey(), "99999999999"));
+  TEST_ASSERT_EQUAL(-17, testInt.get());
+
+  TEST_ASSERT_TRUE(testManager.applySetting("cfg", testFloat.getKey(), "7"));
+  TEST_ASSERT_EQUAL_FLOAT(7.0f, testFloat.get());
+  TEST_ASSERT_FALSE(testManager.applySetting("cfg", testFloat.getKey(), "abc"));
+
+  TEST_ASSERT_TRUE(testManager.applySetting("cfg", testBool.getKey(), "false"));
+  TEST_ASSERT_FALSE(testBool.get());
+  TEST_ASSERT_FALSE(testManager.applySetting("cfg", testBool.getKey(), "1"));
+
+  // Bulk endpoints hand over the parsed variant directly.
+  JsonDocument doc;
+  doc["i"] = 21;
+  doc["f"] = 0.25f;
+  doc["b"] = true;
+  doc["s"] = "bulk";
+  TEST_ASSERT_TRUE(testManager.applySettingValue("cfg", testInt.getKey(), doc["i"], false));
+  TEST_ASSERT_TRUE(testManager.applySettingValue("cfg", testFloat.getKey(), doc["f"], false));
+  TEST_ASSERT_TRUE(testManager.applySettingValue("cfg", testBool.getKey(), doc["b"], false));
+  TEST_ASSERT_TRUE(testManager.applySettingValue("cfg", testString.getKey(), doc["s"], false));
+  TEST_ASSERT_EQUAL(21, testInt.get());
+  TEST_ASSERT_EQUAL_FLOAT(0.25f, testFloat.get());
+  TEST_ASSERT_TRUE(testBool.get());
+  TEST_ASSERT_EQUAL_STRING("bulk", testString.get().c_str());
+  TEST_ASSERT_FALSE(testManager.applySettingValue("cfg", testBool.getKey(), doc["s"], false));
+}
+
+static int cfgChangeCalls = 0;
+static int optChangeCalls = 0;
+static int anyChangeCalls = 0;
+
+void test_settings_epoch_and_change_subscription() {
+  testManager.onAnyChange("cfg", []() { ++cfgChangeCalls; });
+  testManager.onAnyChange("opt", []() { ++optChangeCalls; });
+  testManager.onAnyChange(nullptr, []() { ++anyChangeCalls; });
+
+  // Writing the current value is not a change.
+  const uint32_t epochBefore = ConfigManagerClass::getSettingsEpoch();
+  const uint32_t generationBefore = testInt.getGeneration();
+  testInt.set(testInt.get());
+  TEST_ASSERT_EQUAL_UINT32(epochBefore, ConfigManagerClass::getSettingsEpoch());
+
+  testInt.set(testInt.get() + 1);
+  TEST_ASSERT_TRUE(ConfigManagerClass::getSettingsEpoch() != epochBefore);
+  TEST_ASSERT_TRUE(testInt.getGeneration() != generationBefore);
+  TEST_ASSERT_EQUAL_UINT32(ConfigManagerClass::getSettingsEpoch(), testInt.getGeneration());
+  TEST_ASSERT_TRUE(testManager.applySetting("cfg", testBool.getKey(), testBool.get() ? "false" : "true"));
+
+  // Two changes in "cfg" between loops coalesce into one callback; "opt" is untouched.
+  testManager.handleClient();
+  TEST_ASSERT_EQUAL(1, cfgChangeCalls);
+  TEST_ASSERT_EQUAL(0, optChangeCalls);
+  TEST_ASSERT_EQUAL(1, anyChangeCalls);
+
+  testManager.handleClient();
+  TEST_ASSERT_EQUAL(1, cfgChangeCalls);
+
+  featureEnable.set(!featureEnable.get());
+  testManager.handleClient();
+  TEST_ASSERT_EQUAL(1, cfgChangeCalls);
+  TEST_ASSERT_EQUAL(1, optChangeCalls);
+  TEST_ASSERT_EQUAL(2, anyChangeCalls);
+  featureEnable.set(false);
+}
+
+String streamConfigJson(const std::vector<BaseSetting*>& settings, uint32_t changedSince) {
+  cm::web::ConfigJsonStream stream(settings, true, changedSince);
+  String out;
+  uint8_t chunk[16];
+  size_t len = 0;
+  while ((len = stream.read(chunk, sizeof(chunk))) > 0) {
+    out.concat(reinterpret_cast<const char*>(chunk), len);
+  }
+  return out;
+}
+
+void test_config_json_delta_since_epoch() {
+  ConfigManagerClass manager;
+  Config<int>* plain = new Config<int>(ConfigOptions<int>{.key = "dPlain", .name = "Plain", .category = "deltaA", .defaultValue = 1});
+  Config<int>* carded = new Config<int>(ConfigOptions<int>{.key = "dCard", .name = "Card", .category = "deltaA", .defaultValue = 2, .card = "main"});
+  Config<int>* other = new Config<int>(ConfigOptions<int>{.key = "dOther", .name = "Other", .category = "deltaB", .defaultValue = 3});
+  Config<int>* dynamic = new Config<int>(ConfigOptions<int>{.key = "dShow", .name = "Show", .category = "deltaC", .defaultValue = 4, .showIf = []() { return true; }});
+  manager.addSetting(std::unique_ptr<BaseSetting>(plain));
+  manager.addSetting(std::unique_ptr<BaseSetting>(carded));
+  manager.addSetting(std::unique_ptr<BaseSetting>(other));
+  manager.addSetting(std::unique_ptr<BaseSetting>(dynamic));
+
+  // since = 0 is the full document.
+  TEST_ASSERT_EQUAL_STRING(manager.toJSON(true).c_str(), streamConfigJson(manager.getSettings(), 0).c_str());
+
+  const uint32_t since = ConfigManagerClass::getSettingsEpoch();
+  DynamicJsonDocument doc(4096);
+  TEST_ASSERT_FALSE(deserializeJson(doc, streamConfigJson(manager.getSettings(), since)));
+  // Nothing changed: only the showIf setting (its visibility depends on other settings).
+  TEST_ASSERT_EQUAL_UINT32(1, doc.as<JsonObject>().size());
+  TEST_ASSERT_TRUE(doc["deltaC"][dynamic->getKey()].is<JsonObject>());
+
+  carded->set(20);
+  doc.clear();
+  TEST_ASSERT_FALSE(deserializeJson(doc, streamConfigJson(manager.getSettings(), since)));
+  TEST_ASSERT_EQUAL_UINT32(2, doc.as<JsonObject>().size());
+  TEST_ASSERT_FALSE(doc["deltaB"].is<JsonObject>());
+  TEST_ASSERT_FALSE(doc["deltaA"][plain->getKey()].is<JsonObject>());
+  TEST_ASSERT_EQUAL(20, doc["deltaA"]["cards"]["main"]["settings"][carded->getKey()]["value"].as<int>());
+
+  // A revision taken after the change no longer includes it.
+  const uint32_t later = ConfigManagerClass::getSettingsEpoch();
+  doc.clear();
+  TEST_ASSERT_FALSE(deserializeJson(doc, streamConfigJson(manager.getSettings(), later)));
+  TEST_ASSERT_FALSE(doc["deltaA"].is<JsonObject>());
+}
+
+int txCallbackCalls = 0;
+int txPartnerSeen = 0;
+
+void test_transaction_all_or_nothing() {
+  ConfigManagerClass manager;
+  Config<int>* first = new Config<int>(ConfigOptions<int>{.key = "txFirst", .name = "First", .category = "tx", .defaultValue = 1});
+  Config<int>* second = new Config<int>(ConfigOptions<int>{.key = "txSecond", .name = "Second", .category = "tx", .defaultValue = 2});
+  Config<String>* text = new Config<String>(ConfigOptions<String>{.key = "txText", .name = "Text", .category = "tx", .defaultValue = "a"});
+  first->setCallback([second](int) {
+    ++txCallbackCalls;
+    txPartnerSeen = second->get();
+  });
+  manager.addSetting(std::unique_ptr<BaseSetting>(first));
+  manager.addSetting(std::unique_ptr<BaseSetting>(second));
+  manager.addSetting(std::unique_ptr<BaseSetting>(text));
+
+  // One invalid value rejects the whole batch; nothing is applied.
+  {
+    auto tx = manager.beginTransaction(false);
+    TEST_ASSERT_TRUE(tx.stage("tx", first->getKey(), "10"));
+    TEST_ASSERT_FALSE(tx.stage("tx", second->getKey(), "abc"));
+    TEST_ASSERT_FALSE(tx.stage("tx", "missing", "1"));
+    TEST_ASSERT_EQUAL_UINT32(2, tx.rejectedCount());
+    TEST_ASSERT_FALSE(tx.commit());
+  }
+  TEST_ASSERT_EQUAL(1, first->get());
+  TEST_ASSERT_EQUAL(0, txCallbackCalls);
+
+  // Staged values are applied on commit, and callbacks see the complete new state.
+  {
+    auto tx = manager.beginTransaction(false);
+    TEST_ASSERT_TRUE(tx.stage("tx", first->getKey(), "10"));
+    TEST_ASSERT_TRUE(tx.stage("tx", second->getKey(), "20"));
+    TEST_ASSERT_TRUE(tx.stage("tx", text->getKey(), "b"));
+    TEST_ASSERT_EQUAL(1, first->get());
+    TEST_ASSERT_TRUE(tx.commit());
+  }
+  TEST_ASSERT_EQUAL(10, first->get());
+  TEST_ASSERT_EQUAL(20, second->get());
+  TEST_ASSERT_EQUAL_STRING("b", text->get().c_str());
+  TEST_ASSERT_EQUAL(1, txCallbackCalls);
+  TEST_ASSERT_EQUAL(20, txPartnerSeen);
+
+  // rollback() and destruction without commit() discard the staged values.
+  {
+    auto tx = manager.beginTransaction(false);
+    TEST_ASSERT_TRUE(tx.stage("tx", first->getKey(), "99"));
+    tx.rollback();
+    TEST_ASSERT_FALSE(tx.commit());
+  }
+  {
+    auto tx = manager.beginTransaction(false);
+    TEST_ASSERT_TRUE(tx.stage("tx", first->getKey(), "98"));
+  }
+  TEST_ASSERT_EQUAL(10, first->get());
+
+  // A persistent commit writes every value in one NVS session.
+  manager.setPersistQuietPeriod(0);
+  manager.resetPersistStats();
+  {
+    auto tx = manager.beginTransaction();
+    TEST_ASSERT_TRUE(tx.stage("tx", first->getKey(), "11"));
+    TEST_ASSERT_TRUE(tx.stage("tx", second->getKey(), "21"));
+    TEST_ASSERT_TRUE(tx.stage("tx", text->getKey(), "saved"));
+    TEST_ASSERT_TRUE(tx.commit());
+  }
+  TEST_ASSERT_EQUAL_UINT32(1, manager.getPersistStats().sessions);
+  TEST_ASSERT_EQUAL_UINT32(3, manager.getPersistStats().written);
+  TEST_ASSERT_EQUAL(2, txCallbackCalls);
+}
+
+void test_transaction_io_pins_use_staged_view() {
+  ConfigManagerClass manager;
+  Config<int>& pinA = manager.addSettingInt("txPinA").name("Pin A").category("txio").defaultValue(18).ioPinRole(cm::io::IOPinRole::DigitalOutput).persist(false).build();
+  Config<int>& pinB = manager.addSettingInt("txPinB").name("Pin B").category("txio").defaultValue(19).ioPinRole(cm::io::IOPinRole::DigitalOutput).persist(false).build();
+
+  // Swapping two pins is valid once both values are staged.
+  {
+    auto tx = manager.beginTransaction(false);
+    TEST_ASSERT_TRUE(tx.stage("txio", pinA.getKey(), "19"));
+    TEST_ASSERT_TRUE(tx.stage("txio", pinB.getKey(), "18"));
+    TEST_ASSERT_EQUAL_UINT32(0, tx.validateIOPins());
+    TEST_ASSERT_TRUE(tx.commit());
+  }
+  TEST_ASSERT_EQUAL(19, pinA.get());
+  TEST_ASSERT_EQUAL(18, pinB.get());
+
+  // Two staged settings on a pin neither uses yet are rejected.
+  {
+    auto tx = manager.beginTransaction(false);
+    TEST_ASSERT_TRUE(tx.stage("txio", pinA.getKey(), "21"));
+    TEST_ASSERT_TRUE(tx.stage("txio", pinB.getKey(), "21"));
+    TEST_ASSERT_EQUAL_UINT32(2, tx.validateIOPins());
+    TEST_ASSERT_FALSE(tx.commit());
+  }
+  TEST_ASSERT_EQUAL(19, pinA.get());
+
+  // A single change is checked against the live values.
+  TEST_ASSERT_FALSE(manager.applySetting("txio", pinA.getKey(), "18"));
+  TEST_ASSERT_EQUAL(19, pinA.get());
+}
+
+#ifdef CM_PERF_BENCHMARKS
+// Counts operator new calls (vector buffers, std::function targets) for the allocation benchmarks.
+std::atomic<uint32_t> perfOperatorNewCount{0};
+
+void* operator new(size_t size) {
+  perfOperatorNewCount.fetch_add(1, std::memory_order_relaxed);
+  void* ptr = malloc(size ? size : 1);
+  if (!ptr) {
+    abort();
+  }
+  return ptr;
+}
+
+void* operator new[](size_t size) {
+  return ::operator new(size);
+}
+
+namespace {
+
+struct LookupBenchEntry {
+  const char* category = nullptr;
+  char key[CM_STORAGE_KEY_BUFFER_SIZE] = {};
+  const char* getCategory() const {
+    return category;
+  }
+  const char* getKey() const {
+    return key;
+  }
+};
+
+const char* const LOOKUP_BENCH_CATEGORIES[] = {"WiFi", "System", "MQTT", "IO", "Display", "Alarms", "Heater", "Solar"};
+constexpr size_t LOOKUP_BENCH_LINEAR_SAMPLES = 64;
+
+// Mirrors the previous findSetting(): full scan with two String temporaries per element.
+const LookupBenchEntry* linearLookup(const std::deque<LookupBenchEntry>& entries, const String& category, const String& key) {
+  for (const LookupBenchEntry& entry : entries) {
+    if (String(entry.getCategory()) == category) {
+      if (String(entry.getKey()) == key) {
+        return &entry;
+      }
+    }
+  }
+  return nullptr;
+}
+
+void benchSettingLookup(size_t count) {
+  // std::deque keeps the 5000-entry fixture out of one large contiguous block.
+  std::deque<LookupBenchEntry> entries(count);
+  SettingLookupIndex<LookupBenchEntry> index;
+  for (size_t i = 0; i < count; ++i) {
+    char hint[24];
+    snprintf(hint, sizeof(hint), "bench_%u", static_cast<unsigned>(i));
+    entries[i].category = LOOKUP_BENCH_CATEGORIES[i % (sizeof(LOOKUP_BENCH_CATEGORIES) / sizeof(LOOKUP_BENCH_CATEGORIES[0]))];
+    formatStorageKey(hint, strlen(hint), entries[i].key);
+    TEST_ASSERT_TRUE(index.insert(&entries[i]));
+  }
+
+  const size_t heapBefore = ESP.getFreeHeap();
+  const int64_t indexStart = esp_timer_get_time();
+  for (size_t i = 0; i < count; ++i) {
+    TEST_ASSERT_EQUAL_PTR(&entries[i], index.find(entries[i].category, entries[i].key));
+  }
+  const int64_t indexUs = esp_timer_get_time() - indexStart;
+  TEST_ASSERT_EQUAL_UINT32(heapBefore, ESP.getFreeHeap());
+
+  const size_t samples = std::min(count, LOOKUP_BENCH_LINEAR_SAMPLES);
+  const int64_t linearStart = esp_timer_get_time();
+  for (size_t s = 0; s < samples; ++s) {
+    const LookupBenchEntry& entry = entries[(s * count) / samples];
+    TEST_ASSERT_EQUAL_PTR(&entry, linearLookup(entries, String(entry.category), String(entry.key)));
+  }
+  const int64_t linearUs = esp_timer_get_time() - linearStart;
+
+  Serial.printf("[perf] setting_lookup n=%u index_ns=%u linear_ns=%u slots=%u\n",
+                static_cast<unsigned>(count),
+                static_cast<unsigned>((indexUs * 1000) / static_cast<int64_t>(count)),
+                static_cast<unsigned>((linearUs * 1000) / static_cast<int64_t>(samples)),
+                static_cast<unsigned>(index.capacity()));
+}
+
+void test_perf_setting_lookup() {
+  benchSettingLookup(50);
+  benchSettingLookup(500);
+  benchSettingLookup(5000);
+}
+
+constexpr size_t CONFIG_BENCH_SETTINGS = 200;
+constexpr size_t CONFIG_BENCH_CATEGORIES = 12;
+constexpr size_t CONFIG_BENCH_CHUNK = 1436; // Typical AsyncTCP chunk payload
+char configBenchCategories[CONFIG_BENCH_CATEGORIES][12];
+
+// Previous /config.json path: full JsonDocument tree plus one pretty-printed String.
+String legacyConfigJson(const std::vector<BaseSetting*>& settings) {
+  JsonDocument doc;
+  JsonObject root = doc.to<JsonObject>();
+  for (const BaseSetting* s : settings) {
+    JsonVariant existing = root[s->getCategory()];
+    JsonObject catObj = existing.is<JsonObject>() ? existing.as<JsonObject>() : root.createNestedObject(s->getCategory());
+    catObj["categoryPretty"] = s->getCategoryPretty();
+    s->toJSON(catObj);
+  }
+  String output;
+  serializeJsonPretty(doc, output);
+  return output;
+}
+
+void test_perf_config_json_stream() {
+  ConfigManagerClass manager;
+  for (size_t i = 0; i < CONFIG_BENCH_SETTINGS; ++i) {
+    char* category = configBenchCategories[i % CONFIG_BENCH_CATEGORIES];
+    snprintf(category, sizeof(configBenchCategories[0]), "bench%u", static_cast<unsigned>(i % CONFIG_BENCH_CATEGORIES));
+    char hint[16];
+    snprintf(hint, sizeof(hint), "cb_%u", static_cast<unsigned>(i));
+    ConfigOptions<String> opts{.key = hint, .name = "Benchmark value", .category = category, .defaultValue = "0123456789abcdef0123456789abcdef"};
+    manager.addSetting(std::unique_ptr<BaseSetting>(new Config<String>(opts)));
+  }
+
+  const size_t legacyFreeBefore = ESP.getFreeHeap();
+  const int64_t legacyStart = esp_timer_get_time();
+  size_t legacyBytes = 0;
+  size_t legacyFreeMin = legacyFreeBefore;
+  {
+    auto payload = std::make_shared<String>(legacyConfigJson(manager.getSettings()));
+    legacyBytes = payload->length();
+    legacyFreeMin = ESP.getFreeHeap();
+  }
+  // The old handler only sent its first byte once the whole String existed.
+  const int64_t legacyTtfbUs = esp_timer_get_time() - legacyStart;
+
+  std::unique_ptr<uint8_t[]> chunk(new uint8_t[CONFIG_BENCH_CHUNK]);
+  const size_t streamFreeBefore = ESP.getFreeHeap();
+  const int64_t streamStart = esp_timer_get_time();
+  auto stream = std::make_shared<cm::web::ConfigJsonStream>(manager.getSettings(), true);
+  size_t streamBytes = stream->read(chunk.get(), CONFIG_BENCH_CHUNK);
+  const int64_t streamTtfbUs = esp_timer_get_time() - streamStart;
+  size_t streamFreeMin = ESP.getFreeHeap();
+  size_t len = 0;
+  while ((len = stream->read(chunk.get(), CONFIG_BENCH_CHUNK)) > 0) {
+    streamBytes += len;
+    streamFreeMin = std::min(streamFreeMin, static_cast<size_t>(ESP.getFreeHeap()));
+  }
+  const int64_t streamTotalUs = esp_timer_get_time() - streamStart;
+  TEST_ASSERT_TRUE(stream->done());
+
+  Serial.printf("[perf] config_json settings=%u legacy_bytes=%u legacy_peak=%d legacy_ttfb_us=%lld stream_bytes=%u stream_peak=%d stream_ttfb_us=%lld stream_total_us=%lld\n",
+                static_cast<unsigned>(CONFIG_BENCH_SETTINGS),
+                static_cast<unsigned>(legacyBytes),
+                static_cast<int>(legacyFreeBefore) - static_cast<int>(legacyFreeMin),
+                static_cast<long long>(legacyTtfbUs),
+                static_cast<unsigned>(streamBytes),
+                static_cast<int>(streamFreeBefore) - static_cast<int>(streamFreeMin),
+                static_cast<long long>(streamTtfbUs),
+                static_cast<long long>(streamTotalUs));
+}
+
+constexpr size_t BOOT_BENCH_SETTINGS = 100;
+
+void test_perf_boot_load_blob_vs_per_key() {
+  using Mode = ConfigManagerClass::SettingsStorageMode;
+  ConfigManagerClass manager;
+  for (size_t i = 0; i < BOOT_BENCH_SETTINGS; ++i) {
+    char hint[16];
+    snprintf(hint, sizeof(hint), "bl_%u", static_cast<unsigned>(i));
+    if (i % 4 == 0) {
+      manager.addSetting(std::unique_ptr<BaseSetting>(new Config<String>(ConfigOptions<String>{.key = hint, .name = "Boot", .category = "boot", .defaultValue = "boot benchmark value"})));
+    } else {
+      manager.addSetting(std::unique_ptr<BaseSetting>(new Config<int>(ConfigOptions<int>{.key = hint, .name = "Boot", .category = "boot", .defaultValue = static_cast<int>(i)})));
+    }
+  }
+
+  manager.loadAll(); // Seeds the per-key defaults on first run.
+  const int64_t perKeyStart = esp_timer_get_time();
+  manager.loadAll();
+  const int64_t perKeyUs = esp_timer_get_time() - perKeyStart;
+
+  manager.setSettingsStorageMode(Mode::Blob);
+  manager.loadAll(); // Migrates into the snapshot.
+  const int64_t blobStart = esp_timer_get_time();
+  manager.loadAll();
+  const int64_t blobUs = esp_timer_get_time() - blobStart;
+
+  Serial.printf("[perf] boot_load settings=%u per_key_us=%lld blob_us=%lld\n",
+                static_cast<unsigned>(BOOT_BENCH_SETTINGS),
+                static_cast<long long>(perKeyUs),
+                static_cast<long long>(blobUs));
+
+  // The snapshot key is shared with testManager; leave NVS as the other tests expect.
+  Preferences raw;
+  TEST_ASSERT_TRUE(raw.begin("ConfigManager", false));
+  raw.remove(cm::storage::BLOB_PREFS_KEY);
+  raw.end();
+}
+
+constexpr size_t APPLY_BENCH_ITERATIONS = 1000;
+
+// Counts pool/string allocations made by the legacy path's JsonDocument.
+class CountingAllocator : public ArduinoJson::Allocator {
+public:
+  void* allocate(size_t size) override {
+    ++allocations;
+    return malloc(size);
+  }
+  void deallocate(void* ptr) override {
+    free(ptr);
+  }
+  void* reallocate(void* ptr, size_t newSize) override {
+    ++allocations;
+    return realloc(ptr, newSize);
+  }
+  size_t allocations = 0;
+};
+
+// Mirrors the previous applySetting(): guess the JSON type from the text, then fromJSON().
+bool legacyApply(BaseSetting& setting, const String& value, ArduinoJson::Allocator* allocator) {
+  JsonDocument doc(allocator);
+  if (value == "true") {
+    doc.set(true);
+  } else if (value == "false") {
+    doc.set(false);
+  } else {
+    char* endPtr;
+    const long longVal = strtol(value.c_str(), &endPtr, 10);
+    if (*endPtr == '\0') {
+      doc.set(static_cast<int>(longVal));
+    } else {
+      const float floatVal = strtof(value.c_str(), &endPtr);
+      if (*endPtr == '\0') {
+        doc.set(floatVal);
+      } else {
+        doc.set(value);
+      }
+    }
+  }
+  return setting.fromJSON(doc.as<JsonVariant>());
+}
+
+void benchApply(const char* label, BaseSetting& setting, const char* text) {
+  const String value(text);
+  CountingAllocator counter;
+  const int64_t legacyStart = esp_timer_get_time();
+  for (size_t i = 0; i < APPLY_BENCH_ITERATIONS; ++i) {
+    TEST_ASSERT_TRUE(legacyApply(setting, value, &counter));
+  }
+  const int64_t legacyUs = esp_timer_get_time() - legacyStart;
+
+  const size_t len = strlen(text);
+  const size_t heapBefore = ESP.getFreeHeap();
+  const int64_t typedStart = esp_timer_get_time();
+  for (size_t i = 0; i < APPLY_BENCH_ITERATIONS; ++i) {
+    TEST_ASSERT_TRUE(setting.fromString(text, len));
+  }
+  const int64_t typedUs = esp_timer_get_time() - typedStart;
+  if (setting.getType() != SettingType::STRING) {
+    TEST_ASSERT_EQUAL_UINT32(heapBefore, ESP.getFreeHeap());
+  }
+
+  Serial.printf("[perf] apply type=%s legacy_ns=%u legacy_doc_allocs=%u typed_ns=%u\n",
+                label,
+                static_cast<unsigned>((legacyUs * 1000) / static_cast<int64_t>(APPLY_BENCH_ITERATIONS)),
+                static_cast<unsigned>(counter.allocations / APPLY_BENCH_ITERATIONS),
+                static_cast<unsigned>((typedUs * 1000) / static_cast<int64_t>(APPLY_BENCH_ITERATIONS)));
+}
+
+void test_perf_apply_setting_from_string() {
+  Config<int> intSetting(ConfigOptions<int>{.key = "ab_int", .name = "Apply", .category = "bench", .defaultValue = 0});
+  Config<float> floatSetting(ConfigOptions<float>{.key = "ab_flt", .name = "Apply", .category = "bench", .defaultValue = 0.0f});
+  Config<bool> boolSetting(ConfigOptions<bool>{.key = "ab_bool", .name = "Apply", .category = "bench", .defaultValue = false});
+  Config<String> stringSetting(ConfigOptions<String>{.key = "ab_str", .name = "Apply", .category = "bench", .defaultValue = ""});
+
+  benchApply("int", intSetting, "12345");
+  benchApply("float", floatSetting, "21.75");
+  benchApply("bool", boolSetting, "true");
+  benchApply("string", stringSetting, "living room sensor");
+}
+
+constexpr size_t LOOP_BENCH_ENTRIES = 64;
+constexpr size_t LOOP_BENCH_ITERATIONS = 200;
+
+// Average update() cost with an unchanged settings epoch vs. an epoch bumped before every call.
+template <typename UpdateFn>
+void benchLoopUpdate(const char* label, UpdateFn update) {
+  Config<int> epochBump(ConfigOptions<int>{.key = "lb_bump", .name = "Bump", .category = "bench", .defaultValue = 0});
+  update(); // Settle caches.
+
+  const int64_t stableStart = esp_timer_get_time();
+  for (size_t i = 0; i < LOOP_BENCH_ITERATIONS; ++i) {
+    update();
+  }
+  const int64_t stableUs = esp_timer_get_time() - stableStart;
+
+  const int64_t changedStart = esp_timer_get_time();
+  for (size_t i = 0; i < LOOP_BENCH_ITERATIONS; ++i) {
+    epochBump.set(static_cast<int>(i) + 1);
+    update();
+  }
+  const int64_t changedUs = esp_timer_get_time() - changedStart;
+
+  Serial.printf("[perf] %s entries=%u unchanged_ns=%u changed_ns=%u\n",
+                label,
+                static_cast<unsigned>(LOOP_BENCH_ENTRIES),
+                static_cast<unsigned>((stableUs * 1000) / static_cast<int64_t>(LOOP_BENCH_ITERATIONS)),
+                static_cast<unsigned>((changedUs * 1000) / static_cast<int64_t>(LOOP_BENCH_ITERATIONS)));
+}
+
+void test_perf_loop_update_settings_epoch() {
+  cm::IOManager io;
+  char ids[LOOP_BENCH_ENTRIES][8];
+  for (size_t i = 0; i < LOOP_BENCH_ENTRIES; ++i) {
+    snprintf(ids[i], sizeof(ids[i]), "in%02u", static_cast<unsigned>(i));
+    cm::IOManager::DigitalInputBinding binding;
+    binding.id = ids[i];
+    binding.defaultPin = 34 + static_cast<int>(i % 6); // Input-only GPIOs
+    binding.defaultPullup = false;
+    binding.registerSettings = false;
+    io.addDigitalInput(binding);
+  }
+  io.begin();
+  benchLoopUpdate("io_update", [&io]() { io.update(); });
+
+  cm::AlarmManager alarms;
+  alarms.setUpdateInterval(0);
+  float sources[LOOP_BENCH_ENTRIES];
+  for (size_t i = 0; i < LOOP_BENCH_ENTRIES; ++i) {
+    sources[i] = static_cast<float>(i);
+    alarms.addAnalogAlarm(ids[i], ids[i], &sources[i], cm::AlarmKind::AnalogOutsideWindow, 10.0f, 50.0f, true, true, true);
+  }
+  benchLoopUpdate("alarm_update", [&alarms]() { alarms.update(); });
+}
+
+constexpr size_t BULK_BENCH_SETTINGS = 200;
+
+void test_perf_bulk_save_transaction() {
+  ConfigManagerClass manager;
+  for (size_t i = 0; i < BULK_BENCH_SETTINGS; ++i) {
+    char hint[16];
+    snprintf(hint, sizeof(hint), "tx_%u", static_cast<unsigned>(i));
+    manager.addSetting(std::unique_ptr<BaseSetting>(new Config<int>(ConfigOptions<int>{.key = hint, .name = "Bulk", .category = "bulk", .defaultValue = 0})));
+  }
+  const std::vector<BaseSetting*>& settings = manager.getSettings();
+  manager.setPersistQuietPeriod(0);
+
+  // Previous /config/save_all: one updateSetting() (and NVS session) per value.
+  manager.resetPersistStats();
+  const int64_t perSettingStart = esp_timer_get_time();
+  for (size_t i = 0; i < BULK_BENCH_SETTINGS; ++i) {
+    TEST_ASSERT_TRUE(manager.updateSetting("bulk", settings[i]->getKey(), String(1000 + static_cast<int>(i))));
+  }
+  const int64_t perSettingUs = esp_timer_get_time() - perSettingStart;
+  const uint32_t perSettingSessions = manager.getPersistStats().sessions;
+
+  manager.resetPersistStats();
+  const int64_t txStart = esp_timer_get_time();
+  {
+    auto tx = manager.beginTransaction();
+    for (size_t i = 0; i < BULK_BENCH_SETTINGS; ++i) {
+      TEST_ASSERT_TRUE(tx.stage("bulk", settings[i]->getKey(), String(2000 + static_cast<int>(i))));
+    }
+    TEST_ASSERT_TRUE(tx.commit());
+  }
+  const int64_t txUs = esp_timer_get_time() - txStart;
+  TEST_ASSERT_EQUAL_UINT32(1, manager.getPersistStats().sessions);
+  TEST_ASSERT_EQUAL_UINT32(BULK_BENCH_SETTINGS, manager.getPersistStats().written);
+
+  Serial.printf("[perf] bulk_save settings=%u per_setting_us=%lld per_setting_sessions=%u transaction_us=%lld transaction_sessions=%u\n",
+                static_cast<unsigned>(BULK_BENCH_SETTINGS),
+                static_cast<long long>(perSettingUs),
+                static_cast<unsigned>(perSettingSessions),
+                static_cast<long long>(txUs),
+                static_cast<unsigned>(manager.getPersistStats().sessions));
+}
+
+template <typename T>
+BaseSetting* addClassicTwin(std::vector<std::unique_ptr<BaseSetting>>& twins, const BaseSetting* source, size_t index) {
+  const auto* setting = static_cast<const Config<T>*>(source);
+  char hint[16];
+  snprintf(hint, sizeof(hint), "rt_%u", static_cast<unsigned>(index));
+  twins.emplace_back(new Config<T>(ConfigOptions<T>{.key = hint, .name = setting->getDisplayName(), .category = setting->getCategory(), .defaultValue = setting->getDefaultValue(), .showInWeb = setting->shouldShowInWeb(), .isPassword = setting->isSecret(), .sortOrder = setting->getSortOrder()}));
+  return twins.back().get();
+}
+
+void test_perf_settings_ram_descriptor_tables() {
+  // Full-GUI-Demo attaches the WiFi, System and NTP core bundles, which use descriptor tables.
+  ConfigManagerClass tableManager;
+  const size_t tableFreeBefore = ESP.getFreeHeap();
+#if CM_ENABLE_WIFI
+  auto wifi = std::make_unique<cm::CoreWiFiSettings>();
+#endif
+  auto system = std::make_unique<cm::CoreSystemSettings>(String(CONFIGMANAGER_VERSION));
+  auto ntp = std::make_unique<cm::CoreNtpSettings>();
+  const size_t tableHeapUsed = tableFreeBefore - ESP.getFreeHeap();
+#if CM_ENABLE_WIFI
+  wifi->attachTo(tableManager);
+#endif
+  system->attachTo(tableManager);
+  ntp->attachTo(tableManager);
+  const std::vector<BaseSetting*>& tableSettings = tableManager.getSettings();
+
+  // The same settings built from ConfigOptions (distinct hints, so keys do not collide).
+  ConfigManagerClass classicManager;
+  std::vector<std::unique_ptr<BaseSetting>> twins;
+  twins.reserve(tableSettings.size());
+  const size_t classicFreeBefore = ESP.getFreeHeap();
+  for (size_t i = 0; i < tableSettings.size(); ++i) {
+    switch (tableSettings[i]->getType()) {
+      case SettingType::BOOL:
+        addClassicTwin<bool>(twins, tableSettings[i], i);
+        break;
+      case SettingType::INT:
+        addClassicTwin<int>(twins, tableSettings[i], i);
+        break;
+      case SettingType::FLOAT:
+        addClassicTwin<float>(twins, tableSettings[i], i);
+        break;
+      default:
+        addClassicTwin<String>(twins, tableSettings[i], i);
+        break;
+    }
+  }
+  const size_t classicHeapUsed = classicFreeBefore - ESP.getFreeHeap();
+  for (const auto& twin : twins) {
+    TEST_ASSERT_NOT_NULL(classicManager.addSetting(twin.get()));
+  }
+
+  const ConfigManagerClass::SettingsRamReport classic = classicManager.getSettingsRamReport();
+  const ConfigManagerClass::SettingsRamReport table = tableManager.getSettingsRamReport();
+  TEST_ASSERT_EQUAL_UINT32(classic.settings, table.settings);
+  TEST_ASSERT_EQUAL_UINT32(0, classic.flashDescriptors);
+  TEST_ASSERT_TRUE(table.heapBytes <= classic.heapBytes);
+
+  Serial.printf("[perf] settings_ram settings=%u flash_descriptors=%u classic_object=%u classic_heap=%u classic_measured=%u table_object=%u table_heap=%u table_measured=%u\n",
+                static_cast<unsigned>(table.settings),
+                static_cast<unsigned>(table.flashDescriptors),
+                static_cast<unsigned>(classic.objectBytes),
+                static_cast<unsigned>(classic.heapBytes),
+                static_cast<unsigned>(classicHeapUsed),
+                static_cast<unsigned>(table.objectBytes),
+                static_cast<unsigned>(table.heapBytes),
+                static_cast<unsigned>(tableHeapUsed));
+}
+
+constexpr size_t RUNTIME_BENCH_GROUPS = 8;
+constexpr size_t RUNTIME_BENCH_PUSHES = 20;
+
+void registerRuntimeBenchControls(ConfigManagerRuntime& runtime, size_t groups, size_t controls) {
+  for (size_t g = 0; g < groups; ++g) {
+    runtime.addRuntimeProvider(String("rg") + g, [](JsonObject& obj) { obj["v"] = 1; });
+  }
+  for (size_t i = 0; i < controls; ++i) {
+    const String group = String("rg") + (i % groups);
+    const String key = String("c") + i;
+    switch (i % 4) {
+      case 0:
+        runtime.registerRuntimeCheckbox(group, key, []() { return true; }, [](bool) {});
+        break;
+      case 1:
+        runtime.registerRuntimeIntSlider(group, key, []() { return 42; }, [](int) {}, 0, 100);
+        break;
+      case 2:
+        runtime.registerRuntimeFloatSlider(group, key, []() { return 0.5f; }, [](float) {}, 0.0f, 1.0f);
+        break;
+      default:
+        runtime.registerRuntimeIntInput(group, key, []() { return 7; }, [](int) {}, 0, 10);
+        break;
+    }
+  }
+}
+
+void benchRuntimeRegistry(size_t controls) {
+  ConfigManagerRuntime runtime;
+  registerRuntimeBenchControls(runtime, RUNTIME_BENCH_GROUPS, controls);
+  TEST_ASSERT_EQUAL_UINT32(controls, runtime.getControlRegistry()->controlCount());
+  runtime.runtimeValuesToJSON(); // Warm-up
+
+  const uint32_t pushNewBefore = perfOperatorNewCount.load();
+  const int64_t pushStart = esp_timer_get_time();
+  for (size_t i = 0; i < RUNTIME_BENCH_PUSHES; ++i) {
+    const String frame = runtime.runtimeValuesToJSON();
+    TEST_ASSERT_TRUE(frame.length() > 2);
+  }
+  const int64_t pushUs = (esp_timer_get_time() - pushStart) / static_cast<int64_t>(RUNTIME_BENCH_PUSHES);
+  const uint32_t pushNew = (perfOperatorNewCount.load() - pushNewBefore) / RUNTIME_BENCH_PUSHES;
+
+  // Taking the snapshot is a reference-count bump.
+  const uint32_t snapshotNewBefore = perfOperatorNewCount.load();
+  const std::shared_ptr<const RuntimeControlRegistry> registry = runtime.getControlRegistry();
+  TEST_ASSERT_EQUAL_UINT32(snapshotNewBefore, perfOperatorNewCount.load());
+
+  // The previous runtimeValuesToJSON() copied every provider/control vector per push.
+  const uint32_t legacyNewBefore = perfOperatorNewCount.load();
+  const int64_t legacyStart = esp_timer_get_time();
+  {
+    const RuntimeControlRegistry legacySnapshot = *registry;
+    TEST_ASSERT_EQUAL_UINT32(controls, legacySnapshot.controlCount());
+  }
+  const int64_t legacyUs = esp_timer_get_time() - legacyStart;
+  const uint32_t legacyNew = perfOperatorNewCount.load() - legacyNewBefore;
+
+  Serial.printf("[perf] runtime_registry controls=%u push_us=%lld push_new=%u legacy_copy_us=%lld legacy_copy_new=%u\n",
+                static_cast<unsigned>(controls),
+                static_cast<long long>(pushUs),
+                static_cast<unsigned>(pushNew),
+                static_cast<long long>(legacyUs),
+                static_cast<unsigned>(legacyNew));
+}
+
+void test_perf_runtime_registry_snapshot() {
+  benchRuntimeRegistry(10);
+  benchRuntimeRegistry(100);
+  benchRuntimeRegistry(500);
+}
+
+template <typename Control>
+void legacyWriteMatching(JsonObject& slot, const std::vector<Control>& controls, const String& group) {
+  for (const auto& control : controls) {
+    if (control.group == group && control.getter) {
+      slot[control.key] = control.getter();
+    }
+  }
+}
+
+template <typename Control>
+void legacyWriteAll(JsonObject& root, const std::vector<Control>& controls) {
+  for (const auto& control : controls) {
+    if (!control.getter) {
+      continue;
+    }
+    JsonVariant existing = root[control.group];
+    JsonObject slot = existing.is<JsonObject>() ? existing.as<JsonObject>() : root.createNestedObject(control.group);
+    slot[control.key] = control.getter();
+  }
+}
+
+// Previous runtimeValuesToJSON() matching: every provider scans every control vector,
+// then a second pass looks up the group object for every control.
+String legacyRuntimeValues(const RuntimeControlRegistry& registry) {
+  JsonDocument doc;
+  JsonObject root = doc.to<JsonObject>();
+  root["uptime"] = millis();
+  for (const auto& prov : registry.providers) {
+    JsonObject slot = root.createNestedObject(prov.name);
+    prov.fill(slot);
+    legacyWriteMatching(slot, registry.checkboxes, prov.name);
+    legacyWriteMatching(slot, registry.stateButtons, prov.name);
+    legacyWriteMatching(slot, registry.intSliders, prov.name);
+    legacyWriteMatching(slot, registry.floatSliders, prov.name);
+    legacyWriteMatching(slot, registry.intInputs, prov.name);
+    legacyWriteMatching(slot, registry.floatInputs, prov.name);
+  }
+  legacyWriteAll(root, registry.checkboxes);
+  legacyWriteAll(root, registry.stateButtons);
+  legacyWriteAll(root, registry.intSliders);
+  legacyWriteAll(root, registry.floatSliders);
+  legacyWriteAll(root, registry.intInputs);
+  legacyWriteAll(root, registry.floatInputs);
+  String out;
+  serializeJson(doc, out);
+  return out;
+}
+
+void benchRuntimeGroupIndex(size_t groups, size_t controls) {
+  ConfigManagerRuntime runtime;
+  registerRuntimeBenchControls(runtime, groups, controls);
+  const std::shared_ptr<const RuntimeControlRegistry> registry = runtime.getControlRegistry();
+  TEST_ASSERT_EQUAL_UINT32(groups, registry->groups.size());
+
+  // Same members, possibly in a different key order.
+  const String indexed = runtime.runtimeValuesToJSON();
+  const String legacy = legacyRuntimeValues(*registry);
+  TEST_ASSERT_EQUAL_UINT32(legacy.length(), indexed.length());
+
+  const int64_t indexedStart = esp_timer_get_time();
+  for (size_t i = 0; i < RUNTIME_BENCH_PUSHES; ++i) {
+    runtime.runtimeValuesToJSON();
+  }
+  const int64_t indexedUs = (esp_timer_get_time() - indexedStart) / static_cast<int64_t>(RUNTIME_BENCH_PUSHES);
+
+  const int64_t legacyStart = esp_timer_get_time();
+  for (size_t i = 0; i < RUNTIME_BENCH_PUSHES; ++i) {
+    legacyRuntimeValues(*registry);
+  }
+  const int64_t legacyUs = (esp_timer_get_time() - legacyStart) / static_cast<int64_t>(RUNTIME_BENCH_PUSHES);
+
+  Serial.printf("[perf] runtime_group_index groups=%u controls=%u indexed_us=%lld legacy_us=%lld\n",
+                static_cast<unsigned>(groups),
+                static_cast<unsigned>(controls),
+                static_cast<long long>(indexedUs),
+                static_cast<long long>(legacyUs));
+}
+
+constexpr size_t DELTA_BENCH_GROUPS = 15;
+constexpr size_t DELTA_BENCH_FIELDS_PER_GROUP = 10; // 150 live fields
+constexpr size_t DELTA_BENCH_PUSHES = 50;
+int32_t deltaBenchValues[DELTA_BENCH_GROUPS * DELTA_BENCH_FIELDS_PER_GROUP];
+
+void benchRuntimeDelta(size_t changedPerPush) {
+  ConfigManagerRuntime runtime;
+  for (size_t g = 0; g < DELTA_BENCH_GROUPS; ++g) {
+    runtime.addRuntimeProvider(String("dg") + g, [g](JsonObject& obj) {
+      char key[8];
+      for (size_t f = 0; f < DELTA_BENCH_FIELDS_PER_GROUP; ++f) {
+        snprintf(key, sizeof(key), "f%u", static_cast<unsigned>(f));
+        obj[key] = deltaBenchValues[g * DELTA_BENCH_FIELDS_PER_GROUP + f];
+      }
+    });
+  }
+  const size_t fieldCount = DELTA_BENCH_GROUPS * DELTA_BENCH_FIELDS_PER_GROUP;
+  for (size_t i = 0; i < fieldCount; ++i) {
+    deltaBenchValues[i] = static_cast<int32_t>(i * 37);
+  }
+
+  size_t fullBytes = 0;
+  const int64_t fullStart = esp_timer_get_time();
+  for (size_t push = 0; push < DELTA_BENCH_PUSHES; ++push) {
+    fullBytes += runtime.runtimeValuesToJSON().length();
+  }
+  const int64_t fullUs = esp_timer_get_time() - fullStart;
+
+  String frame;
+  runtime.runtimeDeltaFrame(true, frame);
+  size_t deltaBytes = 0;
+  size_t cursor = 0;
+  const int64_t deltaStart = esp_timer_get_time();
+  for (size_t push = 0; push < DELTA_BENCH_PUSHES; ++push) {
+    for (size_t c = 0; c < changedPerPush; ++c) {
+      ++deltaBenchValues[cursor];
+      cursor = (cursor + 7) % fieldCount;
+    }
+    runtime.runtimeDeltaFrame(false, frame);
+    deltaBytes += frame.length();
+  }
+  const int64_t deltaUs = esp_timer_get_time() - deltaStart;
+
+  // At the default 5 s push interval.
+  const uint32_t pushesPerMinute = 60000 / CM_WS_PUSH_INTERVAL_DEFAULT_MS;
+  Serial.printf("[perf] ws_delta fields=%u changed=%u full_bytes=%u delta_bytes=%u full_us=%lld delta_us=%lld full_Bps=%u delta_Bps=%u\n",
+                static_cast<unsigned>(fieldCount),
+                static_cast<unsigned>(changedPerPush),
+                static_cast<unsigned>(fullBytes / DELTA_BENCH_PUSHES),
+                static_cast<unsigned>(deltaBytes / DELTA_BENCH_PUSHES),
+                static_cast<long long>(fullUs / static_cast<int64_t>(DELTA_BENCH_PUSHES)),
+                static_cast<long long>(deltaUs / static_cast<int64_t>(DELTA_BENCH_PUSHES)),
+                static_cast<unsigned>(fullBytes / DELTA_BENCH_PUSHES * pushesPerMinute / 60),
+                static_cast<unsigned>(deltaBytes / DELTA_BENCH_PUSHES * pushesPerMinute / 60));
+  TEST_ASSERT_TRUE(deltaBytes < fullBytes);
+}
+
+void test_perf_runtime_compact_frames() {
+  ConfigManagerRuntime runtime;
+  for (size_t g = 0; g < DELTA_BENCH_GROUPS; ++g) {
+    const String group = String("sensor_group_") + g;
+    runtime.addRuntimeProvider(group, [g](JsonObject& obj) {
+      char key[24];
+      for (size_t f = 0; f < DELTA_BENCH_FIELDS_PER_GROUP; ++f) {
+        snprintf(key, sizeof(key), "temperature_%u", static_cast<unsigned>(f));
+        obj[key] = 20.0f + static_cast<float>(g * DELTA_BENCH_FIELDS_PER_GROUP + f) / 10.0f;
+      }
+    });
+    for (size_t f = 0; f < DELTA_BENCH_FIELDS_PER_GROUP; ++f) {
+      RuntimeFieldMeta meta;
+      meta.group = group;
+      meta.key = String("temperature_") + f;
+      meta.label = meta.key;
+      runtime.addRuntimeMeta(meta);
+    }
+  }
+  runtime.runtimeMetaJsonPayload(); // Publishes the field IDs
+
+  String json;
+  String compactJson;
+  std::vector<uint8_t> msgpack;
+  std::vector<uint8_t> compactMsgpack;
+  RuntimeFrameTargets targets;
+  targets.json = &json;
+  targets.compactJson = &compactJson;
+  targets.msgpack = &msgpack;
+  targets.compactMsgpack = &compactMsgpack;
+  const int64_t start = esp_timer_get_time();
+  TEST_ASSERT_TRUE(runtime.runtimeFrame(false, true, targets));
+  const int64_t elapsedUs = esp_timer_get_time() - start;
+
+  Serial.printf("[perf] runtime_compact fields=%u json=%u compact_json=%u msgpack=%u compact_msgpack=%u all_us=%lld\n",
+                static_cast<unsigned>(DELTA_BENCH_GROUPS * DELTA_BENCH_FIELDS_PER_GROUP),
+                static_cast<unsigned>(json.length()),
+                static_cast<unsigned>(compactJson.length()),
+                static_cast<unsigned>(msgpack.size()),
+                static_cast<unsigned>(compactMsgpack.size()),
+                static_cast<long long>(elapsedUs));
+  TEST_ASSERT_TRUE(compactJson.length() < json.length());
+  TEST_ASSERT_TRUE(compactMsgpack.size() < msgpack.size());
+}
+
+// Simulates a provider that queries slow peripherals (WiFi status, sketch metrics).
+void benchRuntimeProviderCache(uint32_t refreshIntervalMs) {
+  constexpr size_t FRAMES = 50;
+  ConfigManagerRuntime runtime;
+  runtime.addRuntimeProvider("system", [](JsonObject& obj) {
+    delayMicroseconds(400);
+    obj["rssi"] = -61;
+    obj["localIP"] = "192.168.0.10";
+    obj["gateway"] = "192.168.0.1";
+    obj["routerMAC"] = "00:11:22:33:44:55";
+  }, 0, refreshIntervalMs);
+  for (size_t g = 0; g < DELTA_BENCH_GROUPS; ++g) {
+    runtime.addRuntimeProvider(String("sensor_group_") + g, [g](JsonObject& obj) {
+      obj["temperature"] = 20.0f + static_cast<float>(g);
+    });
+  }
+
+  const int64_t start = esp_timer_get_time();
+  for (size_t i = 0; i < FRAMES; ++i) {
+    TEST_ASSERT_TRUE(runtime.runtimeValuesToJSON().length() > 2);
+  }
+  const int64_t elapsedUs = esp_timer_get_time() - start;
+
+  const RuntimeProviderStats system = runtime.getRuntimeProviderStats()[0];
+  Serial.printf("[perf] runtime_provider_cache interval_ms=%u frames=%u hits=%u misses=%u fill_us=%u frame_us=%lld\n",
+                static_cast<unsigned>(refreshIntervalMs),
+                static_cast<unsigned>(FRAMES),
+                static_cast<unsigned>(system.hits),
+                static_cast<unsigned>(system.misses),
+                static_cast<unsigned>(system.lastFillUs),
+                static_cast<long long>(elapsedUs / static_cast<int64_t>(FRAMES)));
+  TEST_ASSERT_EQUAL_UINT32(FRAMES, system.hits + system.misses);
+}
+
+void test_perf_runtime_provider_cache() {
+  benchRuntimeProviderCache(0);
+  benchRuntimeProviderCache(1000);
+}
+
+#ifndef CM_PERF_SOAK_SECONDS
+#define CM_PERF_SOAK_SECONDS 30 // -DCM_PERF_SOAK_SECONDS=86400 for the 24 h soak
+#endif
+
+// Long-running push/request mix with unrelated heap traffic in between; reports the
+// largest free block over time. runtime_meta rebuilds must keep succeeding.
+void test_perf_runtime_frame_soak() {
+  ConfigManagerRuntime runtime;
+  for (size_t g = 0; g < DELTA_BENCH_GROUPS; ++g) {
+    const String group = String("sensor_group_") + g;
+    runtime.addRuntimeProvider(group, [g](JsonObject& obj) {
+      obj["temperature"] = 20.0f + static_cast<float>((millis() / 100 + g) % 50) / 10.0f;
+      obj["state"] = String("state ") + (millis() / 1000 % 7);
+    });
+    RuntimeFieldMeta meta;
+    meta.group = group;
+    meta.key = "temperature";
+    meta.label = "Temperature";
+    runtime.addRuntimeMeta(meta);
+  }
+  runtime.begin(nullptr);
+
+  std::deque<String> churn;
+  const uint32_t durationMs = static_cast<uint32_t>(CM_PERF_SOAK_SECONDS) * 1000u;
+  const uint32_t start = millis();
+  uint32_t nextReport = start;
+  uint32_t iterations = 0;
+  size_t largestAtStart = 0;
+  size_t largestMin = SIZE_MAX;
+  while (millis() - start < durationMs) {
+    String json;
+    std::vector<uint8_t> msgpack;
+    RuntimeFrameTargets targets;
+    targets.json = &json;
+    targets.msgpack = &msgpack;
+    runtime.runtimeFrame(true, iterations % 30 == 0, targets);
+    TEST_ASSERT_TRUE(runtime.runtimeValuesToJSON().length() > 2);
+
+    // Other code keeps allocating strings of varying size and lifetime.
+    churn.push_back(String(static_cast<char>('a' + iterations % 26)) + String(static_cast<float>(iterations), 3) + String(iterations * 7919u % 997u));
+    if (churn.size() > 24) {
+      churn.pop_front();
+    }
+    if (iterations % 50 == 0) {
+      runtime.updateRuntimeMeta("sensor_group_0", "temperature", [iterations](RuntimeFieldMeta& meta) {
+        meta.label = String("Temperature ") + (iterations % 10);
+      });
+      TEST_ASSERT_NOT_NULL(runtime.runtimeMetaJsonPayload().get());
+    }
+    ++iterations;
+
+    const uint32_t now = millis();
+    if (static_cast<int32_t>(now - nextReport) >= 0) {
+      const size_t largest = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+      if (largestAtStart == 0) {
+        largestAtStart = largest;
+      }
+      largestMin = std::min(largestMin, largest);
+      const cm::runtime::RuntimeFrameArenaStats arena = runtime.getFrameArenaStats();
+      Serial.printf("[perf] runtime_soak t_s=%u iterations=%u free=%u largest=%u arena_high_water=%u arena_overflows=%u\n",
+                    static_cast<unsigned>((now - start) / 1000),
+                    static_cast<unsigned>(iterations),
+                    static_cast<unsigned>(ESP.getFreeHeap()),
+                    static_cast<unsigned>(largest),
+                    static_cast<unsigned>(arena.highWaterBytes),
+                    static_cast<unsigned>(arena.overflows));
+      nextReport = now + (durationMs >= 600000 ? 60000 : 5000);
+    }
+    delay(1);
+  }
+
+  Serial.printf("[perf] runtime_soak done iterations=%u largest_start=%u largest_min=%u\n",
+                static_cast<unsigned>(iterations),
+                static_cast<unsigned>(largestAtStart),
+                static_cast<unsigned>(largestMin));
+  TEST_ASSERT_TRUE(largestMin * 2 >= largestAtStart);
+}
+
+// runtime_meta.json rebuild after an alarm toggle restyles one field, as
+// AlarmManager::updateLiveMetaStyle() does, compared with building every entry.
+void test_perf_runtime_meta_alarm_rebuild() {
+  constexpr size_t ENTRIES = 300;
+  constexpr size_t TOGGLES = 50;
+  RuntimeFieldStyle okStyle;
+  okStyle.rule("stateDotOnTrue").set("background", "#2ecc71").set("border", "none");
+  okStyle.rule("stateDotOnAlarm").set("background", "#2ecc71").set("border", "none");
+  RuntimeFieldStyle alarmStyle;
+  alarmStyle.rule("stateDotOnTrue").set("background", "#2ecc71").set("border", "none");
+  alarmStyle.rule("stateDotOnAlarm").set("background", "#e74c3c").set("border", "none").set("animation", "cm-pulse 1s infinite");
+
+  ConfigManagerRuntime runtime;
+  for (size_t i = 0; i < ENTRIES; ++i) {
+    RuntimeFieldMeta meta;
+    meta.group = String("alarms_") + (i / 20);
+    meta.page = "Alarms";
+    meta.card = String("Card ") + (i / 20);
+    meta.key = String("alarm_") + i;
+    meta.label = String("Alarm input ") + i;
+    meta.isBool = true;
+    meta.hasAlarm = true;
+    meta.alarmWhenTrue = true;
+    meta.order = static_cast<int>(i % 20);
+    meta.style = okStyle;
+    runtime.addRuntimeMeta(meta);
+  }
+
+  int64_t start = esp_timer_get_time();
+  const std::shared_ptr<const String> first = runtime.runtimeMetaJsonPayload();
+  const int64_t fullUs = esp_timer_get_time() - start;
+  TEST_ASSERT_NOT_NULL(first.get());
+
+  start = esp_timer_get_time();
+  for (size_t t = 0; t < TOGGLES; ++t) {
+    const size_t i = (t * 37) % ENTRIES;
+    const RuntimeFieldStyle& style = (t % 2) ? okStyle : alarmStyle;
+    TEST_ASSERT_TRUE(runtime.updateRuntimeMeta(String("alarms_") + (i / 20), String("alarm_") + i, [&style](RuntimeFieldMeta& meta) {
+      meta.style = style;
+    }));
+    TEST_ASSERT_NOT_NULL(runtime.runtimeMetaJsonPayload().get());
+  }
+  const int64_t toggleUs = (esp_timer_get_time() - start) / static_cast<int64_t>(TOGGLES);
+
+  Serial.printf("[perf] runtime_meta_alarm_rebuild entries=%u json=%u full_us=%lld per_toggle_us=%lld\n",
+                static_cast<unsigned>(ENTRIES),
+                static_cast<unsigned>(first->length()),
+                static_cast<long long>(fullUs),
+                static_cast<long long>(toggleUs));
+  TEST_ASSERT_TRUE(toggleUs < fullUs);
+}
+
+// Slider updates over the /ws command channel (parse, queue, drain, dispatch) compared
+// with parsing and dispatching the JSON body of a /runtime_action/int_slider POST.
+// Only the device side is measured; HTTP adds a TCP connection per action on top.
+static int perfCommandSliderValue = 0;
+static uint32_t perfCommandSetterCalls = 0;
+
+void test_perf_ws_command_dispatch() {
+  constexpr uint32_t UPDATES = 2000;
+  constexpr uint32_t BURST = 8; // Slider events arriving between two loop passes
+  testManager.getRuntimeManager().registerRuntimeIntSlider("perfCmd", "level", []() { return perfCommandSliderValue; }, [](int v) {
+      perfCommandSliderValue = v;
+      ++perfCommandSetterCalls;
+    }, 0, 100000);
+  char message[96];
+  bool boolValue = false;
+  int intValue = 0;
+  float floatValue = 0.0f;
+
+  perfCommandSetterCalls = 0;
+  int64_t start = esp_timer_get_time();
+  for (uint32_t i = 0; i < UPDATES; ++i) {
+    snprintf(message, sizeof(message), "{\"group\":\"perfCmd\",\"key\":\"level\",\"value\":%u}", static_cast<unsigned>(i));
+    JsonDocument doc;
+    TEST_ASSERT_TRUE(deserializeJson(doc, message) == DeserializationError::Ok);
+    TEST_ASSERT_TRUE(cm::web::parseRuntimeActionValue(cm::web::RuntimeActionKind::IntSlider, doc.containsKey("value"), doc["value"], boolValue, intValue, floatValue));
+    TEST_ASSERT_TRUE(cm::web::dispatchRuntimeAction(&testManager, cm::web::RuntimeActionKind::IntSlider, doc["group"].as<String>(), doc["key"].as<String>(), true, boolValue, intValue, floatValue));
+  }
+  const int64_t httpUs = esp_timer_get_time() - start;
+  const uint32_t httpDispatches = perfCommandSetterCalls;
+
+  cm::web::RuntimeCommandQueue queue(CM_RUNTIME_ACTION_QUEUE_SIZE);
+  std::vector<cm::web::RuntimeCommand> batch;
+  batch.reserve(queue.capacity());
+  int64_t maxLatencyUs = 0;
+  perfCommandSetterCalls = 0;
+  start = esp_timer_get_time();
+  for (uint32_t i = 0; i < UPDATES; ++i) {
+    const int len = snprintf(message, sizeof(message), "[%u,\"is\",\"perfCmd\",\"level\",%u]", static_cast<unsigned>(i), static_cast<unsigned>(i));
+    cm::web::RuntimeCommand command;
+    TEST_ASSERT_TRUE(cm::web::RuntimeCommandQueue::parse(reinterpret_cast<const uint8_t*>(message), static_cast<size_t>(len), command));
+    command.clientId = 1;
+    queue.push(std::move(command));
+    if ((i + 1) % BURST != 0) {
+      continue;
+    }
+    queue.drain(batch);
+    for (const auto& c : batch) {
+      TEST_ASSERT_TRUE(cm::web::dispatchRuntimeAction(&testManager, c.kind, c.group, c.key, c.hasValue, c.boolValue, c.intValue, c.floatValue));
+      maxLatencyUs = std::max(maxLatencyUs, esp_timer_get_time() - c.receivedUs);
+    }
+  }
+  const int64_t wsUs = esp_timer_get_time() - start;
+
+  Serial.printf("[perf] ws_command updates=%u burst=%u http_us=%lld http_per_s=%lld http_dispatches=%u ws_us=%lld ws_per_s=%lld ws_dispatches=%u ws_max_latency_us=%lld\n",
+                static_cast<unsigned>(UPDATES),
+                static_cast<unsigned>(BURST),
+                static_cast<long long>(httpUs),
+                static_cast<long long>(httpUs > 0 ? UPDATES * 1000000LL / httpUs : 0),
+                static_cast<unsigned>(httpDispatches),
+                static_cast<long long>(wsUs),
+                static_cast<long long>(wsUs > 0 ? UPDATES * 1000000LL / wsUs : 0),
+                static_cast<unsigned>(perfCommandSetterCalls),
+                static_cast<long long>(maxLatencyUs));
+  TEST_ASSERT_EQUAL_UINT32(UPDATES, httpDispatches);
+  TEST_ASSERT_EQUAL_UINT32(UPDATES / BURST, perfCommandSetterCalls);
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(UPDATES - 1), perfCommandSliderValue);
+}
+
+void test_perf_runtime_delta_frames() {
+  benchRuntimeDelta(1);
+  benchRuntimeDelta(10);
+  benchRuntimeDelta(50);
+}
+
+// The "runtime" object of webui/db.live.json.
+const char DB_LIVE_RUNTIME_SAMPLE[] = R"JSON({"uptime":1674984,"system":{"rssi":-41,"rssiBars":"Excellent","freeHeap":193,"loopAvg":1.018332315},"sensors":{"temp":20.9,"hum":19.25586,"dew":-3.43535,"Pressure":1027.99},"Hand overrides":{"sb_mode":true,"i_adj":0,"f_adj":0},"alarms":{"dewpoint_risk":true,"temp_low":false}})JSON";
+constexpr size_t MSGPACK_BENCH_ITERATIONS = 200;
+
+// Providers assign float sensor values; parsed decimals would otherwise be doubles.
+void storeDecimalsAsFloat(JsonObject obj) {
+  for (JsonPair entry : obj) {
+    JsonVariant value = entry.value();
+    if (value.is<JsonObject>()) {
+      storeDecimalsAsFloat(value.as<JsonObject>());
+    } else if (value.is<float>() && !value.is<long long>()) {
+      value.set(value.as<float>());
+    }
+  }
+}
+
+void benchRuntimeMsgPack(size_t copies) {
+  JsonDocument sample;
+  TEST_ASSERT_TRUE(deserializeJson(sample, DB_LIVE_RUNTIME_SAMPLE) == DeserializationError::Ok);
+  storeDecimalsAsFloat(sample.as<JsonObject>());
+  JsonDocument doc;
+  for (size_t copy = 0; copy < copies; ++copy) {
+    for (JsonPair entry : sample.as<JsonObject>()) {
+      const String key = copy == 0 ? String(entry.key().c_str()) : String(entry.key().c_str()) + copy;
+      doc[key] = entry.value();
+    }
+  }
+
+  size_t jsonBytes = 0;
+  const int64_t jsonStart = esp_timer_get_time();
+  for (size_t i = 0; i < MSGPACK_BENCH_ITERATIONS; ++i) {
+    String out;
+    serializeJson(doc, out);
+    jsonBytes = out.length();
+  }
+  const int64_t jsonUs = esp_timer_get_time() - jsonStart;
+
+  size_t msgpackBytes = 0;
+  const int64_t msgpackStart = esp_timer_get_time();
+  for (size_t i = 0; i < MSGPACK_BENCH_ITERATIONS; ++i) {
+    std::vector<uint8_t> out(measureMsgPack(doc));
+    serializeMsgPack(doc, out.data(), out.size());
+    msgpackBytes = out.size();
+  }
+  const int64_t msgpackUs = esp_timer_get_time() - msgpackStart;
+
+  Serial.printf("[perf] runtime_msgpack copies=%u json_bytes=%u msgpack_bytes=%u json_us=%lld msgpack_us=%lld\n",
+                static_cast<unsigned>(copies),
+                static_cast<unsigned>(jsonBytes),
+                static_cast<unsigned>(msgpackBytes),
+                static_cast<long long>(jsonUs / static_cast<int64_t>(MSGPACK_BENCH_ITERATIONS)),
+                static_cast<long long>(msgpackUs / static_cast<int64_t>(MSGPACK_BENCH_ITERATIONS)));
+  TEST_ASSERT_TRUE(msgpackBytes < jsonBytes);
+}
+
+void test_perf_runtime_msgpack() {
+  benchRuntimeMsgPack(1);
+  benchRuntimeMsgPack(8);
+  benchRuntimeMsgPack(32);
+}
+
+void test_perf_runtime_group_index() {
+  static const size_t groupCounts[] = {4, 32, 128};
+  static const size_t controlCounts[] = {64, 512};
+  for (size_t groups : groupCounts) {
+    for (size_t controls : controlCounts) {
+      benchRuntimeGroupIndex(groups, controls);
+    }
+  }
+}
+
+} // namespace
+#endif
+
 #ifdef CM_RUNTIME_META_TEST_INSTRUMENTATION
 namespace {
 
@@ -408,6 +2492,52 @@ void test_runtime_meta_serialization_avoids_deep_style_copy() {
   assertRuntimeMetaJson(recoveredJson, RUNTIME_META_FIXTURE_ENTRIES);
 }
 
+
+void test_runtime_meta_incremental_fragments() {
+  ConfigManagerRuntime runtime;
+  ConfigManagerRuntime reference;
+  for (size_t index = 0; index < RUNTIME_META_FIXTURE_ENTRIES; ++index) {
+    runtime.addRuntimeMeta(makeRuntimeMetaFixtureEntry(index));
+  }
+  TEST_ASSERT_NOT_NULL(runtime.runtimeMetaJsonPayload().get());
+  TEST_ASSERT_EQUAL_UINT32(RUNTIME_META_FIXTURE_ENTRIES, runtime.getRuntimeMetaFragmentBuildCountForTest());
+
+  String key("runtime_key_7");
+  while (key.length() < RUNTIME_META_KEY_MAX_LEN) {
+    key += "x";
+  }
+  const auto restyle = [](RuntimeFieldMeta& meta) {
+    meta.style = RuntimeFieldStyle();
+    meta.style.rule("stateDotOnAlarm").set("background", "#f00");
+  };
+  // A style change (what an alarm toggle does) re-serializes only that entry.
+  TEST_ASSERT_TRUE(runtime.updateRuntimeMeta(runtimeMetaText("group", 7), key, restyle));
+  const std::shared_ptr<const String> restyled = runtime.runtimeMetaJsonPayload();
+  TEST_ASSERT_NOT_NULL(restyled.get());
+  TEST_ASSERT_EQUAL_UINT32(RUNTIME_META_FIXTURE_ENTRIES + 1, runtime.getRuntimeMetaFragmentBuildCountForTest());
+  assertRuntimeMetaJson(*restyled, RUNTIME_META_FIXTURE_ENTRIES);
+
+  // Moving an entry changes every ID after it, but not the cached fragments.
+  TEST_ASSERT_TRUE(runtime.updateRuntimeMeta(runtimeMetaText("group", 7), key, [](RuntimeFieldMeta& meta) {
+    meta.group = "";
+  }));
+  const std::shared_ptr<const String> moved = runtime.runtimeMetaJsonPayload();
+  TEST_ASSERT_EQUAL_UINT32(RUNTIME_META_FIXTURE_ENTRIES + 2, runtime.getRuntimeMetaFragmentBuildCountForTest());
+
+  for (size_t index = 0; index < RUNTIME_META_FIXTURE_ENTRIES; ++index) {
+    RuntimeFieldMeta meta = makeRuntimeMetaFixtureEntry(index);
+    if (index == 7) {
+      restyle(meta);
+      meta.group = "";
+    }
+    reference.addRuntimeMeta(meta);
+  }
+  const std::shared_ptr<const String> expected = reference.runtimeMetaJsonPayload();
+  TEST_ASSERT_NOT_NULL(expected.get());
+  TEST_ASSERT_EQUAL_STRING(expected->c_str(), moved->c_str());
+  TEST_ASSERT_EQUAL_INT(0, moved->indexOf(String("[{\"id\":0,\"group\":\"\",\"sourceGroup\"")));
+}
+
 } // namespace
 #endif
 
@@ -433,6 +2563,7 @@ void setup() {
   testManager.addSetting(&featureEnable);
   testManager.addSetting(&hiddenUnlessFeature);
   testManager.addSetting(&autoKey);
+  testManager.addSetting(&constKey);
 
   // Ensure runtime manager is initialized for meta/value JSON generation
   testManager.getRuntime().begin(&testManager);
@@ -454,9 +2585,57 @@ void setup() {
   RUN_TEST(test_key_length_error_flag);
   RUN_TEST(test_showIf_visibility);
   RUN_TEST(test_runtime_string_divider_and_order);
+  RUN_TEST(test_runtime_registry_copy_on_write);
+  RUN_TEST(test_runtime_group_index);
+  RUN_TEST(test_runtime_delta_frames);
+  RUN_TEST(test_runtime_msgpack_frame);
+  RUN_TEST(test_runtime_compact_frames);
+  RUN_TEST(test_runtime_provider_refresh_interval);
+  RUN_TEST(test_runtime_frame_arena);
+  RUN_TEST(test_runtime_frame_shared_target);
+  RUN_TEST(test_runtime_history_buckets);
+  RUN_TEST(test_loop_profiler_histogram);
+  RUN_TEST(test_ws_client_queued_bytes_estimate);
+  RUN_TEST(test_ws_command_queue_coalescing);
+  RUN_TEST(test_spsc_mailbox_two_tasks);
+  RUN_TEST(test_loop_mailbox_applies_on_loop);
+  RUN_TEST(test_http_admission_classes);
+  RUN_TEST(test_webui_cache_validators);
+  RUN_TEST(test_etag_list_matches);
+  RUN_TEST(test_setting_index_lookup);
+  RUN_TEST(test_config_json_stream_categories_and_chunks);
+  RUN_TEST(test_persist_write_behind_coalescing);
+  RUN_TEST(test_settings_blob_roundtrip_and_migration);
+  RUN_TEST(test_setting_from_string_typed);
+  RUN_TEST(test_compile_time_storage_key);
+  RUN_TEST(test_settings_epoch_and_change_subscription);
+  RUN_TEST(test_config_json_delta_since_epoch);
+  RUN_TEST(test_transaction_all_or_nothing);
+  RUN_TEST(test_transaction_io_pins_use_staged_view);
+  RUN_TEST(test_config_descriptor_table);
+
+#ifdef CM_PERF_BENCHMARKS
+  RUN_TEST(test_perf_setting_lookup);
+  RUN_TEST(test_perf_config_json_stream);
+  RUN_TEST(test_perf_boot_load_blob_vs_per_key);
+  RUN_TEST(test_perf_apply_setting_from_string);
+  RUN_TEST(test_perf_loop_update_settings_epoch);
+  RUN_TEST(test_perf_bulk_save_transaction);
+  RUN_TEST(test_perf_settings_ram_descriptor_tables);
+  RUN_TEST(test_perf_runtime_registry_snapshot);
+  RUN_TEST(test_perf_runtime_group_index);
+  RUN_TEST(test_perf_runtime_delta_frames);
+  RUN_TEST(test_perf_runtime_msgpack);
+  RUN_TEST(test_perf_runtime_compact_frames);
+  RUN_TEST(test_perf_runtime_provider_cache);
+  RUN_TEST(test_perf_runtime_frame_soak);
+  RUN_TEST(test_perf_runtime_meta_alarm_rebuild);
+  RUN_TEST(test_perf_ws_command_dispatch);
+#endif
 
 #ifdef CM_RUNTIME_META_TEST_INSTRUMENTATION
   RUN_TEST(test_runtime_meta_serialization_avoids_deep_style_copy);
+  RUN_TEST(test_runtime_meta_incremental_fragments);
 #endif
 
   UNITY_END();
@@ -1,6 +1,7 @@
 const fs = require('fs');
 const path = require('path');
 const zlib = require('zlib');
+const crypto = require('crypto');
 
 // This script lives in tools/, so derive project root one level up
 const rootDir = path.join(__dirname, '..');
@@ -96,13 +97,17 @@ async function buildHeader() {
   }
 
   const gzArray = toCArray(gz);
+  // Content hash of the exact bytes served: ETag of / and webuiHash in /appinfo.
+  // gzipSync writes no timestamp, so an unchanged UI keeps its hash across builds.
+  const gzHash = crypto.createHash('sha256').update(gz).digest('hex').slice(0, 16);
 
   // make the Header (gzipped content)
   let header = `#pragma once\n#include <pgmspace.h>\n\n`;
   header += `// Gzipped embedded Web UI (index.html with inlined CSS/JS)\n`;
   header += `const uint8_t WEB_HTML_GZ[] PROGMEM = {\n    ${gzArray}\n};\n`;
   header += `const size_t WEB_HTML_GZ_LEN = ${gz.length};\n`;
-  header += `\nclass WebHTML {\npublic:\n    const uint8_t* getWebHTMLGz();\n    size_t getWebHTMLGzLen();\n};\n`;
+  header += `const char WEB_HTML_GZ_HASH[] = "${gzHash}";\n`;
+  header += `\nclass WebHTML {\npublic:\n    const uint8_t* getWebHTMLGz();\n    size_t getWebHTMLGzLen();\n    const char* getWebHTMLGzHash();\n};\n`;
 
   fs.writeFileSync(outFile, header);
   console.log('Header generated:', outFile);
@@ -0,0 +1,74 @@
+export const ADMISSION_RETRY_LIMIT = 3;
+export const ADMISSION_RETRY_DEFAULT_SEC = 2;
+
+function defaultSleep(ms) {
+  return new Promise((resolve) => setTimeout(resolve, ms));
+}
+
+export function retryAfterMs(response, fallbackSec = ADMISSION_RETRY_DEFAULT_SEC) {
+  const header = response?.headers?.get?.("Retry-After");
+  const seconds = parseInt(header || "", 10);
+  return (Number.isFinite(seconds) && seconds >= 0 ? seconds : fallbackSec) * 1000;
+}
+
+// A 503 means the device refused the request before acting on it (admission control
+// or a full loop mailbox), so sending it again after Retry-After is safe.
+export async function fetchWithAdmissionRetry(send, {
+  limit = ADMISSION_RETRY_LIMIT,
+  sleep = defaultSleep,
+} = {}) {
+  let response = await send();
+  for (let attempt = 0; attempt < limit && response?.status === 503; attempt++) {
+    await sleep(retryAfterMs(response));
+    response = await send();
+  }
+  return response;
+}
+
+// Keeps at most one pending retry of a background reload and gives up after `limit`
+// consecutive 503 answers. schedule() returns false when the caller should report the error.
+export function createAdmissionRetryTimer({
+  limit = ADMISSION_RETRY_LIMIT,
+  setTimer = setTimeout,
+  clearTimer = clearTimeout,
+} = {}) {
+  let timer = null;
+  let attempts = 0;
+
+  function clearPending() {
+    if (timer !== null) {
+      clearTimer(timer);
+      timer = null;
+    }
+  }
+
+  function schedule(callback, response) {
+    if (timer !== null) return true;
+    if (attempts >= limit) {
+      // Give up; the next call starts a fresh series.
+      attempts = 0;
+      return false;
+    }
+    attempts++;
+    timer = setTimer(() => {
+      timer = null;
+      callback();
+    }, retryAfterMs(response));
+    return true;
+  }
+
+  function succeeded() {
+    attempts = 0;
+    clearPending();
+  }
+
+  function cancel() {
+    clearPending();
+  }
+
+  function state() {
+    return { attempts, scheduled: timer !== null };
+  }
+
+  return { schedule, succeeded, cancel, state };
+}
@@ -0,0 +1,27 @@
+// Helpers for revisioned /config.json fetches.
+// The device answers `/config.json?since=<rev>` with only the settings that changed
+// after `rev` (marked by the `X-Config-Delta` header), in the same shape as the full
+// document, so applying a delta is a deep merge of plain objects.
+
+function isPlainObject(value) {
+  return value !== null && typeof value === "object" && !Array.isArray(value);
+}
+
+export function mergeConfigDelta(base, delta) {
+  if (!isPlainObject(base) || !isPlainObject(delta)) {
+    return delta;
+  }
+  const merged = { ...base };
+  for (const [key, value] of Object.entries(delta)) {
+    merged[key] = isPlainObject(value) && isPlainObject(base[key])
+      ? mergeConfigDelta(base[key], value)
+      : value;
+  }
+  return merged;
+}
+
+export function configRequestUrl(revision, hasConfig) {
+  return revision && hasConfig
+    ? `/config.json?since=${encodeURIComponent(revision)}`
+    : "/config.json";
+}
@@ -0,0 +1,94 @@
+// Minimal MessagePack decoder for binary runtime frames (`/ws` after a
+// `{ type: "hello", format: "msgpack" }` hello, and `/runtime.msgpack`).
+// Covers everything ArduinoJson's serializeMsgPack() emits; ext types are rejected.
+
+const textDecoder = new TextDecoder();
+
+export function decodeMsgPack(input) {
+  const bytes = input instanceof Uint8Array ? input : new Uint8Array(input);
+  const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+  let pos = 0;
+
+  function need(count) {
+    if (pos + count > bytes.length) {
+      throw new RangeError("Truncated MessagePack data");
+    }
+  }
+  function str(len) {
+    need(len);
+    const value = textDecoder.decode(bytes.subarray(pos, pos + len));
+    pos += len;
+    return value;
+  }
+  function bin(len) {
+    need(len);
+    const value = bytes.slice(pos, pos + len);
+    pos += len;
+    return value;
+  }
+  function array(len) {
+    const out = new Array(len);
+    for (let i = 0; i < len; i++) {
+      out[i] = read();
+    }
+    return out;
+  }
+  function map(len) {
+    const out = {};
+    for (let i = 0; i < len; i++) {
+      const key = read();
+      out[key] = read();
+    }
+    return out;
+  }
+  function fixed(size, getter) {
+    need(size);
+    const value = getter(pos);
+    pos += size;
+    return value;
+  }
+
+  function read() {
+    need(1);
+    const type = bytes[pos++];
+    if (type <= 0x7f) return type;
+    if (type >= 0xe0) return type - 0x100;
+    if ((type & 0xf0) === 0x80) return map(type & 0x0f);
+    if ((type & 0xf0) === 0x90) return array(type & 0x0f);
+    if ((type & 0xe0) === 0xa0) return str(type & 0x1f);
+    switch (type) {
+      case 0xc0: return null;
+      case 0xc2: return false;
+      case 0xc3: return true;
+      case 0xc4: return bin(fixed(1, (p) => view.getUint8(p)));
+      case 0xc5: return bin(fixed(2, (p) => view.getUint16(p)));
+      case 0xc6: return bin(fixed(4, (p) => view.getUint32(p)));
+      // Round float32 to the 7 significant digits it carries (21.7, not 21.700000762939453).
+      case 0xca: return fixed(4, (p) => Number(view.getFloat32(p).toPrecision(7)));
+      case 0xcb: return fixed(8, (p) => view.getFloat64(p));
+      case 0xcc: return fixed(1, (p) => view.getUint8(p));
+      case 0xcd: return fixed(2, (p) => view.getUint16(p));
+      case 0xce: return fixed(4, (p) => view.getUint32(p));
+      case 0xcf: return fixed(8, (p) => Number(view.getBigUint64(p)));
+      case 0xd0: return fixed(1, (p) => view.getInt8(p));
+      case 0xd1: return fixed(2, (p) => view.getInt16(p));
+      case 0xd2: return fixed(4, (p) => view.getInt32(p));
+      case 0xd3: return fixed(8, (p) => Number(view.getBigInt64(p)));
+      case 0xd9: return str(fixed(1, (p) => view.getUint8(p)));
+      case 0xda: return str(fixed(2, (p) => view.getUint16(p)));
+      case 0xdb: return str(fixed(4, (p) => view.getUint32(p)));
+      case 0xdc: return array(fixed(2, (p) => view.getUint16(p)));
+      case 0xdd: return array(fixed(4, (p) => view.getUint32(p)));
+      case 0xde: return map(fixed(2, (p) => view.getUint16(p)));
+      case 0xdf: return map(fixed(4, (p) => view.getUint32(p)));
+      default:
+        throw new TypeError(`Unsupported MessagePack type 0x${type.toString(16)}`);
+    }
+  }
+
+  const value = read();
+  if (pos !== bytes.length) {
+    throw new RangeError("Trailing bytes after MessagePack value");
+  }
+  return value;
+}
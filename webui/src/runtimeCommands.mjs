@@ -0,0 +1,108 @@
+// Runtime actions over the /ws socket instead of one HTTP POST each.
+// Wire format: [seq,"kind",group,key(,value)]; the firmware answers
+// {"type":"ack","seq":N,"ok":true|false[,"error":"..."]}. It dispatches only the
+// latest pending value per control, so an ack also settles the earlier values
+// sent for the same control.
+
+export const RUNTIME_COMMAND_TIMEOUT_MS = 3000;
+
+// kind -> [wire code, /runtime_action/<route>]
+const KINDS = {
+  button: ["b", "button"],
+  checkbox: ["cb", "checkbox"],
+  stateButton: ["sb", "state_button"],
+  intSlider: ["is", "int_slider"],
+  floatSlider: ["fs", "float_slider"],
+  intInput: ["ii", "int_input"],
+  floatInput: ["fi", "float_input"],
+};
+
+export function runtimeActionRoute(kind) {
+  return KINDS[kind] ? `/runtime_action/${KINDS[kind][1]}` : null;
+}
+
+export function encodeRuntimeCommand(seq, kind, group, key, value) {
+  const entry = KINDS[kind];
+  if (!entry) return null;
+  const command = [seq, entry[0], String(group), String(key)];
+  if (value !== undefined && value !== null) command.push(value);
+  return JSON.stringify(command);
+}
+
+// Values replace each other on the device; button presses and toggles do not.
+function coalesces(kind, value) {
+  return kind !== "button" && value !== undefined && value !== null;
+}
+
+export function createRuntimeCommandChannel({
+  send,
+  timeoutMs = RUNTIME_COMMAND_TIMEOUT_MS,
+  setTimer = setTimeout,
+  clearTimer = clearTimeout,
+  now = () => Date.now(),
+}) {
+  let nextSeq = 1;
+  const pending = new Map(); // seq -> { control, resolve, timer, sentAt }
+
+  function settle(seq, result) {
+    const entry = pending.get(seq);
+    if (!entry) return;
+    pending.delete(seq);
+    clearTimer(entry.timer);
+    entry.resolve({ ...result, latencyMs: now() - entry.sentAt });
+  }
+
+  // Resolves { ok, error?, superseded?, latencyMs }; error "unsent" means the
+  // socket refused the message and the action was not delivered.
+  function sendCommand(kind, group, key, value) {
+    const seq = nextSeq++;
+    const message = encodeRuntimeCommand(seq, kind, group, key, value);
+    if (!message) return Promise.resolve({ ok: false, error: "invalid", latencyMs: 0 });
+    return new Promise((resolve) => {
+      const control = coalesces(kind, value) ? `${kind}\u0000${group}\u0000${key}` : null;
+      const entry = { control, resolve, timer: null, sentAt: now() };
+      pending.set(seq, entry);
+      try {
+        send(message);
+      } catch (e) {
+        pending.delete(seq);
+        resolve({ ok: false, error: "unsent", latencyMs: 0 });
+        return;
+      }
+      entry.timer = setTimer(() => settle(seq, { ok: false, error: "timeout" }), timeoutMs);
+    });
+  }
+
+  // Returns true when msg was an ack (handled or stale).
+  function handleAck(msg) {
+    if (!msg || msg.type !== "ack" || typeof msg.seq !== "number") return false;
+    const entry = pending.get(msg.seq);
+    if (!entry) return true;
+    const result = msg.ok ? { ok: true } : { ok: false, error: msg.error || "failed" };
+    if (entry.control) {
+      for (const [seq, other] of pending) {
+        if (seq < msg.seq && other.control === entry.control) {
+          settle(seq, { ...result, superseded: true });
+        }
+      }
+    }
+    settle(msg.seq, result);
+    return true;
+  }
+
+  // Socket closed: whatever was not acknowledged may or may not have run.
+  function reset() {
+    for (const seq of [...pending.keys()]) {
+      settle(seq, { ok: false, error: "closed" });
+    }
+  }
+
+  return {
+    send: sendCommand,
+    handleAck,
+    reset,
+    get pendingCount() {
+      return pending.size;
+    },
+  };
+}
@@ -0,0 +1,60 @@
+// Compact runtime frames: fields listed in /runtime_meta.json are sent by numeric ID.
+// Every meta entry carries an `id` (its position in the array). A compact frame holds
+// `f`, a flat [id, value, id, value, ...] array, and `x`, the remaining fields keyed as
+// in /runtime.json. `ids` is an FNV-1a hash of the (source group, key) list in ID order,
+// so a client can tell whether its metadata matches the device's.
+
+const encoder = new TextEncoder();
+
+function fnv1a(hash, text) {
+  for (const byte of encoder.encode(text)) {
+    hash = Math.imul(hash ^ byte, 16777619) >>> 0;
+  }
+  return hash;
+}
+
+function sourceGroupOf(meta) {
+  return meta.sourceGroup || meta.group || "";
+}
+
+export function createFieldIdMap(meta) {
+  const entries = Array.isArray(meta) ? meta : [];
+  let hash = 2166136261;
+  const fields = entries.map((m) => {
+    const group = sourceGroupOf(m);
+    hash = fnv1a(hash, `${group}\x1f${m.key}\x1e`);
+    return [group, m.key];
+  });
+  return { hash, fields };
+}
+
+export function isCompactFrame(frame) {
+  return frame !== null && typeof frame === "object" && Array.isArray(frame.f);
+}
+
+// Returns the frame with `f`/`x` expanded back to keyed values, or null when the
+// frame was built from different metadata than `idMap`.
+export function expandCompactFrame(frame, idMap) {
+  if (!idMap || frame.ids !== idMap.hash) {
+    return null;
+  }
+  const values = {};
+  for (const [key, value] of Object.entries(frame.x || {})) {
+    values[key] = value !== null && typeof value === "object" && !Array.isArray(value) ? { ...value } : value;
+  }
+  for (let i = 0; i + 1 < frame.f.length; i += 2) {
+    const field = idMap.fields[frame.f[i]];
+    if (!field) {
+      return null;
+    }
+    const [group, key] = field;
+    if (!values[group] || typeof values[group] !== "object") {
+      values[group] = {};
+    }
+    values[group][key] = frame.f[i + 1];
+  }
+  if (frame.type === "runtimeDelta") {
+    return { type: "runtimeDelta", seq: frame.seq, values };
+  }
+  return values;
+}
@@ -0,0 +1,43 @@
+// Helpers for delta-encoded WebSocket runtime frames.
+// With delta push enabled the device sends the full runtime object as a keyframe and
+// then `{ type: "runtimeDelta", seq, values }` frames that only carry changed fields.
+// `values` has the /runtime.json shape (group -> key -> value, plus top-level scalars);
+// `seq` restarts at 1 after every keyframe, so a gap means a frame was missed.
+
+function isPlainObject(value) {
+  return value !== null && typeof value === "object" && !Array.isArray(value);
+}
+
+export function isRuntimeDeltaFrame(frame) {
+  return isPlainObject(frame) && frame.type === "runtimeDelta" && isPlainObject(frame.values);
+}
+
+// Field values below a group are replaced as a whole, matching the device's comparison.
+export function mergeRuntimeDelta(base, values) {
+  const merged = isPlainObject(base) ? { ...base } : {};
+  for (const [key, value] of Object.entries(values)) {
+    merged[key] = isPlainObject(value) && isPlainObject(merged[key])
+      ? { ...merged[key], ...value }
+      : value;
+  }
+  return merged;
+}
+
+export function createRuntimeFrameTracker() {
+  let expectedSeq = null;
+  return {
+    reset() {
+      expectedSeq = null;
+    },
+    // Returns the new runtime object and whether the client fell out of sync.
+    apply(runtime, frame) {
+      if (!isRuntimeDeltaFrame(frame)) {
+        expectedSeq = 1;
+        return { runtime: frame, resync: false };
+      }
+      const resync = expectedSeq !== frame.seq;
+      expectedSeq = frame.seq + 1;
+      return { runtime: mergeRuntimeDelta(runtime, frame.values), resync };
+    },
+  };
+}
@@ -0,0 +1,114 @@
+import assert from "node:assert/strict";
+import test from "node:test";
+
+import {
+  createAdmissionRetryTimer,
+  fetchWithAdmissionRetry,
+  retryAfterMs,
+} from "../src/admissionRetry.mjs";
+
+function response(status, retryAfter) {
+  return {
+    status,
+    ok: status >= 200 && status < 300,
+    headers: { get: (name) => (name === "Retry-After" ? retryAfter ?? null : null) },
+  };
+}
+
+function createFakeTimers() {
+  let nextId = 1;
+  const callbacks = new Map();
+  const delays = [];
+  return {
+    delays,
+    setTimer(callback, ms) {
+      const id = nextId++;
+      callbacks.set(id, callback);
+      delays.push(ms);
+      return id;
+    },
+    clearTimer(id) {
+      callbacks.delete(id);
+    },
+    get count() {
+      return callbacks.size;
+    },
+    runOne() {
+      const [id, callback] = callbacks.entries().next().value;
+      callbacks.delete(id);
+      callback();
+    },
+  };
+}
+
+test("uses Retry-After and falls back to two seconds", () => {
+  assert.equal(retryAfterMs(response(503, "5")), 5000);
+  assert.equal(retryAfterMs(response(503)), 2000);
+  assert.equal(retryAfterMs(response(503, "soon")), 2000);
+});
+
+test("resends a refused request until it is admitted", async () => {
+  const answers = [response(503, "1"), response(503), response(200)];
+  const sleeps = [];
+  let sent = 0;
+  const r = await fetchWithAdmissionRetry(async () => answers[sent++], {
+    sleep: async (ms) => sleeps.push(ms),
+  });
+  assert.equal(r.status, 200);
+  assert.equal(sent, 3);
+  assert.deepEqual(sleeps, [1000, 2000]);
+});
+
+test("returns the last 503 once the limit is reached", async () => {
+  let sent = 0;
+  const r = await fetchWithAdmissionRetry(async () => {
+    sent++;
+    return response(503);
+  }, { limit: 2, sleep: async () => {} });
+  assert.equal(r.status, 503);
+  assert.equal(sent, 3);
+});
+
+test("does not resend other errors", async () => {
+  let sent = 0;
+  const r = await fetchWithAdmissionRetry(async () => {
+    sent++;
+    return response(400);
+  }, { sleep: async () => {} });
+  assert.equal(r.status, 400);
+  assert.equal(sent, 1);
+});
+
+test("keeps a single pending reload timer", () => {
+  const timers = createFakeTimers();
+  const retry = createAdmissionRetryTimer({ limit: 3, ...timers });
+  let reloads = 0;
+  const reload = () => reloads++;
+
+  assert.equal(retry.schedule(reload, response(503, "4")), true);
+  assert.equal(retry.schedule(reload, response(503, "4")), true);
+  assert.equal(timers.count, 1);
+  assert.deepEqual(timers.delays, [4000]);
+
+  timers.runOne();
+  assert.equal(reloads, 1);
+  assert.deepEqual(retry.state(), { attempts: 1, scheduled: false });
+});
+
+test("gives up after the limit and starts over after a success", () => {
+  const timers = createFakeTimers();
+  const retry = createAdmissionRetryTimer({ limit: 2, ...timers });
+  const reload = () => {};
+
+  assert.equal(retry.schedule(reload, response(503)), true);
+  timers.runOne();
+  assert.equal(retry.schedule(reload, response(503)), true);
+  timers.runOne();
+  assert.equal(retry.schedule(reload, response(503)), false);
+  assert.equal(timers.count, 0);
+
+  assert.equal(retry.schedule(reload, response(503)), true);
+  retry.succeeded();
+  assert.equal(timers.count, 0);
+  assert.deepEqual(retry.state(), { attempts: 0, scheduled: false });
+});
@@ -0,0 +1,52 @@
+import assert from "node:assert/strict";
+import test from "node:test";
+
+import { configRequestUrl, mergeConfigDelta } from "../src/configDelta.mjs";
+
+test("merges changed settings into their category and card", () => {
+  const base = {
+    wifi: {
+      categoryPretty: "WiFi",
+      ssid: { value: "home", displayName: "SSID" },
+      dhcp: { value: true },
+      cards: { net: { cardOrder: 1, settings: { ip: { value: "1.2.3.4" }, gw: { value: "1.2.3.1" } } } },
+    },
+    mqtt: { categoryPretty: "MQTT", port: { value: 1883 } },
+  };
+  const delta = {
+    wifi: {
+      categoryPretty: "WiFi",
+      ssid: { value: "office", displayName: "SSID" },
+      cards: { net: { cardOrder: 1, settings: { ip: { value: "5.6.7.8" } } } },
+    },
+  };
+
+  const merged = mergeConfigDelta(base, delta);
+
+  assert.equal(merged.wifi.ssid.value, "office");
+  assert.equal(merged.wifi.dhcp.value, true);
+  assert.equal(merged.wifi.cards.net.settings.ip.value, "5.6.7.8");
+  assert.equal(merged.wifi.cards.net.settings.gw.value, "1.2.3.1");
+  assert.equal(merged.mqtt, base.mqtt);
+  assert.equal(base.wifi.ssid.value, "home", "base must not be mutated");
+});
+
+test("replaces arrays and scalars instead of merging them", () => {
+  const merged = mergeConfigDelta(
+    { c: { sel: { value: "a", options: ["a", "b", "c"] } } },
+    { c: { sel: { value: "b", options: ["a", "b"] } } },
+  );
+  assert.deepEqual(merged.c.sel.options, ["a", "b"]);
+  assert.equal(merged.c.sel.value, "b");
+});
+
+test("an empty delta leaves the document unchanged", () => {
+  const base = { c: { k: { value: 1 } } };
+  assert.deepEqual(mergeConfigDelta(base, {}), base);
+});
+
+test("requests a delta only when a revision and a loaded config exist", () => {
+  assert.equal(configRequestUrl("", true), "/config.json");
+  assert.equal(configRequestUrl("0badf00d-00000010", false), "/config.json");
+  assert.equal(configRequestUrl("0badf00d-00000010", true), "/config.json?since=0badf00d-00000010");
+});
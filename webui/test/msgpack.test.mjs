@@ -0,0 +1,50 @@
+import assert from "node:assert/strict";
+import test from "node:test";
+
+import { decodeMsgPack } from "../src/msgpack.mjs";
+
+test("decodes a runtime frame as ArduinoJson encodes it", () => {
+  // {"uptime":70000,"sensors":{"temp":21.7,"ok":true},"alarms":{}}
+  const frame = Uint8Array.from([
+    0x83,
+    0xa6, ...Buffer.from("uptime"), 0xce, 0x00, 0x01, 0x11, 0x70,
+    0xa7, ...Buffer.from("sensors"), 0x82,
+    0xa4, ...Buffer.from("temp"), 0xca, 0x41, 0xad, 0x99, 0x9a,
+    0xa2, ...Buffer.from("ok"), 0xc3,
+    0xa6, ...Buffer.from("alarms"), 0x80,
+  ]);
+
+  assert.deepEqual(decodeMsgPack(frame), {
+    uptime: 70000,
+    sensors: { temp: 21.7, ok: true },
+    alarms: {},
+  });
+});
+
+test("decodes integers, floats, nil and strings of every width", () => {
+  assert.equal(decodeMsgPack([0x7f]), 127);
+  assert.equal(decodeMsgPack([0xff]), -1);
+  assert.equal(decodeMsgPack([0xd0, 0x80]), -128);
+  assert.equal(decodeMsgPack([0xcd, 0x12, 0x34]), 0x1234);
+  assert.equal(decodeMsgPack([0xd1, 0xff, 0x38]), -200);
+  assert.equal(decodeMsgPack([0xd2, 0xff, 0xff, 0xff, 0x9c]), -100);
+  assert.equal(decodeMsgPack([0xcf, 0, 0, 0, 1, 0, 0, 0, 0]), 2 ** 32);
+  assert.equal(decodeMsgPack([0xcb, 0x40, 0x09, 0x21, 0xfb, 0x54, 0x44, 0x2d, 0x18]), Math.PI);
+  assert.equal(decodeMsgPack([0xc0]), null);
+  assert.equal(decodeMsgPack([0xc2]), false);
+  assert.equal(decodeMsgPack([0xd9, 0x03, ...Buffer.from("abc")]), "abc");
+  assert.equal(decodeMsgPack([0xa5, ...Buffer.from("grü"), 0x6e]), "grün");
+  assert.deepEqual(decodeMsgPack([0x92, 0x01, 0xa1, 0x78]), [1, "x"]);
+  assert.deepEqual(decodeMsgPack([0xc4, 0x02, 0xde, 0xad]), Uint8Array.from([0xde, 0xad]));
+});
+
+test("accepts an ArrayBuffer as delivered by WebSocket binary frames", () => {
+  const buffer = Uint8Array.from([0x81, 0xa1, 0x61, 0x01]).buffer;
+  assert.deepEqual(decodeMsgPack(buffer), { a: 1 });
+});
+
+test("rejects truncated data, trailing bytes and ext types", () => {
+  assert.throws(() => decodeMsgPack([0x82, 0xa1, 0x61, 0x01]), RangeError);
+  assert.throws(() => decodeMsgPack([0x01, 0x02]), RangeError);
+  assert.throws(() => decodeMsgPack([0xd4, 0x01, 0x00]), TypeError);
+});
@@ -0,0 +1,78 @@
+import assert from "node:assert/strict";
+import test from "node:test";
+
+import { createRuntimeCommandChannel, encodeRuntimeCommand, runtimeActionRoute } from "../src/runtimeCommands.mjs";
+
+function createChannel() {
+  const sent = [];
+  const timers = new Map();
+  let nextTimer = 1;
+  let clock = 0;
+  const channel = createRuntimeCommandChannel({
+    send: (message) => sent.push(JSON.parse(message)),
+    setTimer(callback) {
+      const id = nextTimer++;
+      timers.set(id, callback);
+      return id;
+    },
+    clearTimer(id) {
+      timers.delete(id);
+    },
+    now: () => clock,
+  });
+  return {
+    channel,
+    sent,
+    timers,
+    advance(ms) {
+      clock += ms;
+    },
+  };
+}
+
+test("encodes compact commands", () => {
+  assert.equal(encodeRuntimeCommand(3, "intSlider", "pump", "speed", 40), '[3,"is","pump","speed",40]');
+  assert.equal(encodeRuntimeCommand(4, "button", "pump", "prime"), '[4,"b","pump","prime"]');
+  assert.equal(encodeRuntimeCommand(5, "stateButton", "pump", "on", false), '[5,"sb","pump","on",false]');
+  assert.equal(encodeRuntimeCommand(6, "nope", "pump", "on"), null);
+  assert.equal(runtimeActionRoute("floatInput"), "/runtime_action/float_input");
+});
+
+test("an ack settles the command and earlier values for the same control", async () => {
+  const { channel, sent, timers, advance } = createChannel();
+  const first = channel.send("intSlider", "pump", "speed", 10);
+  const press = channel.send("button", "pump", "prime");
+  const other = channel.send("intSlider", "pump", "limit", 5);
+  const latest = channel.send("intSlider", "pump", "speed", 30);
+  assert.deepEqual(sent.map((c) => c[0]), [1, 2, 3, 4]);
+
+  advance(12);
+  assert.equal(channel.handleAck({ type: "ack", seq: 4, ok: true }), true);
+  assert.deepEqual(await latest, { ok: true, latencyMs: 12 });
+  assert.deepEqual(await first, { ok: true, superseded: true, latencyMs: 12 });
+  assert.equal(channel.pendingCount, 2); // The press and the other slider still wait
+  assert.equal(timers.size, 2);
+
+  channel.handleAck({ type: "ack", seq: 2, ok: false, error: "invalid" });
+  assert.deepEqual(await press, { ok: false, error: "invalid", latencyMs: 12 });
+  channel.reset();
+  assert.equal((await other).error, "closed");
+  assert.equal(channel.pendingCount, 0);
+});
+
+test("times out, ignores other messages and reports unsent commands", async () => {
+  const { channel, timers } = createChannel();
+  const pending = channel.send("checkbox", "pump", "auto", true);
+  assert.equal(channel.handleAck({ type: "runtimeDelta" }), false);
+  assert.equal(channel.handleAck({ type: "ack", seq: 99, ok: true }), true);
+  [...timers.values()][0]();
+  assert.equal((await pending).error, "timeout");
+
+  const failing = createRuntimeCommandChannel({
+    send() {
+      throw new Error("socket closed");
+    },
+  });
+  assert.equal((await failing.send("button", "pump", "prime")).error, "unsent");
+  assert.equal(failing.pendingCount, 0);
+});
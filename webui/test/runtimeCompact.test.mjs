@@ -0,0 +1,53 @@
+import assert from "node:assert/strict";
+import test from "node:test";
+
+import { createFieldIdMap, expandCompactFrame, isCompactFrame } from "../src/runtimeCompact.mjs";
+
+const meta = [
+  { id: 0, group: "Climate", sourceGroup: "sensors", key: "temp" },
+  { id: 1, group: "sensors", sourceGroup: "sensors", key: "hum" },
+  { id: 2, group: "relays", key: "pump" },
+];
+
+test("hashes the (source group, key) list like the device", () => {
+  // FNV-1a 32 of "sensors\x1ftemp\x1esensors\x1fhum\x1erelays\x1fpump\x1e"
+  assert.equal(createFieldIdMap(meta).hash, 0x9f000086);
+  assert.equal(createFieldIdMap([]).hash, 2166136261);
+  assert.notEqual(createFieldIdMap(meta.slice(0, 2)).hash, createFieldIdMap(meta).hash);
+});
+
+test("expands a compact keyframe into the /runtime.json shape", () => {
+  const idMap = createFieldIdMap(meta);
+  const frame = {
+    type: "runtimeCompact",
+    ids: idMap.hash,
+    f: [0, 21.5, 1, 40, 2, true],
+    x: { uptime: 1234, sensors: { extra: "n/a" }, alarms: { hot: false } },
+  };
+
+  assert.equal(isCompactFrame(frame), true);
+  assert.deepEqual(expandCompactFrame(frame, idMap), {
+    uptime: 1234,
+    sensors: { extra: "n/a", temp: 21.5, hum: 40 },
+    relays: { pump: true },
+    alarms: { hot: false },
+  });
+});
+
+test("expands a compact delta into a regular delta frame", () => {
+  const idMap = createFieldIdMap(meta);
+  const frame = { type: "runtimeDelta", seq: 4, ids: idMap.hash, f: [1, 41], x: { uptime: 2000 } };
+  assert.deepEqual(expandCompactFrame(frame, idMap), {
+    type: "runtimeDelta",
+    seq: 4,
+    values: { uptime: 2000, sensors: { hum: 41 } },
+  });
+});
+
+test("refuses frames built from other metadata", () => {
+  const idMap = createFieldIdMap(meta);
+  assert.equal(expandCompactFrame({ ids: 1, f: [], x: {} }, idMap), null);
+  assert.equal(expandCompactFrame({ ids: idMap.hash, f: [9, 1], x: {} }, idMap), null);
+  assert.equal(expandCompactFrame({ ids: idMap.hash, f: [], x: {} }, null), null);
+  assert.equal(isCompactFrame({ uptime: 1 }), false);
+});
@@ -0,0 +1,66 @@
+import assert from "node:assert/strict";
+import test from "node:test";
+
+import { createRuntimeFrameTracker, isRuntimeDeltaFrame, mergeRuntimeDelta } from "../src/runtimeDelta.mjs";
+
+test("merges changed fields into their group", () => {
+  const base = {
+    uptime: 1000,
+    sensors: { temp: 21.5, hum: 40, range: { min: 0, max: 50 } },
+    relays: { pump: true },
+  };
+
+  const merged = mergeRuntimeDelta(base, { uptime: 2000, sensors: { temp: 22, range: { min: 5 } } });
+
+  assert.equal(merged.uptime, 2000);
+  assert.equal(merged.sensors.temp, 22);
+  assert.equal(merged.sensors.hum, 40);
+  assert.deepEqual(merged.sensors.range, { min: 5 }, "nested values are replaced, not merged");
+  assert.equal(merged.relays, base.relays);
+  assert.equal(base.sensors.temp, 21.5, "base must not be mutated");
+});
+
+test("adds groups that were not in the previous frame", () => {
+  const merged = mergeRuntimeDelta({ uptime: 1 }, { alarms: { overheat: true } });
+  assert.deepEqual(merged.alarms, { overheat: true });
+});
+
+test("recognizes delta frames only", () => {
+  assert.equal(isRuntimeDeltaFrame({ type: "runtimeDelta", seq: 1, values: {} }), true);
+  assert.equal(isRuntimeDeltaFrame({ uptime: 1, sensors: {} }), false);
+  assert.equal(isRuntimeDeltaFrame({ type: "log", values: {} }), false);
+});
+
+test("keyframes replace the state and restart the sequence", () => {
+  const tracker = createRuntimeFrameTracker();
+  const key = { uptime: 1, sensors: { temp: 20 } };
+
+  let result = tracker.apply({ stale: true }, key);
+  assert.equal(result.runtime, key);
+  assert.equal(result.resync, false);
+
+  result = tracker.apply(result.runtime, { type: "runtimeDelta", seq: 1, values: { sensors: { temp: 21 } } });
+  assert.equal(result.resync, false);
+  assert.equal(result.runtime.sensors.temp, 21);
+
+  result = tracker.apply(result.runtime, { type: "runtimeDelta", seq: 2, values: { uptime: 3 } });
+  assert.equal(result.resync, false);
+  assert.equal(result.runtime.uptime, 3);
+});
+
+test("flags a sequence gap or a delta before any keyframe", () => {
+  const tracker = createRuntimeFrameTracker();
+  let result = tracker.apply({}, { type: "runtimeDelta", seq: 4, values: { uptime: 9 } });
+  assert.equal(result.resync, true, "no keyframe seen yet");
+
+  result = tracker.apply(result.runtime, { type: "runtimeDelta", seq: 5, values: { uptime: 10 } });
+  assert.equal(result.resync, false);
+
+  result = tracker.apply(result.runtime, { type: "runtimeDelta", seq: 7, values: { uptime: 12 } });
+  assert.equal(result.resync, true, "frame 6 was missed");
+  assert.equal(result.runtime.uptime, 12, "the delta is still applied");
+
+  tracker.reset();
+  result = tracker.apply(result.runtime, { type: "runtimeDelta", seq: 8, values: {} });
+  assert.equal(result.resync, true);
+});